@@ -0,0 +1,98 @@
+// Collision query microbenchmark: CollisionGrid box/probe/sweep queries per
+// second over long generated levels, next to the old unordered_set gap probe.
+//
+//   collision_bench [columns] [queries]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Collision.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    // Same shape as Level0-brick.dat: long solid runs broken by short gaps
+    std::string makeLayout(std::size_t columns, std::mt19937& rng) {
+        std::string layout(columns, '1');
+        std::uniform_int_distribution<int> run(20, 60), gap(1, 5);
+        std::size_t c = static_cast<std::size_t>(run(rng));
+        while (c < columns) {
+            int width = gap(rng);
+            for (int i = 0; i < width && c < columns; i++, c++) layout[c] = '0';
+            c += static_cast<std::size_t>(run(rng));
+        }
+        return layout;
+    }
+
+    template <typename Query>
+    void report(const char* name, std::size_t queries, Query&& query) {
+        std::size_t hits = 0;
+        auto start = BenchClock::now();
+        for (std::size_t i = 0; i < queries; i++) hits += query(i) ? 1 : 0;
+        double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+        std::printf("  %-22s %10.2f M queries/s   (%zu hits)\n", name, queries / seconds / 1e6, hits);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t columns = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000000;
+
+    std::mt19937 rng(1234);
+    std::string layout = makeLayout(columns, rng);
+    float levelWidth = 50.f * columns;
+
+    auto buildStart = BenchClock::now();
+    CollisionGrid grid(static_cast<unsigned int>(columns), 10, sf::Vector2f(0.f, 550.f), sf::Vector2f(50.f, 50.f));
+    for (std::size_t c = 0; c < columns; c++) {
+        if (layout[c] == '1') {
+            for (int h = 0; h < 10; h++) grid.setSolid(static_cast<int>(c), h, true);
+        }
+    }
+    double gridBuild = std::chrono::duration<double, std::milli>(BenchClock::now() - buildStart).count();
+
+    // The previous representation: every integer x inside each gap column
+    buildStart = BenchClock::now();
+    std::unordered_set<int> empty;
+    for (std::size_t c = 0; c < columns; c++) {
+        if (layout[c] == '0') {
+            // Integer counter: the engine's old float loop stalls past x = 2^24
+            int rad = 50 * static_cast<int>(c);
+            for (int i = rad; i <= rad + 50; i++) empty.insert(i);
+        }
+    }
+    double setBuild = std::chrono::duration<double, std::milli>(BenchClock::now() - buildStart).count();
+
+    // Pre-generate query boxes so the RNG stays out of the timed loops
+    std::uniform_real_distribution<float> xDist(0.f, levelWidth - 100.f), yDist(300.f, 600.f), dDist(-40.f, 40.f);
+    std::vector<sf::FloatRect> boxes(4096);
+    std::vector<sf::Vector2f> deltas(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+        boxes[i] = sf::FloatRect(xDist(rng), yDist(rng), 75.f, 75.f);
+        deltas[i] = sf::Vector2f(dDist(rng), dDist(rng));
+    }
+    const std::size_t mask = boxes.size() - 1;
+
+    std::printf("collision_bench: %zu columns (%.0f screens), %zu queries\n", columns, levelWidth / 1600.f, queries);
+    std::printf("  build: grid %.2f ms (%zu KiB), gap set %.2f ms (%zu entries)\n",
+        gridBuild, (grid.getColumns() / std::size_t(64) + 1) * grid.getRows() * 8 / 1024, setBuild, empty.size());
+
+    report("unordered_set probe", queries, [&](std::size_t i) {
+        const sf::FloatRect& b = boxes[i & mask];
+        return empty.count(static_cast<int>(b.left + 20.f)) || empty.count(static_cast<int>(b.left + 50.f));
+    });
+    report("grid overlapsSolid", queries, [&](std::size_t i) {
+        return grid.overlapsSolid(boxes[i & mask]);
+    });
+    report("grid probe", queries, [&](std::size_t i) {
+        return grid.probe(boxes[i & mask]).ground;
+    });
+    report("grid sweep", queries, [&](std::size_t i) {
+        return grid.sweep(boxes[i & mask], deltas[i & mask]).contacts.ground;
+    });
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Enemy stress benchmark: thousands of walkers on a long generated level
+// with pits and walls, every one of them active, stepped through the same
+// per-tick systems as the game (gravity, motion, terrain, broadphase pairs,
+// animation). Reports simulation ticks per second and how many pairs the
+// sort-and-sweep broadphase tested against the n^2/2 a naive pass would.
+// On the last tick one naive pass runs over the same boxes (up to 10000
+// enemies) to time it and to check both find the same touching pairs.
+//
+//   enemy_bench [ticks] [threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "Animation.hpp"
+#include "Collision.hpp"
+#include "Enemies.hpp"
+#include "Entities.hpp"
+#include "JobSystem.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+
+    // Ground at y = 550 like Level0, with short pits and two-tile walls on top of it
+    CollisionGrid makeTerrain(unsigned int columns, std::mt19937& rng) {
+        CollisionGrid grid(columns, 12, sf::Vector2f(0.f, 450.f), sf::Vector2f(50.f, 50.f));
+        std::uniform_int_distribution<int> feature(0, 29);
+        for (unsigned int c = 0; c < columns; c++) {
+            int roll = c < 4 || c + 4 > columns ? 99 : feature(rng);
+            if (roll == 0)
+                continue;                   // Pit
+            for (int row = 2; row < 12; row++) grid.setSolid(static_cast<int>(c), row, true);
+            if (roll == 1) {
+                grid.setSolid(static_cast<int>(c), 0, true);
+                grid.setSolid(static_cast<int>(c), 1, true);
+            }
+        }
+        return grid;
+    }
+
+    // Every overlapping walker pair, the O(n^2) way
+    std::size_t naivePairs(const EntityStore& store, const EnemySystem& enemies) {
+        std::size_t touching = 0;
+        for (std::size_t a = 0; a < store.size(); a++) {
+            if (enemies.state[a] != EnemySystem::Walking) continue;
+            sf::FloatRect boxA(store.posX[a], store.posY[a], store.width[a], store.height[a]);
+            for (std::size_t b = a + 1; b < store.size(); b++) {
+                if (enemies.state[b] != EnemySystem::Walking) continue;
+                if (boxA.intersects(sf::FloatRect(store.posX[b], store.posY[b], store.width[b], store.height[b])))
+                    touching++;
+            }
+        }
+        return touching;
+    }
+}
+
+int main(int argc, char** argv) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 200;
+    unsigned int threads = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    const float dt = 0.01f;
+
+    AnimationLibrary clips;
+    AnimationLibrary::ClipId walk = clips.addClip("walk", { { sf::FloatRect(0, 0, 57, 58), 4 }, { sf::FloatRect(60, 0, 57, 58), 4 } });
+    JobSystem jobs(threads);
+
+    std::printf("enemy_bench: %d ticks, %u threads\n", ticks, jobs.getThreadCount());
+    std::printf("  %8s %10s %10s %10s %10s %12s %12s %10s\n", "enemies", "ticks/s", "terrain ms", "pairs ms", "tick ms",
+        "pairs/tick", "naive pairs", "alive");
+
+    for (std::size_t count : { 1000u, 10000u, 50000u }) {
+        std::mt19937 rng(7);
+        // About one walker per two tiles: crowded enough that many of them meet every second
+        unsigned int columns = static_cast<unsigned int>(count * 2);
+        CollisionGrid grid = makeTerrain(columns, rng);
+        const sf::FloatRect world(-1000.f, -1000.f, columns * 50.f + 2000.f, 3000.f);
+
+        EntityStore store;
+        store.setAnimations(clips);
+        EnemySystem enemies;
+        EntityStore::Prefab walker;
+        walker.clip = walk;
+        std::uniform_real_distribution<float> x(200.f, columns * 50.f - 400.f), drop(0.f, 300.f);
+        store.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            walker.velocity.x = i % 2 ? 100.f : -100.f;
+            walker.flipX = walker.velocity.x > 0.f;
+            enemies.add(store, store.spawn(walker, sf::Vector2f(x(rng), 380.f - drop(rng)), sf::Vector2f(48.f, 48.f)));
+        }
+
+        double terrainMs = 0.0, pairsMs = 0.0, tickMs = 0.0, pairsTested = 0.0, naiveMs = 0.0;
+        std::size_t naiveTouching = 0;
+        for (int t = 0; t < ticks; t++) {
+            bool lastTick = t + 1 == ticks;
+            auto tickStart = BenchClock::now();
+            store.clearActive();
+            store.activate(0, world);
+            enemies.applyGravity(store, dt);
+            store.updateActiveMotion(dt, -1e9f, &jobs);
+
+            auto start = BenchClock::now();
+            enemies.resolveTerrain(store, grid, &jobs);
+            terrainMs += millisecondsSince(start);
+
+            if (lastTick && count <= 10000) {
+                start = BenchClock::now();
+                naiveTouching = naivePairs(store, enemies);
+                naiveMs = millisecondsSince(start);
+                tickStart += BenchClock::now() - start;     // Not part of the tick
+            }
+
+            start = BenchClock::now();
+            enemies.resolvePairs(store);
+            pairsMs += millisecondsSince(start);
+
+            store.updateActiveAnimation(&jobs);
+            tickMs += millisecondsSince(tickStart);
+            pairsTested += static_cast<double>(enemies.getStats().pairsTested);
+        }
+
+        std::size_t alive = enemies.getStats().walking;
+
+        std::printf("  %8zu %10.0f %10.3f %10.3f %10.3f %12.0f %12.0f %10zu\n", count, ticks / (tickMs / 1000.0),
+            terrainMs / ticks, pairsMs / ticks, tickMs / ticks, pairsTested / ticks, alive * (alive - 1) / 2.0, alive);
+        if (naiveMs > 0.0) {
+            std::printf("  %8s naive pass %.3f ms: %zu touching, broadphase %zu%s\n", "", naiveMs, naiveTouching,
+                enemies.getStats().pairsTouching, naiveTouching == enemies.getStats().pairsTouching ? "" : "  MISMATCH");
+        }
+    }
+    return 0;
+}
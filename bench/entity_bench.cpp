@@ -0,0 +1,101 @@
+// Entity system benchmark: spawns N scenery entities into the SoA EntityStore
+// and times the per-tick motion, animation and sprite batch systems, first
+// over the whole store and then culled to a scrolling 1600x900 view.
+//
+//   entity_bench [ticks]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "Entities.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 100;
+    const float dt = 0.01f;
+
+    std::printf("entity_bench: %d ticks per size\n", ticks);
+    std::printf("  %10s %12s %12s %12s %12s %14s\n", "entities", "spawn ms", "motion ms", "anim ms", "batch ms", "ns/entity/tick");
+
+    for (std::size_t count : { 10000u, 100000u, 1000000u }) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> x(0.f, 500000.f), y(0.f, 600.f);
+
+        AnimationLibrary clips;
+        EntityStore store;
+        store.setAnimations(clips);
+        EntityStore::Prefab cloud, walker;
+        cloud.clip = clips.addClip("cloud", { { sf::FloatRect(0, 0, 331, 241), 4 } });
+        walker.clip = clips.addClip("walk", { { sf::FloatRect(0, 300, 57, 58), 4 }, { sf::FloatRect(60, 300, 57, 58), 4 } });
+        walker.layer = 1;
+        walker.velocity = sf::Vector2f(-250.f, 0.f);
+
+        auto start = BenchClock::now();
+        store.reserve(count);
+        for (std::size_t i = 0; i < count; i++)
+            store.spawn(i % 8 == 0 ? walker : cloud, sf::Vector2f(x(rng), y(rng)), sf::Vector2f(120.f, 80.f));
+        double spawnMs = millisecondsSince(start);
+
+        double motionMs = 0.0, animMs = 0.0, batchMs = 0.0;
+        sf::VertexArray batch(sf::Quads);
+        for (int t = 0; t < ticks; t++) {
+            start = BenchClock::now();
+            store.updateMotion(dt, -200.f);
+            motionMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            store.updateAnimation();
+            animMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            batch.clear();
+            store.appendQuads(0, batch, 0.5f);
+            store.appendQuads(1, batch, 0.5f);
+            batchMs += millisecondsSince(start);
+        }
+
+        double perEntity = (motionMs + animMs + batchMs) * 1e6 / (static_cast<double>(count) * ticks);
+        std::printf("  %10zu %12.2f %12.3f %12.3f %12.3f %14.2f\n", count, spawnMs,
+            motionMs / ticks, animMs / ticks, batchMs / ticks, perEntity);
+
+        // Same store, but only what a view (plus the game's 800px update margin) overlaps
+        double activateMs = 0.0, updateMs = 0.0, cullBatchMs = 0.0;
+        std::size_t active = 0, visible = 0;
+        for (int t = 0; t < ticks; t++) {
+            sf::FloatRect view(t * 40.f, 0.f, 1600.f, 900.f);
+            sf::FloatRect area(view.left - 800.f, view.top - 800.f, view.width + 1600.f, view.height + 1600.f);
+
+            start = BenchClock::now();
+            store.clearActive();
+            store.activate(0, area);
+            store.activate(1, area);
+            activateMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            store.updateActiveMotion(dt, -200.f);
+            store.updateActiveAnimation();
+            updateMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            batch.clear();
+            store.appendVisibleQuads(0, view, batch, 0.5f);
+            store.appendVisibleQuads(1, view, batch, 0.5f);
+            cullBatchMs += millisecondsSince(start);
+
+            active += store.getStats().active;
+            visible += store.getStats().visible;
+        }
+        std::printf("  %10s %12s %12.3f %12.3f %12.3f   culled: %zu active, %zu visible\n", "", "",
+            activateMs / ticks, updateMs / ticks, cullBatchMs / ticks, active / ticks, visible / ticks);
+    }
+    std::printf("  culled rows: query ms, active motion+anim ms, visible batch ms\n");
+    return 0;
+}
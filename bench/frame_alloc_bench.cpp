@@ -0,0 +1,109 @@
+// Steady-state allocation check: runs the per-frame data path of the game
+// (entity systems, sprite batching, level streaming, collision probes and
+// Mario's shape access) headless and counts heap allocations per frame after
+// a warm-up pass. Built with ENGINE3D_COUNT_ALLOCATIONS; exits non-zero if
+// the steady-state frame allocates. Run from the build directory.
+//
+//   frame_alloc_bench [level.lvl] [frames]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "AllocationCounter.hpp"
+#include "Camera.hpp"
+#include "Entities.hpp"
+#include "LevelStreamer.hpp"
+
+namespace {
+    // Runs frames of the given body and reports the allocations after warm-up
+    template <typename Frame>
+    std::uint64_t measure(const char* name, unsigned int warmup, unsigned int frames, Frame&& frame) {
+        FrameAllocationCheck check(warmup);
+        for (unsigned int i = 0; i < warmup + frames; i++) {
+            check.beginFrame();
+            frame(i);
+            check.endFrame();
+        }
+        std::printf("  %-28s %8.2f allocations/frame  (%llu of %llu frames allocated)\n", name,
+            static_cast<double>(check.getSteadyAllocations()) / check.getSteadyFrames(),
+            static_cast<unsigned long long>(check.getAllocatingFrames()), static_cast<unsigned long long>(check.getSteadyFrames()));
+        return check.getSteadyAllocations();
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "assets/level/Level0.lvl";
+    unsigned int frames = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 10000;
+    if (!AllocationCounter::enabled())
+        std::printf("frame_alloc_bench: built without ENGINE3D_COUNT_ALLOCATIONS, counts will read zero\n");
+
+    ChunkedLevel level;
+    if (!level.open(path))
+        return 1;
+
+    // Same layers, prefabs and streaming setup as the game
+    Camera camera(sf::Vector2f(1600.f, 900.f));
+    std::size_t worldLayer = camera.addLayer(1.f);
+    camera.setBounds(0.f, level.getWidth() - 1600.f);
+    LevelStreamer ground;
+    sf::Texture atlas;
+    ground.addTileTexture(atlas, sf::IntRect(0, 0, 50, 50));
+    ground.attach(level, 1600.f);
+
+    AnimationLibrary clips;
+    EntityStore entities;
+    entities.setAnimations(clips);
+    EntityStore::Prefab scenery, walker;
+    scenery.clip = clips.addClip("scenery", { { sf::FloatRect(0, 0, 64, 64), 4 } });
+    walker.clip = clips.addClip("walk", { { sf::FloatRect(64, 0, 64, 64), 4 }, { sf::FloatRect(128, 0, 64, 64), 4 } });
+    walker.layer = 1;
+    walker.velocity = sf::Vector2f(-250.f, 0.f);
+    for (std::size_t i = 0; i < level.getSpawnCount(); i++) {
+        const LevelFormat::SpawnEntry& spawn = level.getSpawn(i);
+        entities.spawn(level.getKindName(spawn.kind) == "gomma" ? walker : scenery,
+            sf::Vector2f(spawn.x, spawn.y), sf::Vector2f(spawn.width, spawn.height));
+    }
+    sf::VertexArray batches[2] = { sf::VertexArray(sf::Quads), sf::VertexArray(sf::Quads) };
+
+    sf::RectangleShape mario(sf::Vector2f(75.f, 75.f));
+    mario.setTexture(&atlas);
+
+    // One warm-up pass is enough for every buffer to reach its final capacity
+    float speed = 3.75f;
+    unsigned int warmup = static_cast<unsigned int>(2.f * level.getWidth() / speed) + 1;
+    std::printf("frame_alloc_bench: %s, %zu entities, %u warm-up frames, %u measured frames\n", path.c_str(), entities.size(), warmup, frames);
+
+    auto simulate = [&](unsigned int frame) {
+        // Ping-pong across the level so chunks keep streaming in and out
+        float period = 2.f * (level.getWidth() - 1600.f);
+        float x = static_cast<float>(std::fmod(frame * speed, period));
+        camera.setScroll(x < period / 2.f ? x : period - x);
+        ground.update(camera.getVisibleRect(worldLayer));
+        entities.clearActive();
+        for (std::uint8_t layer = 0; layer < 2; layer++)
+            entities.activate(layer, camera.getVisibleRect(worldLayer, 800.f));
+        entities.updateActiveMotion(0.01f, -200.f);
+        entities.updateActiveAnimation();
+        for (std::uint8_t layer = 0; layer < 2; layer++) {
+            batches[layer].clear();
+            entities.appendVisibleQuads(layer, camera.getVisibleRect(worldLayer), batches[layer], 0.5f);
+        }
+        return ground.getCollision().overlapsSolid(sf::FloatRect(camera.getScroll() + 410.f, 555.f, 30.f, 50.f));
+    };
+
+    float sink = 0.f;
+    std::uint64_t steady = measure("frame (shape by reference)", warmup, frames, [&](unsigned int frame) {
+        simulate(frame);
+        const sf::RectangleShape& shape = mario;
+        sink += shape.getPosition().x;
+    });
+    measure("frame (shape by value)", warmup, frames, [&](unsigned int frame) {
+        simulate(frame);
+        sf::RectangleShape shape = mario;
+        sink += shape.getPosition().x;
+    });
+
+    std::printf("%s (%g)\n", steady == 0 ? "PASS: no steady-state allocations" : "FAIL: steady-state frame allocates", sink);
+    return AllocationCounter::enabled() && steady != 0 ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+// Job system benchmark: runs the entity systems over one fully active
+// store at 1, 2, 4 and 8 threads and reports per-tick times and speedup
+// against the single-threaded run. The "steer" column is a compute-heavy
+// per-entity pass standing in for enemy AI; motion, animation and batch
+// building are mostly memory bound and scale with bandwidth, not cores.
+// Every run must end in the same state as the serial one.
+//
+//   job_bench [entities] [ticks]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Entities.hpp"
+#include "JobSystem.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+
+    // Clips shared by every store the benchmark fills
+    const AnimationLibrary& benchClips() {
+        static const AnimationLibrary clips = [] {
+            AnimationLibrary library;
+            library.addClip("cloud", { { sf::FloatRect(0, 0, 331, 241), 4 } });
+            library.addClip("walk", { { sf::FloatRect(0, 300, 57, 58), 4 }, { sf::FloatRect(60, 300, 57, 58), 4 } });
+            return library;
+        }();
+        return clips;
+    }
+
+    void fillStore(EntityStore& store, std::size_t count) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> x(0.f, 500000.f), y(0.f, 600.f);
+
+        store.setAnimations(benchClips());
+        EntityStore::Prefab cloud, walker;
+        cloud.clip = benchClips().find("cloud");
+        walker.clip = benchClips().find("walk");
+        walker.layer = 1;
+        walker.velocity = sf::Vector2f(-250.f, 0.f);
+
+        store.reserve(count);
+        for (std::size_t i = 0; i < count; i++)
+            store.spawn(i % 8 == 0 ? walker : cloud, sf::Vector2f(x(rng), y(rng)), sf::Vector2f(120.f, 80.f));
+    }
+
+    // Turns each walker towards a target with a few rounds of trig, writing only its own velocity
+    void steer(EntityStore& store, std::size_t begin, std::size_t end, float target_x) {
+        for (std::size_t i = begin; i < end; i++) {
+            float angle = std::atan2(300.f - store.posY[i], target_x - store.posX[i]);
+            for (int round = 0; round < 8; round++)
+                angle += 0.01f * std::sin(angle * 3.f + round);
+            store.velY[i] = store.velX[i] != 0.f ? 5.f * std::sin(angle) : 0.f;
+        }
+    }
+
+    double checksum(const EntityStore& store) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < store.size(); i++)
+            sum += store.posX[i] * 0.5 + store.posY[i] + store.animators.frame[i];
+        return sum;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 50;
+    const float dt = 0.01f;
+    const sf::FloatRect world(-1000.f, -1000.f, 502000.f, 2600.f);
+
+    std::printf("job_bench: %zu entities, %d ticks, %u hardware threads\n", count, ticks, std::thread::hardware_concurrency());
+    std::printf("  %8s %10s %10s %10s %10s %10s %9s %10s\n", "threads", "steer ms", "motion ms", "anim ms", "batch ms", "total ms", "speedup", "steals");
+
+    double serialTotal = 0.0, serialChecksum = 0.0;
+    for (unsigned int threads : { 1u, 2u, 4u, 8u }) {
+        EntityStore store;
+        fillStore(store, count);
+        JobSystem jobs(threads);
+        sf::VertexArray batch(sf::Quads);
+
+        double steerMs = 0.0, motionMs = 0.0, animMs = 0.0, batchMs = 0.0;
+        for (int t = 0; t < ticks; t++) {
+            store.clearActive();
+            store.activate(0, world);
+            store.activate(1, world);
+
+            auto start = BenchClock::now();
+            jobs.parallelFor(store.size(), 4096, [&](std::size_t begin, std::size_t end) {
+                steer(store, begin, end, t * 100.f);
+            });
+            steerMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            store.updateActiveMotion(dt, -200.f, &jobs);
+            motionMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            store.updateActiveAnimation(&jobs);
+            animMs += millisecondsSince(start);
+
+            start = BenchClock::now();
+            batch.clear();
+            store.appendVisibleQuads(0, world, batch, 0.5f, &jobs);
+            store.appendVisibleQuads(1, world, batch, 0.5f, &jobs);
+            batchMs += millisecondsSince(start);
+        }
+
+        double total = (steerMs + motionMs + animMs + batchMs) / ticks;
+        double sum = checksum(store);
+        if (threads == 1) {
+            serialTotal = total;
+            serialChecksum = sum;
+        }
+        std::printf("  %8u %10.3f %10.3f %10.3f %10.3f %10.3f %8.2fx %10llu%s\n", threads,
+            steerMs / ticks, motionMs / ticks, animMs / ticks, batchMs / ticks, total, serialTotal / total,
+            static_cast<unsigned long long>(jobs.getStats().steals), sum == serialChecksum ? "" : "  STATE MISMATCH");
+    }
+
+    // Dependencies: the second job must see everything the first one wrote
+    JobSystem jobs(4);
+    std::vector<int> values(1 << 16, 0);
+    auto fill = [&](std::size_t, std::size_t) { for (auto& value : values) value = 1; };
+    bool ordered = true;
+    auto check = [&](std::size_t, std::size_t) { for (int value : values) ordered = ordered && value == 1; };
+    JobCounter filled, checked;
+    jobs.run(check, checked, &filled);
+    jobs.run(fill, filled);
+    jobs.wait(checked);
+    std::printf("  dependency order: %s\n", ordered ? "ok" : "BROKEN");
+    return ordered ? 0 : 1;
+}
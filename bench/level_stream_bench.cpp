@@ -0,0 +1,80 @@
+// Level streaming benchmark: writes generated .lvl files from 10 to 10000
+// screens long, then times opening the mapping and scrolling the chunk
+// window across the whole level. Open time and resident tiles should stay
+// flat as the level grows.
+//
+//   level_stream_bench [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include "LevelStreamer.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+
+    // Ground like Level0: 10 rows of bricks with short gaps between long runs
+    LevelFormat::LevelData makeLevel(std::uint32_t columns, std::mt19937& rng) {
+        LevelFormat::LevelData level;
+        level.header.columns = columns;
+        level.header.rows = 10;
+        level.header.chunkColumns = 16;
+        level.header.tileWidth = level.header.tileHeight = 50.f;
+        level.header.originY = 550.f;
+
+        LevelFormat::LayerInfo ground;
+        std::snprintf(ground.name, sizeof(ground.name), "ground");
+        ground.flags = LevelFormat::SolidLayer;
+        level.layers.push_back(ground);
+        level.tiles.emplace_back(static_cast<std::size_t>(columns) * 10, std::uint8_t(1));
+
+        std::uniform_int_distribution<int> run(20, 60), gap(1, 5);
+        std::uint32_t kind = LevelFormat::kindIndex(level, "gomma");
+        for (std::uint32_t c = static_cast<std::uint32_t>(run(rng)); c < columns; c += static_cast<std::uint32_t>(run(rng))) {
+            for (int i = gap(rng); i > 0 && c < columns; i--, c++) {
+                for (std::size_t row = 0; row < 10; row++) level.tiles[0][row * columns + c] = 0;
+            }
+            level.spawns.push_back(LevelFormat::SpawnEntry{ kind, c * 50.f, 480.f, 70.f, 70.f });
+        }
+        return level;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string directory = argc > 1 ? argv[1] : ".";
+    std::mt19937 rng(1234);
+
+    std::printf("%10s %12s %10s %10s %14s %12s %14s\n", "screens", "file KiB", "write ms", "open ms", "resident tiles", "scroll ms", "chunk loads");
+    for (std::uint32_t screens : { 10u, 100u, 1000u, 10000u }) {
+        std::string path = directory + "/stream_bench_" + std::to_string(screens) + ".lvl";
+        auto start = BenchClock::now();
+        if (!LevelFormat::writeLevel(path, makeLevel(screens * 32, rng)))
+            return 1;
+        double writeMs = millisecondsSince(start);
+
+        start = BenchClock::now();
+        ChunkedLevel level;
+        if (!level.open(path))
+            return 1;
+        LevelStreamer streamer;
+        streamer.attach(level, 1600.f);
+        streamer.update(sf::FloatRect(0.f, 0.f, 1600.f, 900.f));
+        double openMs = millisecondsSince(start);
+
+        // Scroll at the game's running speed (375 px/s, 100 ticks/s) from start to end
+        start = BenchClock::now();
+        for (float x = 0.f; x < level.getWidth() - 1600.f; x += 3.75f)
+            streamer.update(sf::FloatRect(x, 0.f, 1600.f, 900.f));
+        double scrollMs = millisecondsSince(start);
+
+        std::printf("%10u %12zu %10.2f %10.3f %14zu %12.2f %14u\n", screens, level.getFileSize() / 1024, writeMs, openMs,
+            streamer.getStats().residentTiles, scrollMs, streamer.getStats().chunkLoads);
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Logging benchmark: a simulated frame of fixed work that also writes one
+// status line, like Mario::updateFall() used to while falling. Compares the
+// old std::cout << ... << std::endl against the async logger, and against
+// a call filtered out at compile time. Both sinks write to a file so the
+// terminal does not skew the numbers.
+//
+//   log_bench [frames] [output file]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Log.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double microsecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    }
+
+    // About 20 us of arithmetic standing in for a game frame
+    float frameWork(int frame) {
+        float sum = 0.f;
+        for (int i = 0; i < 4000; i++)
+            sum += std::sin(frame * 0.001f + i * 0.01f);
+        return sum;
+    }
+
+    volatile float sink = 0.f;     // Keeps the frame work from being optimized away
+
+    template <typename LogLine>
+    void measure(const char* label, int frames, LogLine&& logLine) {
+        std::vector<double> times(frames);
+        for (int frame = 0; frame < frames; frame++) {
+            auto start = BenchClock::now();
+            sink = sink + frameWork(frame);
+            logLine(frame, sink);
+            times[frame] = microsecondsSince(start);
+        }
+        std::sort(times.begin(), times.end());
+        double total = 0.0;
+        for (double time : times) total += time;
+        std::printf("  %-28s %9.2f us avg %9.2f us p99 %9.2f us max\n", label,
+            total / frames, times[frames * 99 / 100], times.back());
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 20000;
+    std::string outputPath = argc > 2 ? argv[2] : "log_bench.out";
+
+    std::printf("log_bench: %d frames, one log line per frame, output to %s\n", frames, outputPath.c_str());
+
+    // The logger's writer thread uses std::cout too, so it stays redirected until the end
+    std::ofstream output(outputPath);
+    std::streambuf* console = std::cout.rdbuf(output.rdbuf());
+    measure("no logging", frames, [](int, float) {});
+    measure("std::cout << std::endl", frames, [](int frame, float value) {
+        std::cout << value << " Mario Y: " << frame * 0.5f << std::endl;
+    });
+    measure("LOG_INFO (async)", frames, [](int frame, float value) {
+        LOG_INFO << value << " Mario Y: " << frame * 0.5f;
+    });
+    measure("LOG_TRACE (compiled out)", frames, [](int frame, float value) {
+        LOG_TRACE << value << " Mario Y: " << frame * 0.5f;
+    });
+    Log::flush();
+
+    // Cost of the call alone, without the frame around it, once the queue is warm
+    const int calls = 1000;
+    for (int i = 0; i < calls; i++)
+        LOG_INFO << "Warm-up " << i;
+    Log::flush();
+    auto start = BenchClock::now();
+    for (int i = 0; i < calls; i++)
+        LOG_INFO << "Call " << i << " at " << i * 0.25f;
+    double perCall = microsecondsSince(start) * 1000.0 / calls;
+    Log::flush();
+    std::cout.rdbuf(console);
+
+    std::printf("  %-28s %9.1f ns, %llu lines dropped\n", "LOG_INFO call", perCall,
+        static_cast<unsigned long long>(Log::logger().getDropped()));
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Sprite batch benchmark: builds textured quads for 10k, 100k and 1M
+// sprites, axis-aligned and rotated, and reports vertices per second for
+// each QuadBuilder path the CPU has against the per-shape path (one
+// sf::RectangleShape set up per sprite, its transform applied to the four
+// corners the way RenderTarget::draw does for small batches). The shape is
+// reused, so the per-shape numbers leave out its allocations. Every path
+// must write the same quads as the scalar one.
+//
+//   quad_bench [repeats]
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "QuadBuilder.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+
+    struct SpriteArrays {
+        std::vector<float> x, y, width, height, texLeft, texTop, texWidth, texHeight, degrees, cosine, sine;
+        std::vector<sf::Color> color;
+
+        explicit SpriteArrays(std::size_t count) {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> position(0.f, 100000.f), size(16.f, 128.f), frame(0.f, 8.f), angle(0.f, 360.f);
+            for (std::size_t i = 0; i < count; i++) {
+                x.push_back(position(rng));
+                y.push_back(position(rng) * 0.01f);
+                width.push_back(size(rng));
+                height.push_back(size(rng));
+                texLeft.push_back(std::floor(frame(rng)) * 60.f);
+                texTop.push_back(300.f);
+                texWidth.push_back(i % 2 ? 57.f : -57.f);
+                texHeight.push_back(58.f);
+                degrees.push_back(angle(rng));
+                cosine.push_back(std::cos(degrees.back() * 3.14159265f / 180.f));
+                sine.push_back(std::sin(degrees.back() * 3.14159265f / 180.f));
+                color.push_back(sf::Color(static_cast<sf::Uint8>(i), 255, 255));
+            }
+        }
+
+        QuadBuilder::Sprites view(bool rotated) const {
+            QuadBuilder::Sprites sprites;
+            sprites.count = x.size();
+            sprites.x = x.data(); sprites.y = y.data(); sprites.width = width.data(); sprites.height = height.data();
+            sprites.texLeft = texLeft.data(); sprites.texTop = texTop.data();
+            sprites.texWidth = texWidth.data(); sprites.texHeight = texHeight.data();
+            sprites.color = color.data();
+            if (rotated) {
+                sprites.cosine = cosine.data();
+                sprites.sine = sine.data();
+            }
+            return sprites;
+        }
+    };
+
+    void buildShapes(const SpriteArrays& sprites, bool rotated, sf::RectangleShape& shape, sf::Vertex* out) {
+        for (std::size_t i = 0; i < sprites.x.size(); i++) {
+            float w = sprites.width[i], h = sprites.height[i];
+            shape.setSize(sf::Vector2f(w, h));
+            shape.setOrigin(w * 0.5f, h * 0.5f);
+            shape.setPosition(sprites.x[i] + w * 0.5f, sprites.y[i] + h * 0.5f);
+            shape.setRotation(rotated ? sprites.degrees[i] : 0.f);
+            shape.setFillColor(sprites.color[i]);
+            float u0 = sprites.texLeft[i], v0 = sprites.texTop[i];
+            float u1 = u0 + sprites.texWidth[i], v1 = v0 + sprites.texHeight[i];
+            const sf::Vector2f tex[4] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+
+            const sf::Transform& transform = shape.getTransform();
+            for (std::size_t k = 0; k < 4; k++)
+                out[i * 4 + k] = sf::Vertex(transform.transformPoint(shape.getPoint(k)), shape.getFillColor(), tex[k]);
+        }
+    }
+
+    // Largest difference in any position or texture coordinate
+    float largestDifference(const std::vector<sf::Vertex>& a, const std::vector<sf::Vertex>& b) {
+        float largest = 0.f;
+        for (std::size_t v = 0; v < a.size(); v++) {
+            float d[4] = { a[v].position.x - b[v].position.x, a[v].position.y - b[v].position.y,
+                a[v].texCoords.x - b[v].texCoords.x, a[v].texCoords.y - b[v].texCoords.y };
+            for (float value : d) largest = std::max(largest, std::fabs(value));
+            if (a[v].color != b[v].color) largest = std::max(largest, 1e9f);
+        }
+        return largest;
+    }
+}
+
+int main(int argc, char** argv) {
+    int repeats = argc > 1 ? std::atoi(argv[1]) : 10;
+    QuadBuilder::Path best = QuadBuilder::detect();
+
+    std::printf("quad_bench: %d repeats, best path %s\n", repeats, QuadBuilder::getName(best));
+    std::printf("  %8s %8s %16s %16s %9s\n", "sprites", "path", "aligned Mvert/s", "rotated Mvert/s", "speedup");
+
+    bool allMatch = true;
+    for (std::size_t count : { 10000u, 100000u, 1000000u }) {
+        SpriteArrays sprites(count);
+        std::vector<sf::Vertex> out(count * 4), reference[2];
+        double shapeRate[2] = { 0.0, 0.0 };
+
+        for (int rotated = 0; rotated < 2; rotated++) {
+            sf::RectangleShape shape;
+            auto start = BenchClock::now();
+            for (int r = 0; r < repeats; r++)
+                buildShapes(sprites, rotated, shape, out.data());
+            shapeRate[rotated] = count * 4.0 * repeats / (millisecondsSince(start) * 1000.0);
+            reference[rotated] = out;
+        }
+        std::printf("  %8zu %8s %16.1f %16.1f\n", count, "shape", shapeRate[0], shapeRate[1]);
+
+        std::vector<sf::Vertex> scalar[2];
+        for (QuadBuilder::Path path : { QuadBuilder::Path::Scalar, QuadBuilder::Path::SSE, QuadBuilder::Path::AVX }) {
+            if (static_cast<int>(path) > static_cast<int>(best))
+                continue;
+            QuadBuilder builder(path);
+            double rate[2];
+            bool same = true;
+            for (int rotated = 0; rotated < 2; rotated++) {
+                QuadBuilder::Sprites view = sprites.view(rotated);
+                auto start = BenchClock::now();
+                for (int r = 0; r < repeats; r++)
+                    builder.build(view, out.data());
+                rate[rotated] = count * 4.0 * repeats / (millisecondsSince(start) * 1000.0);
+
+                // Paths agree exactly; against the shapes only up to rounding
+                if (path == QuadBuilder::Path::Scalar)
+                    scalar[rotated] = out;
+                same = same && largestDifference(out, scalar[rotated]) == 0.f && largestDifference(out, reference[rotated]) < 0.01f;
+            }
+            allMatch = allMatch && same;
+            std::printf("  %8s %8s %16.1f %16.1f %8.1fx%s\n", "", QuadBuilder::getName(path), rate[0], rate[1],
+                rate[1] / shapeRate[1], same ? "" : "  MISMATCH");
+        }
+    }
+    std::printf("  speedup: rotated sprites against the per-shape path\n");
+    return allMatch ? 0 : 1;
+}
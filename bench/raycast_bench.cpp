@@ -0,0 +1,162 @@
+// Raycaster benchmark: renders a generated 64x64 grid level with textured
+// walls, a sky and a few hundred billboard sprites at 1600x900 (or the
+// given size) while the camera walks and turns, at 1, 2, 4 and 8 threads.
+// Reports milliseconds and frames per second, plus the speedup over one
+// thread, for the whole frame and for the walls alone (no sprites). The
+// texture upload is left out: it is one sf::Texture::update() of the
+// finished frame. Every thread count must produce the same pixels as the
+// single-threaded run.
+//
+//   raycast_bench [frames] [width height]
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Hash.hpp"
+#include "JobSystem.hpp"
+#include "Raycaster.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double millisecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+    }
+
+    // Brick pattern in the given colour, mortar lines every 16 texels
+    sf::Image brickImage(sf::Color brick) {
+        sf::Image image;
+        image.create(64, 64, brick);
+        for (unsigned int y = 0; y < 64; y++) {
+            for (unsigned int x = 0; x < 64; x++) {
+                unsigned int offset = (y / 16) % 2 ? 8 : 0;
+                if (y % 16 == 0 || (x + offset) % 16 == 0)
+                    image.setPixel(x, y, sf::Color(200, 200, 190));
+            }
+        }
+        return image;
+    }
+
+    // Opaque disc on a transparent square
+    sf::Image discImage() {
+        sf::Image image;
+        image.create(64, 64, sf::Color::Transparent);
+        for (unsigned int y = 0; y < 64; y++) {
+            for (unsigned int x = 0; x < 64; x++) {
+                float dx = x - 31.5f, dy = y - 31.5f;
+                if (dx * dx + dy * dy < 30.f * 30.f)
+                    image.setPixel(x, y, sf::Color(40, 160, 60));
+            }
+        }
+        return image;
+    }
+
+    sf::Image skyImage() {
+        sf::Image image;
+        image.create(512, 225);
+        for (unsigned int y = 0; y < 225; y++) {
+            for (unsigned int x = 0; x < 512; x++)
+                image.setPixel(x, y, sf::Color(80 + y / 3, 120 + y / 4, 230, 255));
+        }
+        return image;
+    }
+
+    // Walled border, rows of pillars and a few long walls, with the middle row left open to walk along
+    GridMap benchMap() {
+        GridMap map(64, 64);
+        std::mt19937 rng(7);
+        for (int i = 0; i < 64; i++) {
+            map.set(i, 0, 1); map.set(i, 63, 1);
+            map.set(0, i, 1); map.set(63, i, 1);
+        }
+        for (int y = 4; y < 60; y += 6) {
+            for (int x = 4; x < 60; x += 6) {
+                if (y != 32 && y != 34)
+                    map.set(x, y, static_cast<std::uint8_t>(1 + rng() % 2));
+            }
+        }
+        for (int x = 10; x < 54; x++) {
+            map.set(x, 20, 2);
+            map.set(x, 46, 1);
+        }
+        return map;
+    }
+
+    std::uint64_t hashPixels(const sf::Uint8* pixels, std::size_t bytes) {
+        return Fnv1a::hash(pixels, bytes);
+    }
+
+    struct Run {
+        double milliseconds = 0.0;
+        std::uint64_t hash = 0;
+    };
+
+    Run renderFrames(Raycaster& raycaster, const GridMap& map, const std::vector<Raycaster::Sprite>& sprites, JobSystem& jobs, int frames) {
+        Run run;
+        auto start = BenchClock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            Raycaster::View view;
+            view.position = sf::Vector2f(3.f + 57.f * frame / frames, 33.f);
+            view.angle = std::sin(frame * 0.05f) * 1.2f;
+            raycaster.render(map, view, sprites, &jobs);
+        }
+        run.milliseconds = millisecondsSince(start) / frames;
+        sf::Vector2u size = raycaster.getSize();
+        run.hash = hashPixels(raycaster.getPixels(), static_cast<std::size_t>(size.x) * size.y * 4);
+        return run;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 120;
+    unsigned int width = argc > 3 ? static_cast<unsigned int>(std::atoi(argv[2])) : 1600;
+    unsigned int height = argc > 3 ? static_cast<unsigned int>(std::atoi(argv[3])) : 900;
+
+    Raycaster raycaster(width, height);
+    raycaster.addTexture(brickImage(sf::Color(150, 60, 40)));
+    raycaster.addTexture(brickImage(sf::Color(60, 70, 150)));
+    std::uint16_t disc = raycaster.addTexture(discImage());
+    raycaster.setSky(skyImage());
+    GridMap map = benchMap();
+
+    std::vector<Raycaster::Sprite> sprites;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(1.5f, 62.5f);
+    for (int i = 0; i < 300; i++) {
+        Raycaster::Sprite sprite;
+        sprite.position = sf::Vector2f(position(rng), position(rng));
+        if (map.isSolid(static_cast<int>(sprite.position.x), static_cast<int>(sprite.position.y)))
+            continue;
+        sprite.texture = disc;
+        sprite.scale = 0.5f;
+        sprites.push_back(sprite);
+    }
+    const std::vector<Raycaster::Sprite> noSprites;
+
+    std::printf("raycast_bench: %ux%u, %d frames, %zu sprites\n", width, height, frames, sprites.size());
+    std::printf("  %7s %12s %9s %9s %12s %9s\n", "threads", "frame ms", "fps", "speedup", "walls ms", "speedup");
+
+    Run serial, serialWalls;
+    bool allMatch = true;
+    for (unsigned int threads : { 1u, 2u, 4u, 8u }) {
+        JobSystem jobs(threads);
+        renderFrames(raycaster, map, sprites, jobs, 5);        // Warm-up
+        Run walls = renderFrames(raycaster, map, noSprites, jobs, frames);
+        Run full = renderFrames(raycaster, map, sprites, jobs, frames);
+        if (threads == 1) {
+            serial = full;
+            serialWalls = walls;
+        }
+        bool same = full.hash == serial.hash && walls.hash == serialWalls.hash;
+        allMatch = allMatch && same;
+        std::printf("  %7u %12.2f %9.1f %8.2fx %12.2f %8.2fx%s\n", threads, full.milliseconds, 1000.0 / full.milliseconds,
+            serial.milliseconds / full.milliseconds, walls.milliseconds, serialWalls.milliseconds / walls.milliseconds,
+            same ? "" : "  MISMATCH");
+    }
+    std::printf("  %zu sprites on screen in the last frame; 60 fps needs 16.67 ms\n", raycaster.getStats().spritesProjected);
+    return allMatch ? 0 : 1;
+}
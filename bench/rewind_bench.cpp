@@ -0,0 +1,120 @@
+// Rewind history benchmark: pushes generated state images into a
+// RewindBuffer tick by tick, a few hundred bytes of positions moving among
+// mostly unchanged ones, and reports bytes held per tick and the cost of a
+// push and of a restore. The image size changes every so often, the way it
+// does when entities come and go, some ticks change most of their bytes and
+// are stored whole, and the smaller budgets wrap the arena many times over.
+// After every push the oldest, the newest and one random held tick are
+// restored, and at the end every held tick, and each must match the image
+// that was pushed for it.
+//
+//   rewind_bench [ticks]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Rewind.hpp"
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    double microsecondsSince(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    }
+
+    std::uint64_t mix(std::uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    // How the generated images change from tick to tick
+    struct Workload {
+        const char* name;
+        std::size_t baseSize;
+        std::uint64_t resizeEvery;          // The size changes by up to a half this often
+        std::uint64_t wholeOneIn;           // One tick in this many changes most bytes and is stored whole
+    };
+
+    // The image pushed for tick: every 16th float moves and the rest stay
+    // put, except on the ticks stored whole
+    void makeState(std::uint64_t tick, const Workload& work, std::vector<std::uint8_t>& image) {
+        std::size_t size = work.baseSize + static_cast<std::size_t>(mix(tick / work.resizeEvery) % (work.baseSize / 2));
+        image.resize(size);
+        for (std::size_t at = 0; at + 4 <= size; at += 4) {
+            std::size_t index = at / 4;
+            float value = static_cast<float>(index) * 1.5f;
+            if (index % 16 == 0)
+                value += static_cast<float>(tick) * 0.25f * static_cast<float>(index % 5 + 1);
+            std::memcpy(image.data() + at, &value, 4);
+        }
+        for (std::size_t at = size & ~std::size_t(3); at < size; at++) image[at] = static_cast<std::uint8_t>(tick);
+        if (mix(tick) % work.wholeOneIn == 0) {
+            for (std::size_t at = 0; at < size; at += 8) image[at] ^= static_cast<std::uint8_t>(mix(tick + at) | 1);
+        }
+    }
+
+    bool matches(const RewindBuffer& history, std::uint64_t tick, const Workload& work,
+        std::vector<std::uint8_t>& restored, std::vector<std::uint8_t>& expected) {
+        if (!history.restore(tick, restored))
+            return false;
+        makeState(tick, work, expected);
+        return restored == expected;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000;
+    if (ticks == 0) ticks = 1;
+
+    std::printf("rewind_bench: %llu ticks\n", static_cast<unsigned long long>(ticks));
+    std::printf("  %7s %9s %10s %8s %10s %10s %10s %10s\n", "images", "state", "budget", "held", "bytes/tick", "push us", "restore us", "checked");
+
+    bool allMatch = true;
+    // Game-like images, then ones stored whole at a new size nearly every tick, the hardest case for the arena
+    const Workload workloads[] = { { "game", 4096, 37, 7 }, { "game", 120000, 37, 7 }, { "noisy", 4096, 1, 1 } };
+    for (const Workload& work : workloads) {
+        std::size_t stateSize = work.baseSize;
+        for (std::size_t budget : { stateSize * 8, stateSize * 40, std::size_t(32) << 20 }) {
+            RewindBuffer history(budget);
+            std::vector<std::uint8_t> state, restored, expected;
+            std::mt19937 rng(7);
+            double pushTime = 0.0, restoreTime = 0.0;
+            std::uint64_t restores = 0, checked = 0;
+            bool same = true;
+
+            for (std::uint64_t tick = 1; tick <= ticks; tick++) {
+                makeState(tick, work, state);
+                auto start = BenchClock::now();
+                history.push(tick, state);
+                pushTime += microsecondsSince(start);
+                if (history.empty())
+                    continue;
+
+                std::uint64_t oldest = history.getOldestTick(), newest = history.getNewestTick();
+                std::uint64_t any = oldest + rng() % (newest - oldest + 1);
+                for (std::uint64_t check : { oldest, newest, any }) {
+                    start = BenchClock::now();
+                    same = same && matches(history, check, work, restored, expected);
+                    restoreTime += microsecondsSince(start);
+                    restores++;
+                    checked++;
+                }
+            }
+            for (std::uint64_t tick = history.getOldestTick(); !history.empty() && tick <= history.getNewestTick(); tick++, checked++)
+                same = same && matches(history, tick, work, restored, expected);
+
+            const RewindBuffer::Stats& stats = history.getStats();
+            allMatch = allMatch && same;
+            std::printf("  %7s %9zu %9zuK %8zu %10.0f %10.2f %10.2f %10llu%s\n", work.name, stateSize, budget / 1024, stats.ticks,
+                stats.ticks ? static_cast<double>(stats.bytesUsed) / stats.ticks : 0.0, pushTime / ticks,
+                restores ? restoreTime / restores : 0.0, static_cast<unsigned long long>(checked), same ? "" : "  MISMATCH");
+        }
+    }
+    std::printf("  restore us includes comparing against the image pushed\n");
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// Startup asset benchmark: decodes every PNG/WAV/OGG under assets/ with
+// AssetLoader at increasing worker counts and prints per-asset decode times.
+// Given a baked pack, it then compares decoding the loose files the pack was
+// built from against mapping the pack and copying the same images and
+// samples out of it. Decoding only; the GL upload is not timed since it
+// needs a window.
+//
+//   startup_bench [asset root, default "assets"] [assets.pak]
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AssetLoader.hpp"
+#include "AssetPack.hpp"
+
+namespace {
+    // Opens the pack and copies every image, page and sound out of the
+    // mapping into the same objects AssetLoader decodes into
+    double loadPackMs(const std::string& path, std::size_t& loaded) {
+        sf::Clock timer;
+        AssetPackFile pack;
+        if (!pack.open(path))
+            return -1.0;
+        std::vector<sf::Image> images;
+        std::vector<std::vector<sf::Int16>> sounds;
+        for (std::size_t i = 0; i < pack.getEntryCount(); i++) {
+            const AssetPack::Entry& entry = pack.getEntry(i);
+            if (entry.kind == AssetPack::Image || entry.kind == AssetPack::AtlasPage) {
+                images.emplace_back();
+                images.back().create(entry.width, entry.height, pack.getData(entry));
+            }
+            else if (entry.kind == AssetPack::Sound) {
+                const sf::Int16* samples = reinterpret_cast<const sf::Int16*>(pack.getData(entry));
+                sounds.emplace_back(samples, samples + entry.size / sizeof(sf::Int16));
+            }
+        }
+        loaded = images.size() + sounds.size();
+        return timer.getElapsedTime().asMicroseconds() / 1000.0;
+    }
+
+    // Decodes the loose files a pack was baked from, on thread_count workers
+    double loadLooseMs(const AssetPackFile& pack, unsigned int thread_count) {
+        AssetLoader loader;
+        for (std::size_t i = 0; i < pack.getEntryCount(); i++) {
+            const AssetPack::Entry& entry = pack.getEntry(i);
+            if (entry.kind == AssetPack::Image || entry.kind == AssetPack::AtlasFrame)
+                loader.queueImage(entry.name);
+            else if (entry.kind == AssetPack::Sound)
+                loader.queueSound(entry.name);
+        }
+        loader.start(thread_count);
+        loader.wait();
+        return loader.getWallSeconds() * 1000.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string root = argc > 1 ? argv[1] : "assets";
+
+    std::vector<std::string> images, sounds;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root, error)) {
+        std::string ext = entry.path().extension().string();
+        if (ext == ".png")
+            images.push_back(entry.path().generic_string());
+        else if (ext == ".wav" || ext == ".ogg")
+            sounds.push_back(entry.path().generic_string());
+    }
+    std::sort(images.begin(), images.end());
+    std::sort(sounds.begin(), sounds.end());
+    if (images.empty() && sounds.empty()) {
+        std::fprintf(stderr, "startup_bench: no assets under '%s' (run from the build directory)\n", root.c_str());
+        return 1;
+    }
+
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts = { 1, 2, 4, 8 };
+    if (std::find(threadCounts.begin(), threadCounts.end(), hardware) == threadCounts.end())
+        threadCounts.push_back(hardware);
+
+    std::printf("startup_bench: %zu images, %zu sounds, %u hardware threads\n", images.size(), sounds.size(), hardware);
+
+    float serialSeconds = 0.f;
+    std::vector<AssetLoader::Timing> serialTimings;
+    for (unsigned int threads : threadCounts) {
+        AssetLoader loader;
+        for (const auto& path : images) loader.queueImage(path);
+        for (const auto& path : sounds) loader.queueSound(path);
+        loader.start(threads);
+        loader.wait();
+
+        float seconds = loader.getWallSeconds();
+        if (threads == 1) {
+            serialSeconds = seconds;
+            serialTimings = loader.getTimings();
+        }
+        std::printf("  %2u threads: %8.2f ms  (x%.2f)\n", threads, seconds * 1000.f, serialSeconds / seconds);
+    }
+
+    std::printf("per-asset decode times (1 thread):\n");
+    std::sort(serialTimings.begin(), serialTimings.end(), [](const AssetLoader::Timing& a, const AssetLoader::Timing& b) {
+        return a.decodeSeconds > b.decodeSeconds;
+    });
+    for (const auto& timing : serialTimings)
+        std::printf("  %8.3f ms  %s%s\n", timing.decodeSeconds * 1000.f, timing.path.c_str(), timing.ok ? "" : "  (failed)");
+
+    if (argc > 2) {
+        AssetPackFile pack;
+        if (!pack.open(argv[2]))
+            return 1;
+        std::size_t loaded = 0;
+        double packed = loadPackMs(argv[2], loaded);
+        double serial = loadLooseMs(pack, 1), parallel = loadLooseMs(pack, hardware);
+        std::printf("%s: %zu images and sounds in %.3f ms; the loose files take %.3f ms on 1 thread (x%.1f), %.3f ms on %u (x%.1f)\n",
+            argv[2], loaded, packed, serial, serial / packed, parallel, hardware, parallel / packed);
+    }
+    return 0;
+}
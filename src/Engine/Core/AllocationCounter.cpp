@@ -0,0 +1,37 @@
+#include "AllocationCounter.hpp"
+
+// Global allocation hooks, compiled in only for allocation-counting builds
+// (cmake -DENGINE3D_COUNT_ALLOCATIONS=ON). The nothrow forms forward to these
+// in libstdc++, libc++ and MSVC; over-aligned allocations are not counted.
+#ifdef ENGINE3D_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size) {
+    AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    AllocationCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+// ─────────────────────────────────────────────
+// Allocation counting
+// Building with ENGINE3D_COUNT_ALLOCATIONS replaces the global operator new
+// (see AllocationCounter.cpp) so every heap allocation bumps a counter.
+// Without the define the counter stays at zero and the checks cost nothing.
+// ─────────────────────────────────────────────
+namespace AllocationCounter {
+    inline std::atomic<std::uint64_t> allocations{ 0 };
+    inline std::atomic<std::uint64_t> bytes{ 0 };
+
+    constexpr bool enabled() {
+#ifdef ENGINE3D_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+// ─────────────────────────────────────────────
+// FrameAllocationCheck Class
+// Counts heap allocations per frame once a warm-up period is over, when
+// every buffer should have reached its steady-state capacity. A non-zero
+// steady-state count means something in the frame is still allocating.
+// ─────────────────────────────────────────────
+class FrameAllocationCheck {
+private:
+    unsigned int warmupFrames;
+    std::uint64_t frames = 0;
+    std::uint64_t frameStart = 0;
+    std::uint64_t steadyAllocations = 0;    // Allocations in frames after warm-up
+    std::uint64_t allocatingFrames = 0;     // Frames after warm-up that allocated at all
+
+public:
+    FrameAllocationCheck(unsigned int warmup_frames = 120) : warmupFrames(warmup_frames) {}
+
+    void beginFrame() {
+        frameStart = AllocationCounter::allocations.load(std::memory_order_relaxed);
+    }
+
+    // Returns the allocations made since beginFrame()
+    std::uint64_t endFrame() {
+        std::uint64_t count = AllocationCounter::allocations.load(std::memory_order_relaxed) - frameStart;
+        if (++frames > warmupFrames) {
+            steadyAllocations += count;
+            allocatingFrames += count != 0;
+        }
+        return count;
+    }
+
+    std::uint64_t getSteadyFrames() const {
+        return frames > warmupFrames ? frames - warmupFrames : 0;
+    }
+
+    std::uint64_t getSteadyAllocations() const {
+        return steadyAllocations;
+    }
+
+    std::uint64_t getAllocatingFrames() const {
+        return allocatingFrames;
+    }
+
+    void report(std::ostream& out) const {
+        out << "Allocations: " << steadyAllocations << " in " << getSteadyFrames() << " frames after a "
+            << warmupFrames << " frame warm-up (" << allocatingFrames << " frames allocated)\n";
+    }
+};
@@ -0,0 +1,385 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "JobSystem.hpp"
+#include "Log.hpp"
+#include "StateStream.hpp"
+
+// ─────────────────────────────────────────────
+// AnimationLibrary Class
+// Every sprite clip the game plays, read from a text file:
+//
+//   clip <name> <loop|once|pingpong> [next <clip>]
+//   frame <image> <ticks>
+//
+// Frames follow their clip line and are shown for the given number of
+// simulation ticks. A "once" clip with a next clip hands over to it when
+// it ends, which is how short transitions (landing, turning) chain into a
+// looping state. Mirrored poses are not separate images: animators flip
+// the frame horizontally instead.
+// ─────────────────────────────────────────────
+class AnimationLibrary {
+public:
+    using ClipId = std::uint16_t;
+    static constexpr ClipId NoClip = std::numeric_limits<ClipId>::max();
+
+    enum class Loop : std::uint8_t { Loop, Once, PingPong };
+
+    struct Frame {
+        sf::FloatRect uv;               // Texture rect, filled in by resolve()
+        std::uint16_t ticks = 1;        // Simulation ticks the frame is shown
+    };
+
+    struct Clip {
+        std::uint16_t firstFrame = 0;
+        std::uint16_t frameCount = 0;
+        Loop loop = Loop::Loop;
+        ClipId next = NoClip;           // Once clips: played when this one ends
+    };
+
+private:
+    std::vector<Clip> clips;
+    std::vector<std::string> names;     // Per clip
+    std::vector<Frame> frames;
+    std::vector<std::string> images;    // Per frame, until resolved
+
+    // Drops everything added after the first clip_count clips and frame_count frames
+    void truncate(std::size_t clip_count, std::size_t frame_count) {
+        clips.resize(clip_count);
+        names.resize(clip_count);
+        frames.resize(frame_count);
+        images.resize(frame_count);
+    }
+
+    static bool parseLoop(const std::string& text, Loop& loop) {
+        if (text == "loop") loop = Loop::Loop;
+        else if (text == "once") loop = Loop::Once;
+        else if (text == "pingpong") loop = Loop::PingPong;
+        else return false;
+        return true;
+    }
+
+public:
+    // Adds a clip built in code, e.g. by tools and benchmarks
+    ClipId addClip(const std::string& name, const std::vector<Frame>& clip_frames, Loop loop = Loop::Loop) {
+        Clip clip;
+        clip.firstFrame = static_cast<std::uint16_t>(frames.size());
+        clip.frameCount = static_cast<std::uint16_t>(clip_frames.size());
+        clip.loop = loop;
+        frames.insert(frames.end(), clip_frames.begin(), clip_frames.end());
+        images.resize(frames.size());
+        clips.push_back(clip);
+        names.push_back(name);
+        return static_cast<ClipId>(clips.size() - 1);
+    }
+
+    // Reads the clip file; frame images are looked up later by resolve().
+    // A file with errors adds no clips at all.
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            LOG_ERROR << "Could not open animation file " << path;
+            return false;
+        }
+
+        const std::size_t firstLoaded = clips.size(), firstFrame = frames.size();
+        auto fail = [&]() {
+            truncate(firstLoaded, firstFrame);
+            return false;
+        };
+        std::vector<std::string> nextNames;
+        std::string line, keyword;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            std::istringstream fields(line);
+            if (!(fields >> keyword) || keyword[0] == '#')
+                continue;
+
+            if (keyword == "clip") {
+                std::string name, loopName, nextKeyword, next;
+                Loop loop;
+                if (!(fields >> name >> loopName) || !parseLoop(loopName, loop)) {
+                    LOG_ERROR << path << ":" << lineNumber << ": expected 'clip <name> <loop|once|pingpong>'";
+                    return fail();
+                }
+                if (fields >> nextKeyword >> next && nextKeyword != "next") {
+                    LOG_ERROR << path << ":" << lineNumber << ": expected 'next <clip>'";
+                    return fail();
+                }
+                addClip(name, {}, loop);
+                nextNames.push_back(next);
+            }
+            else if (keyword == "frame") {
+                std::string image;
+                unsigned int ticks = 0;
+                if (clips.size() == firstLoaded || !(fields >> image >> ticks) || ticks == 0 || ticks > 0xFFFF) {
+                    LOG_ERROR << path << ":" << lineNumber << ": expected 'frame <image> <ticks>' after a clip";
+                    return fail();
+                }
+                Frame frame;
+                frame.ticks = static_cast<std::uint16_t>(ticks);
+                frames.push_back(frame);
+                images.push_back(image);
+                clips.back().frameCount++;
+            }
+            else {
+                LOG_WARNING << path << ":" << lineNumber << ": ignoring '" << keyword << "'";
+            }
+        }
+
+        for (std::size_t i = 0; i < nextNames.size(); i++) {
+            Clip& clip = clips[firstLoaded + i];
+            if (clip.frameCount == 0) {
+                LOG_ERROR << "Animation clip '" << names[firstLoaded + i] << "' in " << path << " has no frames";
+                return fail();
+            }
+            if (!nextNames[i].empty() && (clip.next = find(nextNames[i])) == NoClip) {
+                LOG_ERROR << "Animation clip '" << names[firstLoaded + i] << "' continues with unknown clip '" << nextNames[i] << "'";
+                return fail();
+            }
+        }
+        return true;
+    }
+
+    // Every distinct frame image, e.g. to pack into the sprite atlas
+    std::vector<std::string> getImages() const {
+        std::vector<std::string> unique;
+        for (const auto& image : images) {
+            if (!image.empty() && std::find(unique.begin(), unique.end(), image) == unique.end())
+                unique.push_back(image);
+        }
+        return unique;
+    }
+
+    // Fills in every loaded frame's texture rect from rect_of(image)
+    template <typename RectLookup>
+    void resolve(RectLookup&& rect_of) {
+        for (std::size_t i = 0; i < frames.size(); i++) {
+            if (images[i].empty())
+                continue;
+            sf::IntRect rect = rect_of(images[i]);
+            if (rect.width == 0)
+                LOG_WARNING << "Animation frame " << images[i] << " is not in the sprite atlas";
+            frames[i].uv = sf::FloatRect(rect);
+        }
+    }
+
+    ClipId find(const std::string& name) const {
+        auto it = std::find(names.begin(), names.end(), name);
+        return it != names.end() ? static_cast<ClipId>(it - names.begin()) : NoClip;
+    }
+
+    // Like find(), but a missing clip is logged and replaced by an empty
+    // one, so callers always get a clip they can play
+    ClipId require(const std::string& name) {
+        ClipId clip = find(name);
+        if (clip == NoClip) {
+            LOG_ERROR << "Missing animation clip '" << name << "'";
+            clip = addClip(name, { Frame() });
+        }
+        return clip;
+    }
+
+    std::size_t getClipCount() const {
+        return clips.size();
+    }
+
+    const Clip& getClip(ClipId clip) const {
+        return clips[clip];
+    }
+
+    const Frame& getFrame(std::size_t index) const {
+        return frames[index];
+    }
+};
+
+// ─────────────────────────────────────────────
+// AnimatorSet Class
+// Playback state of many animated sprites, one small record per animator
+// in parallel arrays. Each animator is a tiny state machine: its state is
+// the clip it plays, game code switches state with play(), and "once"
+// clips move on to their next clip by themselves. update() advances the
+// whole set by one simulation tick in a single pass, split across the job
+// system when it is large. Animators count down the ticks left on their
+// frame and still poses are flagged as finished, so a tick only looks at
+// the clip table when a frame actually changes and hundreds of animated
+// enemies cost one tight loop.
+// ─────────────────────────────────────────────
+class AnimatorSet {
+public:
+    using Id = std::uint32_t;
+
+    enum Flags : std::uint8_t {
+        FlipX = 1 << 0,         // Mirror the frame horizontally
+        Reverse = 1 << 1,       // Ping-pong clip playing backwards
+        Finished = 1 << 2,      // Nothing left to play: a still pose or an ended once clip
+    };
+
+    std::vector<AnimationLibrary::ClipId> clip;
+    std::vector<std::uint16_t> frame;       // Within the clip
+    std::vector<std::uint16_t> ticks;       // Left before the next frame
+    std::vector<std::uint8_t> flags;
+
+private:
+    static constexpr std::size_t JobGrain = 4096;  // Fewer animators than this stay on the calling thread
+
+    const AnimationLibrary* library = nullptr;
+
+    std::uint16_t frameTicks(std::size_t i) const {
+        return library->getFrame(library->getClip(clip[i]).firstFrame + frame[i]).ticks;
+    }
+
+    // Starts new_clip from its first frame, keeping only the flip
+    void enter(std::size_t i, AnimationLibrary::ClipId new_clip) {
+        const AnimationLibrary::Clip& next = library->getClip(new_clip);
+        clip[i] = new_clip;
+        frame[i] = 0;
+        ticks[i] = frameTicks(i);
+        flags[i] &= FlipX;
+        if (next.frameCount < 2 && next.next == AnimationLibrary::NoClip)
+            flags[i] |= Finished;
+    }
+
+    // The current frame has been shown for its ticks
+    void nextFrame(std::size_t i) {
+        const AnimationLibrary::Clip& current = library->getClip(clip[i]);
+        switch (current.loop) {
+        case AnimationLibrary::Loop::Loop:
+            frame[i] = static_cast<std::uint16_t>((frame[i] + 1) % current.frameCount);
+            break;
+        case AnimationLibrary::Loop::Once:
+            if (frame[i] + 1 < current.frameCount)
+                frame[i]++;
+            else if (current.next != AnimationLibrary::NoClip) {
+                enter(i, current.next);
+                return;
+            }
+            else {
+                flags[i] |= Finished;
+                return;
+            }
+            break;
+        case AnimationLibrary::Loop::PingPong:
+            if (flags[i] & Reverse) {
+                if (--frame[i] == 0) flags[i] &= ~Reverse;
+            }
+            else if (++frame[i] == current.frameCount - 1)
+                flags[i] |= Reverse;
+            break;
+        }
+        ticks[i] = frameTicks(i);
+    }
+
+    void advance(std::size_t i) {
+        if (!(flags[i] & Finished) && --ticks[i] == 0)
+            nextFrame(i);
+    }
+
+public:
+    explicit AnimatorSet(const AnimationLibrary* init_library = nullptr) : library(init_library) {}
+
+    // Clips every animator refers to; must outlive the set and be set before adding
+    void setLibrary(const AnimationLibrary& clips) {
+        library = &clips;
+    }
+
+    std::size_t size() const {
+        return clip.size();
+    }
+
+    void reserve(std::size_t count) {
+        clip.reserve(count);
+        frame.reserve(count);
+        ticks.reserve(count);
+        flags.reserve(count);
+    }
+
+    void clear() {
+        clip.clear();
+        frame.clear();
+        ticks.clear();
+        flags.clear();
+    }
+
+    Id add(AnimationLibrary::ClipId start_clip, bool flip_x = false) {
+        clip.push_back(start_clip);
+        frame.push_back(0);
+        ticks.push_back(0);
+        flags.push_back(flip_x ? FlipX : 0);
+        Id id = static_cast<Id>(clip.size() - 1);
+        enter(id, start_clip);
+        return id;
+    }
+
+    // Switches to new_clip from its first frame; playing the current clip again changes nothing
+    void play(Id id, AnimationLibrary::ClipId new_clip) {
+        if (clip[id] != new_clip)
+            enter(id, new_clip);
+    }
+
+    void setFlipX(Id id, bool flip_x) {
+        flags[id] = static_cast<std::uint8_t>(flip_x ? flags[id] | FlipX : flags[id] & ~FlipX);
+    }
+
+    bool isFinished(Id id) const {
+        return flags[id] & Finished;
+    }
+
+    // Advances every animator by one simulation tick
+    void update(JobSystem* jobs = nullptr) {
+        auto body = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                advance(i);
+        };
+        if (jobs)
+            jobs->parallelFor(size(), JobGrain, body);
+        else
+            body(0, size());
+    }
+
+    // Advances only the listed animators, e.g. the entities near the view
+    template <typename Index>
+    void update(const std::vector<Index>& ids, JobSystem* jobs = nullptr) {
+        auto body = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t n = begin; n < end; n++)
+                advance(ids[n]);
+        };
+        if (jobs)
+            jobs->parallelFor(ids.size(), JobGrain, body);
+        else
+            body(0, ids.size());
+    }
+
+    // Clip, frame, countdown and flags of every animator
+    void saveState(StateWriter& writer) const {
+        writer.writeArray(clip);
+        writer.writeArray(frame);
+        writer.writeArray(ticks);
+        writer.writeArray(flags);
+    }
+
+    // Only restores a set of the same size, the one the state was saved from
+    bool loadState(StateReader& reader) {
+        std::size_t count = size();
+        return reader.readArray(clip) && reader.readArray(frame) && reader.readArray(ticks) && reader.readArray(flags) &&
+            clip.size() == count && frame.size() == count && ticks.size() == count && flags.size() == count;
+    }
+
+    // Texture rect of the current frame; a flipped frame has a negative width
+    sf::FloatRect getUV(Id id) const {
+        sf::FloatRect uv = library->getFrame(library->getClip(clip[id]).firstFrame + frame[id]).uv;
+        if (flags[id] & FlipX) {
+            uv.left += uv.width;
+            uv.width = -uv.width;
+        }
+        return uv;
+    }
+};
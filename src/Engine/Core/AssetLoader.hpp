@@ -0,0 +1,231 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include "ResourceCache.hpp"
+
+// ─────────────────────────────────────────────
+// AssetLoader Class
+// Decodes a batch of images and sounds on a pool of worker threads. Decoding
+// is pure CPU work (stb_image, Ogg/WAV readers); the GPU upload happens later
+// in upload(), which must run on the thread that owns the GL context.
+// Queue everything first, then start(); progress and per-asset futures can
+// be polled while the main thread keeps drawing a loading screen.
+// ─────────────────────────────────────────────
+class AssetLoader {
+public:
+    struct Timing {
+        std::string path;
+        float decodeSeconds = 0.f;
+        bool ok = false;
+    };
+
+private:
+    struct ImageJob {
+        std::string path;
+        sf::Image image;
+        Timing timing;
+    };
+
+    struct SoundJob {
+        std::string path;
+        std::vector<sf::Int16> samples;
+        unsigned int channelCount = 0;
+        unsigned int sampleRate = 0;
+        Timing timing;
+    };
+
+    struct AtlasJob {
+        std::string name;
+        std::vector<std::string> paths;
+    };
+
+    std::deque<ImageJob> images;            // Deques keep job addresses stable while workers write
+    std::deque<SoundJob> sounds;
+    std::vector<AtlasJob> atlasJobs;
+    std::vector<std::function<void()>> tasks;
+    std::deque<std::promise<void>> promises;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> nextTask{ 0 };
+    std::atomic<std::size_t> completed{ 0 };
+    sf::Clock wallClock;
+    float wallSeconds = 0.f;
+    bool started = false;
+    bool uploadTextures = true;
+
+    std::shared_future<void> enqueue(std::function<void()> task) {
+        promises.emplace_back();
+        std::promise<void>& promise = promises.back();
+        tasks.push_back([this, task = std::move(task), &promise]() {
+            task();
+            promise.set_value();
+            completed++;
+        });
+        return promise.get_future().share();
+    }
+
+    void workerLoop() {
+        PROFILE_THREAD_NAME("Asset loader");
+        for (std::size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+            tasks[i]();
+        }
+    }
+
+    static void decodeImage(ImageJob& job) {
+        PROFILE_ZONE("DecodeImage");
+        sf::Clock timer;
+        job.timing.ok = job.image.loadFromFile(job.path);
+        job.timing.decodeSeconds = timer.getElapsedTime().asSeconds();
+    }
+
+    static void decodeSound(SoundJob& job) {
+        PROFILE_ZONE("DecodeSound");
+        sf::Clock timer;
+        sf::InputSoundFile file;
+        if (file.openFromFile(job.path)) {
+            job.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+            job.samples.resize(static_cast<std::size_t>(file.read(job.samples.data(), job.samples.size())));
+            job.channelCount = file.getChannelCount();
+            job.sampleRate = file.getSampleRate();
+            job.timing.ok = !job.samples.empty();
+        }
+        job.timing.decodeSeconds = timer.getElapsedTime().asSeconds();
+    }
+
+    const sf::Image* findImage(const std::string& path) const {
+        for (const auto& job : images) {
+            if (job.path == path)
+                return job.timing.ok ? &job.image : nullptr;
+        }
+        return nullptr;
+    }
+
+public:
+    AssetLoader() = default;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    ~AssetLoader() {
+        wait();
+    }
+
+    std::shared_future<void> queueImage(const std::string& path) {
+        images.push_back(ImageJob{ path, sf::Image(), Timing{ path } });
+        ImageJob& job = images.back();
+        return enqueue([&job]() { decodeImage(job); });
+    }
+
+    std::shared_future<void> queueSound(const std::string& path) {
+        sounds.push_back(SoundJob{ path, {}, 0, 0, Timing{ path } });
+        SoundJob& job = sounds.back();
+        return enqueue([&job]() { decodeSound(job); });
+    }
+
+    // Queues every image of an atlas; the atlas itself is packed in upload()
+    void queueAtlas(const std::string& name, const std::vector<std::string>& paths) {
+        atlasJobs.push_back(AtlasJob{ name, paths });
+        for (const auto& path : paths) {
+            if (std::none_of(images.begin(), images.end(), [&](const ImageJob& job) { return job.path == path; }))
+                queueImage(path);
+        }
+    }
+
+    // Starts decoding on thread_count workers (0 = one per hardware thread)
+    void start(unsigned int thread_count = 0) {
+        if (started)
+            return;
+        started = true;
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        if (thread_count > tasks.size())
+            thread_count = static_cast<unsigned int>(std::max<std::size_t>(1, tasks.size()));
+
+        wallClock.restart();
+        for (unsigned int i = 0; i < thread_count; i++)
+            workers.emplace_back([this]() { workerLoop(); });
+    }
+
+    // With texture upload off, upload() packs atlas layouts but creates no
+    // textures, so headless runs never need a GL context
+    void setTextureUpload(bool enabled) {
+        uploadTextures = enabled;
+    }
+
+    // Fraction of queued assets that finished decoding, 0..1
+    float getProgress() const {
+        return tasks.empty() ? 1.f : static_cast<float>(completed.load()) / tasks.size();
+    }
+
+    bool isDone() const {
+        return completed.load() == tasks.size();
+    }
+
+    // Blocks until every queued asset is decoded
+    void wait() {
+        for (auto& worker : workers) {
+            if (worker.joinable())
+                worker.join();
+        }
+        if (started && !workers.empty()) {
+            wallSeconds = wallClock.getElapsedTime().asSeconds();
+            workers.clear();
+        }
+    }
+
+    // Uploads everything into the cache; call on the GL thread once decoding is done
+    void upload(ResourceCache& cache) {
+        start();
+        wait();
+
+        for (const auto& atlas : atlasJobs) {
+            std::vector<TextureAtlas::NamedImage> entries;
+            for (const auto& path : atlas.paths) {
+                if (const sf::Image* image = findImage(path))
+                    entries.emplace_back(path, image);
+            }
+            cache.addAtlas(atlas.name, entries, uploadTextures);
+        }
+
+        for (const auto& job : images) {
+            bool inAtlas = std::any_of(atlasJobs.begin(), atlasJobs.end(), [&](const AtlasJob& atlas) {
+                return std::find(atlas.paths.begin(), atlas.paths.end(), job.path) != atlas.paths.end();
+            });
+            if (inAtlas || !uploadTextures)
+                continue;
+            if (job.timing.ok)
+                cache.addTexture(job.path, job.image);
+            else
+                LOG_ERROR << "Failed to load texture " << job.path;
+        }
+
+        for (const auto& job : sounds) {
+            if (job.timing.ok)
+                cache.addSoundBuffer(job.path, job.samples, job.channelCount, job.sampleRate);
+            else
+                LOG_ERROR << "Failed to load sound " << job.path;
+        }
+    }
+
+    // Per-asset decode times, valid once decoding is done
+    std::vector<Timing> getTimings() const {
+        std::vector<Timing> timings;
+        for (const auto& job : images) timings.push_back(job.timing);
+        for (const auto& job : sounds) timings.push_back(job.timing);
+        return timings;
+    }
+
+    // Wall-clock time from start() until the last worker finished
+    float getWallSeconds() const {
+        return wallSeconds;
+    }
+};
@@ -0,0 +1,288 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Hash.hpp"
+#include "Log.hpp"
+#include "MappedFile.hpp"
+#include "ResourceCache.hpp"
+
+// ─────────────────────────────────────────────
+// Binary asset pack (.pak), written by tools/bake_assets
+//
+//   Header
+//   Entry[entryCount]                   sorted by name
+//   blobs from dataOffset               each 16-byte aligned
+//
+// Images and atlas pages are RGBA8 pixels, rows top to bottom; sounds are
+// interleaved 16-bit PCM; streams are the encoded file as it was on disk,
+// for music that sf::Music decodes while it plays. Atlas frames carry no
+// data, only their rect inside a page entry. Identical blobs are stored
+// once and shared. Everything is little-endian and read in place from the
+// mapping, so loading is a copy into GL or OpenAL and nothing is decoded.
+// ─────────────────────────────────────────────
+namespace AssetPack {
+    constexpr std::uint32_t Magic = 0x314B4150;     // "PAK1"
+    constexpr std::uint16_t Version = 1;
+    constexpr std::uint64_t BlobAlignment = 16;
+
+    enum Kind : std::uint32_t {
+        Image = 1,
+        Sound = 2,
+        Stream = 3,
+        AtlasPage = 4,
+        AtlasFrame = 5,
+    };
+
+    struct Header {
+        std::uint32_t magic = Magic;
+        std::uint16_t version = Version;
+        std::uint16_t reserved = 0;
+        std::uint32_t entryCount = 0;
+        std::uint32_t blobCount = 0;        // Distinct blobs after deduplication
+        std::uint64_t entryOffset = 0;
+        std::uint64_t dataOffset = 0;
+    };
+
+    struct Entry {
+        char name[96] = {};                 // Asset path, or atlas name for a page
+        std::uint32_t kind = 0;
+        std::uint32_t page = 0;             // Frames: entry index of their atlas page
+        std::uint32_t width = 0, height = 0;    // Images, pages and frames, in pixels
+        std::int32_t left = 0, top = 0;     // Frames: position inside the page
+        std::uint32_t channelCount = 0, sampleRate = 0;     // Sounds
+        std::uint64_t offset = 0, size = 0; // Blob, from the start of the file; frames have none
+    };
+
+    inline std::uint64_t alignBlob(std::uint64_t offset) {
+        return (offset + BlobAlignment - 1) & ~(BlobAlignment - 1);
+    }
+
+    // Whole pack in memory, as produced by the baking tool before writing;
+    // blobs[i] belongs to entries[i]
+    struct PackData {
+        std::vector<Entry> entries;
+        std::vector<std::vector<std::uint8_t>> blobs;
+    };
+
+    struct WriteStats {
+        std::size_t blobs = 0;              // Distinct blobs written
+        std::uint64_t bytes = 0;            // File size
+        std::uint64_t sharedBytes = 0;      // Not written again because an identical blob was
+    };
+
+    inline bool writePack(const std::string& path, PackData pack, WriteStats* stats = nullptr) {
+        if (pack.blobs.size() != pack.entries.size()) {
+            LOG_ERROR << "Invalid pack data for " << path;
+            return false;
+        }
+
+        // Sort by name, keeping each blob with its entry and frames pointing at their page
+        std::vector<std::size_t> order(pack.entries.size()), position(pack.entries.size());
+        for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&pack](std::size_t a, std::size_t b) {
+            return std::strncmp(pack.entries[a].name, pack.entries[b].name, sizeof(Entry::name)) < 0;
+        });
+        for (std::size_t i = 0; i < order.size(); i++) position[order[i]] = i;
+
+        Header header;
+        header.entryCount = static_cast<std::uint32_t>(pack.entries.size());
+        header.entryOffset = alignBlob(sizeof(Header));
+        header.dataOffset = alignBlob(header.entryOffset + sizeof(Entry) * pack.entries.size());
+
+        std::vector<Entry> entries;
+        std::vector<std::size_t> written;          // Entries whose blob is in the file, in file order
+        std::vector<std::uint64_t> hashes;
+        std::uint64_t end = header.dataOffset, shared = 0;
+        for (std::size_t i : order) {
+            Entry entry = pack.entries[i];
+            const std::vector<std::uint8_t>& blob = pack.blobs[i];
+            if (entry.kind == AtlasFrame)
+                entry.page = static_cast<std::uint32_t>(position[entry.page]);
+            entry.size = blob.size();
+            if (!blob.empty()) {
+                std::uint64_t hash = Fnv1a::hash(blob.data(), blob.size());
+                std::size_t same = 0;
+                while (same < written.size() && (hashes[same] != hash || pack.blobs[order[written[same]]] != blob))
+                    same++;
+                if (same < written.size()) {
+                    entry.offset = entries[written[same]].offset;
+                    shared += blob.size();
+                }
+                else {
+                    entry.offset = alignBlob(end);
+                    end = entry.offset + blob.size();
+                    written.push_back(entries.size());
+                    hashes.push_back(hash);
+                }
+            }
+            entries.push_back(entry);
+        }
+        header.blobCount = static_cast<std::uint32_t>(written.size());
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            LOG_ERROR << "Could not write " << path;
+            return false;
+        }
+        auto padTo = [&file](std::uint64_t offset) {
+            while (static_cast<std::uint64_t>(file.tellp()) < offset) file.put('\0');
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        padTo(header.entryOffset);
+        file.write(reinterpret_cast<const char*>(entries.data()), sizeof(Entry) * entries.size());
+        for (std::size_t w : written) {
+            padTo(entries[w].offset);
+            const std::vector<std::uint8_t>& blob = pack.blobs[order[w]];
+            file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        }
+
+        if (stats) {
+            stats->blobs = written.size();
+            stats->bytes = static_cast<std::uint64_t>(file.tellp());
+            stats->sharedBytes = shared;
+        }
+        return static_cast<bool>(file);
+    }
+}
+
+// ─────────────────────────────────────────────
+// AssetPackFile Class
+// A memory-mapped .pak file. Opening validates the header and entry table
+// only; load() then hands every entry to the resource cache straight from
+// the mapping. Streams keep pointing into it, so the pack must outlive
+// whatever plays them.
+// ─────────────────────────────────────────────
+class AssetPackFile {
+private:
+    MappedFile file;
+    const AssetPack::Entry* entries = nullptr;
+    std::size_t entryCount = 0;
+
+public:
+    bool open(const std::string& path) {
+        entries = nullptr;
+        entryCount = 0;
+        if (!file.open(path))
+            return false;
+
+        AssetPack::Header header;
+        if (file.getSize() < sizeof(header)) {
+            LOG_ERROR << "Asset pack " << path << " is truncated";
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.getData(), sizeof(header));
+        if (header.magic != AssetPack::Magic || header.version != AssetPack::Version) {
+            LOG_ERROR << "Asset pack " << path << " has an unsupported format";
+            file.close();
+            return false;
+        }
+        // Written so that no offset or count from the file can wrap the sums
+        std::uint64_t size = file.getSize();
+        auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t element) {
+            return offset <= size && count <= (size - offset) / element;
+        };
+        if (header.entryOffset % alignof(AssetPack::Entry) != 0 || !fits(header.entryOffset, header.entryCount, sizeof(AssetPack::Entry))) {
+            LOG_ERROR << "Asset pack " << path << " is truncated or damaged";
+            file.close();
+            return false;
+        }
+
+        entries = reinterpret_cast<const AssetPack::Entry*>(file.getData() + header.entryOffset);
+        entryCount = header.entryCount;
+        for (std::size_t i = 0; i < entryCount; i++) {
+            const AssetPack::Entry& entry = entries[i];
+            bool badFrame = entry.kind == AssetPack::AtlasFrame && (entry.page >= entryCount || entries[entry.page].kind != AssetPack::AtlasPage);
+            // Sounds are handed over as 16-bit samples straight from the mapping
+            bool badSound = entry.kind == AssetPack::Sound && entry.offset % alignof(sf::Int16) != 0;
+            if (!fits(entry.offset, entry.size, 1) || badSound || entry.name[sizeof(entry.name) - 1] != '\0' || badFrame) {
+                LOG_ERROR << "Asset pack " << path << " has a corrupt entry " << i;
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        file.close();
+        entries = nullptr;
+        entryCount = 0;
+    }
+
+    bool isOpen() const {
+        return file.isOpen();
+    }
+
+    std::size_t getEntryCount() const {
+        return entryCount;
+    }
+
+    const AssetPack::Entry& getEntry(std::size_t index) const {
+        return entries[index];
+    }
+
+    // Entry with the given name, or null; entries are sorted, so this is a binary search
+    const AssetPack::Entry* find(const std::string& name) const {
+        const AssetPack::Entry* end = entries + entryCount;
+        const AssetPack::Entry* it = std::lower_bound(entries, end, name, [](const AssetPack::Entry& entry, const std::string& key) {
+            return std::strncmp(entry.name, key.c_str(), sizeof(entry.name)) < 0;
+        });
+        return it != end && name == it->name ? it : nullptr;
+    }
+
+    const std::uint8_t* getData(const AssetPack::Entry& entry) const {
+        return file.getData() + entry.offset;
+    }
+
+    // Puts every entry into the cache: atlases (layout only when textures
+    // are off), images when textures are on, sounds when sounds are on, and
+    // streams always. Returns how many entries were loaded.
+    std::size_t load(ResourceCache& cache, bool upload_textures, bool load_sounds) const {
+        std::size_t loaded = 0;
+        for (std::size_t i = 0; i < entryCount; i++) {
+            const AssetPack::Entry& entry = entries[i];
+            switch (entry.kind) {
+                case AssetPack::AtlasPage: {
+                    std::vector<std::pair<std::string, sf::IntRect>> frames;
+                    for (std::size_t f = 0; f < entryCount; f++) {
+                        const AssetPack::Entry& frame = entries[f];
+                        if (frame.kind == AssetPack::AtlasFrame && frame.page == i)
+                            frames.emplace_back(frame.name, sf::IntRect(frame.left, frame.top, frame.width, frame.height));
+                    }
+                    cache.addAtlas(entry.name, getData(entry), sf::Vector2u(entry.width, entry.height), frames, upload_textures);
+                    loaded += frames.size() + 1;
+                    break;
+                }
+                case AssetPack::Image:
+                    if (!upload_textures)
+                        continue;
+                    cache.addTexture(entry.name, getData(entry), sf::Vector2u(entry.width, entry.height));
+                    loaded++;
+                    break;
+                case AssetPack::Sound:
+                    if (!load_sounds)
+                        continue;
+                    cache.addSoundBuffer(entry.name, reinterpret_cast<const sf::Int16*>(getData(entry)),
+                        static_cast<std::size_t>(entry.size / sizeof(sf::Int16)), entry.channelCount, entry.sampleRate);
+                    loaded++;
+                    break;
+                case AssetPack::Stream:
+                    cache.addStream(entry.name, getData(entry), static_cast<std::size_t>(entry.size));
+                    loaded++;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return loaded;
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include "StateStream.hpp"
+
+// ─────────────────────────────────────────────
+// Camera Class
+// Scrolls the world by moving one sf::View per parallax layer instead of
+// moving the objects themselves. Objects keep fixed world coordinates, so a
+// scroll step costs the same no matter how long the level is.
+// ─────────────────────────────────────────────
+class Camera {
+private:
+    struct Layer {
+        float scrollFactor;     // 0 = pinned to the screen, 1 = moves with the world
+        sf::View view;
+    };
+
+    sf::Vector2f viewSize;
+    float scrollX = 0.f;        // World x of the left screen edge
+    float previousScrollX = 0.f;    // Scroll at the start of the current simulation step
+    bool bounded = false;       // Until setBounds()
+    float minScroll = 0.f;
+    float maxScroll = 0.f;
+    std::vector<Layer> layers;
+
+    void updateLayer(Layer& layer, float x) const {
+        layer.view.setCenter(viewSize.x / 2.f + x * layer.scrollFactor, viewSize.y / 2.f);
+    }
+
+public:
+    Camera() = default;
+    Camera(sf::Vector2f init_view_size) : viewSize(init_view_size) {}
+
+    // Adds a parallax layer and returns its index
+    std::size_t addLayer(float scroll_factor) {
+        Layer layer{ scroll_factor, sf::View(sf::FloatRect(0.f, 0.f, viewSize.x, viewSize.y)) };
+        updateLayer(layer, scrollX);
+        layers.push_back(layer);
+        return layers.size() - 1;
+    }
+
+    // Limits the scroll range, e.g. to the level length minus one screen; a
+    // max_scroll below min_scroll (a level no wider than the screen) pins it at min_scroll
+    void setBounds(float min_scroll, float max_scroll) {
+        bounded = true;
+        minScroll = min_scroll;
+        maxScroll = max_scroll;
+        setScroll(scrollX);
+    }
+
+    void setScroll(float x) {
+        if (bounded)
+            x = std::clamp(x, minScroll, std::max(maxScroll, minScroll));
+        scrollX = x;
+        for (auto& layer : layers) updateLayer(layer, scrollX);
+    }
+
+    void scroll(float dx) {
+        setScroll(scrollX + dx);
+    }
+
+    float getScroll() const {
+        return scrollX;
+    }
+
+    // Remembers the scroll before a simulation step for render interpolation
+    void beginTick() {
+        previousScrollX = scrollX;
+    }
+
+    // Scroll and previous scroll; the views follow on the next interpolate()
+    void saveState(StateWriter& writer) const {
+        writer.write(scrollX);
+        writer.write(previousScrollX);
+    }
+
+    bool loadState(StateReader& reader) {
+        float x = 0.f, previous = 0.f;
+        if (!reader.read(x) || !reader.read(previous))
+            return false;
+        setScroll(x);
+        previousScrollX = previous;
+        return true;
+    }
+
+    // Places every view between the previous and current scroll
+    void interpolate(float alpha) {
+        float x = previousScrollX + (scrollX - previousScrollX) * alpha;
+        for (auto& layer : layers) updateLayer(layer, x);
+    }
+
+    const sf::View& getView(std::size_t layer) const {
+        return layers[layer].view;
+    }
+
+    // Converts a screen-space x into world x for the given layer
+    float toWorldX(float screen_x, std::size_t layer) const {
+        return screen_x + scrollX * layers[layer].scrollFactor;
+    }
+
+    // World rectangle a layer's view shows, grown by margin on every side
+    sf::FloatRect getVisibleRect(std::size_t layer, float margin = 0.f) const {
+        const sf::View& view = layers[layer].view;
+        sf::Vector2f size = view.getSize() + sf::Vector2f(2.f * margin, 2.f * margin);
+        return sf::FloatRect(view.getCenter() - size / 2.f, size);
+    }
+};
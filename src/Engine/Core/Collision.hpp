@@ -0,0 +1,215 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// ─────────────────────────────────────────────
+// CollisionGrid Class
+// Dense tile occupancy for a level: one bitset per row, built once from the
+// level file. Box queries walk only the tiles a box overlaps (a whole 64-tile
+// word at a time along a row), so there is no hashing and fractional
+// positions are handled exactly.
+// ─────────────────────────────────────────────
+class CollisionGrid {
+public:
+    struct Contacts {
+        bool ground = false;        // Solid directly below the box
+        bool ceiling = false;       // Solid directly above the box
+        bool wallLeft = false;
+        bool wallRight = false;
+    };
+
+    struct SweepResult {
+        sf::Vector2f position;      // Top-left corner after resolving the move
+        Contacts contacts;
+    };
+
+private:
+    static constexpr float Epsilon = 1e-3f;
+
+    unsigned int columns = 0;
+    unsigned int rows = 0;
+    std::size_t wordsPerRow = 0;
+    sf::Vector2f origin;            // World position of tile (0, 0)
+    sf::Vector2f tileSize{ 50.f, 50.f };
+    std::vector<std::uint64_t> bits;
+
+    int columnAt(float x) const {
+        return static_cast<int>(std::floor((x - origin.x) / tileSize.x));
+    }
+
+    int rowAt(float y) const {
+        return static_cast<int>(std::floor((y - origin.y) / tileSize.y));
+    }
+
+    // Any solid tile in row between columns c0..c1 (inclusive)?
+    bool rowSpanSolid(int row, int c0, int c1) const {
+        if (row < 0 || row >= static_cast<int>(rows)) return false;
+        if (c0 < 0) c0 = 0;
+        if (c1 >= static_cast<int>(columns)) c1 = static_cast<int>(columns) - 1;
+        if (c0 > c1) return false;
+
+        const std::uint64_t* words = &bits[static_cast<std::size_t>(row) * wordsPerRow];
+        std::size_t w0 = static_cast<std::size_t>(c0) >> 6, w1 = static_cast<std::size_t>(c1) >> 6;
+        std::uint64_t firstMask = ~0ull << (c0 & 63);
+        std::uint64_t lastMask = ~0ull >> (63 - (c1 & 63));
+
+        if (w0 == w1)
+            return (words[w0] & firstMask & lastMask) != 0;
+        if (words[w0] & firstMask)
+            return true;
+        for (std::size_t w = w0 + 1; w < w1; w++) {
+            if (words[w])
+                return true;
+        }
+        return (words[w1] & lastMask) != 0;
+    }
+
+    // Any solid tile in column between rows r0..r1 (inclusive)?
+    bool columnSpanSolid(int column, int r0, int r1) const {
+        if (r0 < 0) r0 = 0;
+        if (r1 >= static_cast<int>(rows)) r1 = static_cast<int>(rows) - 1;
+        for (int row = r0; row <= r1; row++) {
+            if (isSolid(column, row))
+                return true;
+        }
+        return false;
+    }
+
+public:
+    CollisionGrid() = default;
+
+    CollisionGrid(unsigned int init_columns, unsigned int init_rows, sf::Vector2f init_origin, sf::Vector2f init_tile_size) {
+        resize(init_columns, init_rows, init_origin, init_tile_size);
+    }
+
+    // Resets the grid to the given dimensions; every tile becomes empty
+    void resize(unsigned int new_columns, unsigned int new_rows, sf::Vector2f new_origin, sf::Vector2f new_tile_size) {
+        columns = new_columns;
+        rows = new_rows;
+        origin = new_origin;
+        tileSize = new_tile_size;
+        wordsPerRow = (static_cast<std::size_t>(columns) + 63) / 64;
+        bits.assign(wordsPerRow * rows, 0);
+    }
+
+    void setSolid(int column, int row, bool solid) {
+        if (column < 0 || row < 0 || column >= static_cast<int>(columns) || row >= static_cast<int>(rows))
+            return;
+        std::uint64_t& word = bits[static_cast<std::size_t>(row) * wordsPerRow + (column >> 6)];
+        std::uint64_t mask = 1ull << (column & 63);
+        word = solid ? (word | mask) : (word & ~mask);
+    }
+
+    // Tiles outside the grid are treated as empty (open sky, bottomless pits)
+    bool isSolid(int column, int row) const {
+        if (column < 0 || row < 0 || column >= static_cast<int>(columns) || row >= static_cast<int>(rows))
+            return false;
+        return (bits[static_cast<std::size_t>(row) * wordsPerRow + (column >> 6)] >> (column & 63)) & 1ull;
+    }
+
+    unsigned int getColumns() const { return columns; }
+    unsigned int getRows() const { return rows; }
+    sf::Vector2f getOrigin() const { return origin; }
+    sf::Vector2f getTileSize() const { return tileSize; }
+
+    // Does the box overlap any solid tile?
+    bool overlapsSolid(const sf::FloatRect& box) const {
+        int c0 = columnAt(box.left), c1 = columnAt(box.left + box.width - Epsilon);
+        int r0 = rowAt(box.top), r1 = rowAt(box.top + box.height - Epsilon);
+        if (r0 < 0) r0 = 0;
+        if (r1 >= static_cast<int>(rows)) r1 = static_cast<int>(rows) - 1;
+        for (int row = r0; row <= r1; row++) {
+            if (rowSpanSolid(row, c0, c1))
+                return true;
+        }
+        return false;
+    }
+
+    // Reports which sides of the box are touching solid tiles
+    Contacts probe(const sf::FloatRect& box) const {
+        Contacts contacts;
+        contacts.ground = overlapsSolid(sf::FloatRect(box.left, box.top + box.height, box.width, 1.f));
+        contacts.ceiling = overlapsSolid(sf::FloatRect(box.left, box.top - 1.f, box.width, 1.f));
+        contacts.wallLeft = overlapsSolid(sf::FloatRect(box.left - 1.f, box.top, 1.f, box.height));
+        contacts.wallRight = overlapsSolid(sf::FloatRect(box.left + box.width, box.top, 1.f, box.height));
+        return contacts;
+    }
+
+    // Moves the box by delta, x axis first then y, stopping flush against the
+    // first solid tile on each axis. Only tiles the box sweeps across are visited.
+    SweepResult sweep(const sf::FloatRect& box, sf::Vector2f delta) const {
+        SweepResult result;
+        sf::FloatRect moved = box;
+
+        if (delta.x != 0.f) {
+            int r0 = rowAt(moved.top), r1 = rowAt(moved.top + moved.height - Epsilon);
+            float target = moved.left + delta.x;
+            if (delta.x > 0.f) {
+                int from = columnAt(moved.left + moved.width), to = columnAt(target + moved.width - Epsilon);
+                if (from < 0) from = 0;
+                if (to >= static_cast<int>(columns)) to = static_cast<int>(columns) - 1;
+                for (int column = from; column <= to; column++) {
+                    if (columnSpanSolid(column, r0, r1)) {
+                        target = origin.x + column * tileSize.x - moved.width;
+                        result.contacts.wallRight = true;
+                        break;
+                    }
+                }
+            }
+            else {
+                int from = columnAt(moved.left - Epsilon), to = columnAt(target);
+                if (from >= static_cast<int>(columns)) from = static_cast<int>(columns) - 1;
+                if (to < 0) to = 0;
+                for (int column = from; column >= to; column--) {
+                    if (columnSpanSolid(column, r0, r1)) {
+                        target = origin.x + (column + 1) * tileSize.x;
+                        result.contacts.wallLeft = true;
+                        break;
+                    }
+                }
+            }
+            moved.left = target;
+        }
+
+        if (delta.y != 0.f) {
+            int c0 = columnAt(moved.left), c1 = columnAt(moved.left + moved.width - Epsilon);
+            float target = moved.top + delta.y;
+            if (delta.y > 0.f) {
+                int from = rowAt(moved.top + moved.height), to = rowAt(target + moved.height - Epsilon);
+                if (from < 0) from = 0;
+                if (to >= static_cast<int>(rows)) to = static_cast<int>(rows) - 1;
+                for (int row = from; row <= to; row++) {
+                    if (rowSpanSolid(row, c0, c1)) {
+                        target = origin.y + row * tileSize.y - moved.height;
+                        result.contacts.ground = true;
+                        break;
+                    }
+                }
+            }
+            else {
+                int from = rowAt(moved.top - Epsilon), to = rowAt(target);
+                if (from >= static_cast<int>(rows)) from = static_cast<int>(rows) - 1;
+                if (to < 0) to = 0;
+                for (int row = from; row >= to; row--) {
+                    if (rowSpanSolid(row, c0, c1)) {
+                        target = origin.y + (row + 1) * tileSize.y;
+                        result.contacts.ceiling = true;
+                        break;
+                    }
+                }
+            }
+            moved.top = target;
+        }
+
+        Contacts resting = probe(moved);
+        result.contacts.ground |= resting.ground;
+        result.contacts.ceiling |= resting.ceiling;
+        result.contacts.wallLeft |= resting.wallLeft;
+        result.contacts.wallRight |= resting.wallRight;
+        result.position = sf::Vector2f(moved.left, moved.top);
+        return result;
+    }
+};
@@ -0,0 +1,264 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Collision.hpp"
+#include "Entities.hpp"
+#include "JobSystem.hpp"
+
+// ─────────────────────────────────────────────
+// EnemySystem Class
+// Walking enemies on top of the entity store: the store keeps their
+// transform, velocity and sprite, this system adds a state per entity and
+// the rules that act on them. Every tick, for the active entities only:
+//
+//   applyGravity()    before the store's motion system
+//   resolveTerrain()  after it: slides each move against the tile grid,
+//                     turns at walls and at ledges
+//   resolvePairs()    sort-and-sweep broadphase along x, so overlapping
+//                     walkers bounce apart in O(n log n) instead of O(n^2)
+//   touchPlayer()     stomp or hurt against the player's box
+//
+// Terrain is independent per enemy and may run on the job system; pairs
+// and the player touch both ends of a contact, so they stay serial and the
+// result does not depend on the thread count.
+// ─────────────────────────────────────────────
+class EnemySystem {
+public:
+    using Entity = EntityStore::Entity;
+
+    enum State : std::uint8_t { None, Walking, Stomped, Dead };
+    enum class Contact : std::uint8_t { None, Stomp, Hurt };
+
+    struct Stats {
+        std::size_t walking = 0;            // Across the whole level
+        std::size_t stomped = 0;            // So far, including squashed ones still shown
+        std::size_t pairsTested = 0;        // Broadphase candidates in the last resolvePairs()
+        std::size_t pairsTouching = 0;      // Of which actually overlapped
+    };
+
+    float gravity = 980.f;
+    float maxFallSpeed = 1500.f;
+    float stompTolerance = 12.f;            // How far below an enemy's top a stomping player may already be
+    std::uint16_t squashTicks = 50;         // A stomped enemy stays visible this long
+
+    // Per entity; None for entities that are not enemies
+    std::vector<std::uint8_t> state;
+    std::vector<std::uint16_t> timer;
+
+private:
+    static constexpr std::size_t JobGrain = 1024;   // Fewer enemies than this stay on the calling thread
+    static constexpr float FallLimit = 400.f;       // Below the grid by this much, an enemy is gone
+
+    std::vector<Entity> order;              // Active walkers sorted by left edge, reused every tick
+    std::vector<std::pair<Entity, Entity>> touching;    // Overlapping pairs found this tick, left one first
+    std::vector<std::uint8_t> turned;       // Per entity, set when terrain turned it this tick
+    Stats stats;
+
+    static sf::FloatRect boxOf(const EntityStore& store, Entity i) {
+        return sf::FloatRect(store.posX[i], store.posY[i], store.width[i], store.height[i]);
+    }
+
+    static void face(EntityStore& store, Entity i, float direction) {
+        float speed = store.velX[i] < 0.f ? -store.velX[i] : store.velX[i];
+        store.velX[i] = direction < 0.f ? -speed : speed;
+        store.animators.setFlipX(i, direction > 0.f);
+    }
+
+    // Sweeps one enemy from where the motion system started it to where it
+    // put it, then decides whether it keeps walking that way
+    void settle(EntityStore& store, const CollisionGrid& grid, Entity i) {
+        turned[i] = 0;
+        sf::FloatRect previous(store.prevX[i], store.prevY[i], store.width[i], store.height[i]);
+
+        // The grid only covers the streamed window; enemies outside it wait
+        float gridLeft = grid.getOrigin().x, gridRight = gridLeft + grid.getColumns() * grid.getTileSize().x;
+        if (previous.left < gridLeft || previous.left + previous.width > gridRight) {
+            store.posX[i] = store.prevX[i];
+            store.posY[i] = store.prevY[i];
+            store.velY[i] = 0.f;
+            return;
+        }
+
+        sf::Vector2f delta(store.posX[i] - previous.left, store.posY[i] - previous.top);
+        CollisionGrid::SweepResult result = grid.sweep(previous, delta);
+        store.posX[i] = result.position.x;
+        store.posY[i] = result.position.y;
+        if (result.contacts.ground && store.velY[i] > 0.f)
+            store.velY[i] = 0.f;
+
+        float direction = store.velX[i];
+        bool blocked = (direction < 0.f && result.contacts.wallLeft) || (direction > 0.f && result.contacts.wallRight);
+        bool ledge = false;
+        if (result.contacts.ground && direction != 0.f) {
+            // One pixel past the leading foot, just below the feet
+            float probeX = direction < 0.f ? result.position.x - 1.f : result.position.x + store.width[i];
+            ledge = !grid.overlapsSolid(sf::FloatRect(probeX, result.position.y + store.height[i], 1.f, 1.f));
+        }
+        if (blocked || ledge) {
+            face(store, i, -direction);
+            turned[i] = 1;
+        }
+    }
+
+public:
+    // Marks entity as a walking enemy; its velocity sets its walking speed
+    void add(const EntityStore& store, Entity entity) {
+        if (store.size() > state.size()) {
+            state.resize(store.size(), None);
+            timer.resize(store.size(), 0);
+            turned.resize(store.size(), 0);
+        }
+        state[entity] = Walking;
+        stats.walking++;
+    }
+
+    bool isEnemy(Entity entity) const {
+        return entity < state.size() && state[entity] != None;
+    }
+
+    // Before the store's motion system: falling speeds up
+    void applyGravity(EntityStore& store, float dt) {
+        for (Entity i : store.getActive()) {
+            if (!isEnemy(i) || state[i] != Walking)
+                continue;
+            store.velY[i] = std::min(store.velY[i] + gravity * dt, maxFallSpeed);
+        }
+    }
+
+    // After the store's motion system: resolves every active walker against
+    // the tiles, turns the ones that hit a wall or reached a ledge, and
+    // counts down squashed enemies
+    void resolveTerrain(EntityStore& store, const CollisionGrid& grid, JobSystem* jobs = nullptr) {
+        const std::vector<Entity>& active = store.getActive();
+        auto body = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t n = begin; n < end; n++) {
+                Entity i = active[n];
+                if (isEnemy(i) && state[i] == Walking)
+                    settle(store, grid, i);
+            }
+        };
+        if (jobs)
+            jobs->parallelFor(active.size(), JobGrain, body);
+        else
+            body(0, active.size());
+
+        float killLine = grid.getOrigin().y + grid.getRows() * grid.getTileSize().y + FallLimit;
+        for (Entity i : active) {
+            if (!isEnemy(i))
+                continue;
+            if (state[i] == Walking && store.posY[i] > killLine) {
+                state[i] = Dead;
+                stats.walking--;
+                store.despawn(i);
+            }
+            else if (state[i] == Stomped && --timer[i] == 0) {
+                state[i] = Dead;
+                store.despawn(i);
+            }
+            else if (state[i] == Walking)
+                store.refile(i);
+        }
+    }
+
+    // Walkers that overlap push apart and both turn away from each other.
+    // Candidates come from sorting the active walkers by left edge and
+    // sweeping: a pair is only tested while the next box starts before the
+    // current one ends, so sparse crowds cost little more than the sort.
+    // Every pair is found first and resolved after, in sorted order. A push
+    // moves boxes that later pairs measure their overlap from, so the result
+    // does depend on that order; it is the same every run because the order
+    // is fixed by position and id.
+    void resolvePairs(EntityStore& store) {
+        order.clear();
+        for (Entity i : store.getActive()) {
+            if (isEnemy(i) && state[i] == Walking)
+                order.push_back(i);
+        }
+        // Ties broken by id so the order, and the outcome, never depends on the active set's order
+        std::sort(order.begin(), order.end(), [&store](Entity a, Entity b) {
+            return store.posX[a] < store.posX[b] || (store.posX[a] == store.posX[b] && a < b);
+        });
+
+        stats.pairsTested = 0;
+        touching.clear();
+        for (std::size_t n = 0; n < order.size(); n++) {
+            Entity a = order[n];
+            float right = store.posX[a] + store.width[a];
+            for (std::size_t m = n + 1; m < order.size() && store.posX[order[m]] < right; m++) {
+                Entity b = order[m];
+                stats.pairsTested++;
+                if (store.posY[a] < store.posY[b] + store.height[b] && store.posY[b] < store.posY[a] + store.height[a])
+                    touching.emplace_back(a, b);
+            }
+        }
+        stats.pairsTouching = touching.size();
+
+        // a is left of b: push them apart evenly, then a walks left and b right
+        for (const auto& [a, b] : touching) {
+            float overlapX = std::min(store.posX[a] + store.width[a] - store.posX[b], store.width[b]);
+            if (overlapX > 0.f) {
+                store.posX[a] -= overlapX * 0.5f;
+                store.posX[b] += overlapX * 0.5f;
+            }
+            if (!turned[a]) face(store, a, -1.f);
+            if (!turned[b]) face(store, b, 1.f);
+        }
+        for (Entity i : order) store.refile(i);
+    }
+
+    // Checks the player's box against the active walkers. Landing on top
+    // (the player's feet were above the enemy's head at the start of the
+    // tick) squashes the enemy; any other overlap hurts the player.
+    Contact touchPlayer(EntityStore& store, const sf::FloatRect& player, float previous_bottom) {
+        Contact contact = Contact::None;
+        for (Entity i : store.getActive()) {
+            if (!isEnemy(i) || state[i] != Walking || !player.intersects(boxOf(store, i)))
+                continue;
+            if (previous_bottom <= store.posY[i] + stompTolerance) {
+                stomp(store, i);
+                contact = Contact::Stomp;
+            }
+            else if (contact == Contact::None)
+                contact = Contact::Hurt;
+        }
+        return contact;
+    }
+
+    // Flattens a walker; it stops and disappears after squashTicks
+    void stomp(EntityStore& store, Entity i) {
+        state[i] = Stomped;
+        timer[i] = squashTicks;
+        stats.walking--;
+        stats.stomped++;
+        float squashed = store.height[i] * 0.4f;
+        store.posY[i] += store.height[i] - squashed;
+        store.prevY[i] = store.posY[i];
+        store.height[i] = squashed;
+        store.velX[i] = 0.f;
+        store.velY[i] = 0.f;
+        store.refile(i);
+    }
+
+    // Enemy state and squash timers, plus the walking/stomped counts; the
+    // broadphase scratch is rebuilt every tick
+    void saveState(StateWriter& writer) const {
+        writer.writeArray(state);
+        writer.writeArray(timer);
+        writer.write(stats.walking);
+        writer.write(stats.stomped);
+    }
+
+    bool loadState(StateReader& reader) {
+        std::size_t count = state.size();
+        return reader.readArray(state) && reader.readArray(timer) && reader.read(stats.walking) && reader.read(stats.stomped) &&
+            state.size() == count && timer.size() == count;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
@@ -3,124 +3,82 @@
 #include <iostream>
 #include <ctime>
 #include <stdlib.h>
+#include <cstdlib>
 #include <fstream>
-#include <unordered_set>
 #include <vector>
 #include <string>
 #include <memory>
-#include <chrono>
-#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include "TileMap.hpp"
+#include "Camera.hpp"
+#include "FixedTimestep.hpp"
+#include "Collision.hpp"
+#include "ResourceCache.hpp"
+#include "AssetLoader.hpp"
+#include "AssetPack.hpp"
+#include "Animation.hpp"
+#include "Entities.hpp"
+#include "Enemies.hpp"
+#include "LevelFormat.hpp"
+#include "LevelStreamer.hpp"
+#include "LevelSource.hpp"
+#include "FileWatcher.hpp"
+#include "Hash.hpp"
+#include "ParallaxLayer.hpp"
+#include "Particles.hpp"
+#include "RenderThread.hpp"
+#include "Rollback.hpp"
+#include "NetPeer.hpp"
+#include "StateStream.hpp"
+#include "Rewind.hpp"
+#include "AllocationCounter.hpp"
+#include "Input.hpp"
+#include "JobSystem.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include "StatsOverlay.hpp"
 
 // ─────────────────────────────────────────────
-// GroundBrick Class
-// Handles creation of brick objects using shared textures for memory efficiency.
+// Sprite atlas
+// Every sprite frame the game draws, packed into one texture at startup:
+// the still images below plus every frame of the animation clips.
 // ─────────────────────────────────────────────
-class GroundBrick {
-private:
-    inline static std::shared_ptr<sf::Texture> shared_brick_texture; // Shared texture among all bricks
-
-public:
-    std::unordered_set<int> empty;
-public:
-    GroundBrick() {
-        // Load texture only once using static shared pointer
-        if (!shared_brick_texture) {
-            shared_brick_texture = std::make_shared<sf::Texture>();
-            if (!shared_brick_texture->loadFromFile("assets/img/brick-1.png")) {
-                std::cerr << "Failed to load brick texture\n";
-            }
-        }
-    }
-
-    // Returns a shared_ptr to a brick rectangle shape with texture applied
-    std::shared_ptr<sf::RectangleShape> getObj() {
-        auto brick_frame = std::make_shared<sf::RectangleShape>(sf::Vector2f(50.f, 50.f));
-        brick_frame->setTexture(shared_brick_texture.get());
-        return brick_frame;
-    }
-};
-
-class Cloud {
-private:
-    sf::RectangleShape cloud;
-    sf::Texture cloudTexture;
-
-public:
-    Cloud() = default;
-    Cloud(sf::Vector2f init_position, sf::Vector2f init_size) {
-        cloud.setPosition(init_position);
-        cloud.setSize(init_size);
-
-        // Loading the cloud image
-        cloudTexture.loadFromFile("assets/img/cloud.png");
-        cloud.setTexture(&cloudTexture);
-    }
-
-    sf::RectangleShape &getObj() {
-        return cloud;
+namespace SpriteAssets {
+    const std::string brick = "assets/img/brick-1.png";
+    const std::string cloud = "assets/img/cloud.png";
+    const std::string bush = "assets/img/bush.png";
+    const std::string animations = "assets/anim/clips.dat";
+
+    // Image a level's parallax layers use for decorations of the given kind
+    inline std::string decoration(const std::string& kind) {
+        return "assets/img/" + kind + ".png";
     }
-};
 
-
-class Gomma {
-private:
-    sf::RectangleShape gomma;
-    sf::Texture gommaTexture;
-    std::vector<sf::Texture> gifTextures;
-    size_t currentFrame = 0;                                                // Current frame for animation
-    sf::Clock animationClock, clock;
-    float frameDuration = 0.01f;
-
-public:
-    Gomma() = default;
-    Gomma(sf::Vector2f init_position, sf::Vector2f init_size) {
-        gomma.setPosition(init_position);
-        gomma.setSize(init_size);
-
-        for (int i = 1; i < 3; i++) {
-            gommaTexture.loadFromFile("assets/img/gomma/gomma-" + std::to_string(i) + ".png");
-            gifTextures.push_back(std::move(gommaTexture));
+    inline std::vector<std::string> all(const AnimationLibrary& clips) {
+        std::vector<std::string> paths = { brick, cloud, bush };
+        for (const auto& image : clips.getImages()) {
+            if (std::find(paths.begin(), paths.end(), image) == paths.end())
+                paths.push_back(image);
         }
+        return paths;
     }
+}
 
-    sf::RectangleShape& getObj() {
-        return gomma;
-    }
-
-    void auto_move() {
-        if (animationClock.getElapsedTime().asSeconds() > frameDuration) {
-            currentFrame = (currentFrame + 1) % gifTextures.size();
-            if (gomma.getPosition().x > -200.f) {
-                gomma.setPosition(gomma.getPosition().x - 10.f, gomma.getPosition().y);
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(30));
-            gomma.setTexture(&gifTextures[currentFrame]);
-            animationClock.restart();
-        }
-    }
-};
-
-class Bush {
-private:
-    sf::RectangleShape bush;
-    sf::Texture bushTexture;
-
-public:
-    Bush() = default;
-    Bush(sf::Vector2f init_position, sf::Vector2f init_size) {
-        bush.setPosition(init_position);
-        bush.setSize(init_size);
-
-        // Loading the cloud image
-        bushTexture.loadFromFile("assets/img/bush.png");
-        bush.setTexture(&bushTexture);
-    }
+// ─────────────────────────────────────────────
+// Level files
+// The game maps the binary level; with --watch, edits to the text sources
+// it is converted from are converted again while the game runs.
+// ─────────────────────────────────────────────
+namespace LevelAssets {
+    const std::string binary = "assets/level/Level0.lvl";
+    const std::string bricks = "assets/level/Level0-brick.dat";
+    const std::string entities = "assets/level/Level0-entities.dat";
+    const std::string parallax = "assets/level/Level0-parallax.dat";
+}
 
-    sf::RectangleShape& getObj() {
-        return bush;
-    }
-};
 // ──────────────────────────────────────────
 // Mario Class
 // Represents the Mario character including rendering, animation, and jumping.
@@ -128,13 +86,13 @@ public:
 class Mario {
 private:
     sf::RectangleShape mario;                                               // Mario's visible rectangle
-    sf::Texture mario_texture, mario_jump_texture, mario_backward_texture, mario_jump_texture_backward, gomma_texture;  // Texture for running and jumping
-    std::vector<sf::Texture> gifTextures, gifTextureBackward;               // Animation frames
-    sf::Sprite sprite1;
+    AnimatorSet* animators = nullptr;                                       // Set his animator is advanced with
+    AnimatorSet::Id animator = 0;
+    AnimationLibrary::ClipId idleClip = 0, runClip = 0, jumpClip = 0;
     unsigned int id;                                                        // Object identifier
-    size_t currentFrame = 0;                                                // Current frame for animation
-    sf::Clock animationClock, clock;                                        // Clocks for timing animations and jumping
-    float frameDuration = 0.01f;                                            // Duration of each animation frame (in seconds)
+    float runSpeed = 500.f;                                                 // Screen-space run speed (pixels per second)
+    float screenAnchorX = 390.f;                                            // Where Mario settles while the world scrolls
+    sf::Vector2f previousPosition;                                          // Position at the start of the tick
     float vy = 0.1f;       
     float fall_vy = 0.1f;// Vertical velocity
     float gravity = 980.0f;                                                 // Gravitational acceleration
@@ -153,62 +111,92 @@ public:
 public:
     Mario() = default;
 
-    // Initialize Mario with a unique ID and prepare textures
-    Mario(unsigned int obj_id) {
+    // Everything a tick changes, for rollback and snapshots; the sprite's
+    // frame comes back with the animator set
+    struct State {
+        sf::Vector2f position, previousPosition;
+        float vy, fall_vy, vx;
+        bool isJumping, isHighJump, isJumpingBackward, isFalling;
+    };
+
+    // Initialize Mario with a unique ID and an animator in the given set
+    Mario(unsigned int obj_id, const TextureAtlas& atlas, AnimationLibrary& library, AnimatorSet& set, float start_x = 390.f) {
         id = obj_id;
 
         mario.setSize(sf::Vector2f(75.f, 75.f));
-        mario.setPosition(sf::Vector2f(390.f, 480.f));
-        mario_jump_texture.loadFromFile("assets/img/mario/mario-jump.png");
-        mario_jump_texture_backward.loadFromFile("assets/img/mario/mario-jump-rev.png");
-
-        // Load running animation frames
-        for (int i = 0; i < 5; i++) {
-            mario_texture.loadFromFile("assets/img/mario-char/mario-" + std::to_string(i) + "_resized.png");
-            gifTextures.push_back(std::move(mario_texture));
-        }
+        mario.setPosition(sf::Vector2f(start_x, 480.f));
+        previousPosition = mario.getPosition();
+        if (atlas.hasTexture())
+            mario.setTexture(&atlas.getTexture());
 
-        // loading backward running animation frames
-        for (int i = 0; i < 5; i++) {
-            mario_backward_texture.loadFromFile("assets/img/mario-char/mario-" + std::to_string(i) + "-rev_resized.png");
-            gifTextureBackward.push_back(std::move(mario_backward_texture));
-        }
+        animators = &set;
+        idleClip = library.require("mario-idle");
+        runClip = library.require("mario-run");
+        jumpClip = library.require("mario-jump");
+        animator = set.add(idleClip);
 
         stand(); // Set initial standing frame
+        syncSprite();
+    }
+
+    // Plays clip (or the jump clip while in the air), facing left when backward
+    void pose(AnimationLibrary::ClipId clip, bool backward) {
+        animators->play(animator, isJumping ? jumpClip : clip);
+        animators->setFlipX(animator, backward);
     }
 
     // Set Mario to standing frame (idle or jumping texture)
     void stand() {
-        if (!isJumping) {
-            mario.setTexture(&gifTextures[0]);
-        }
-        else {
-            mario.setTexture(&mario_jump_texture);
-        }
+        pose(idleClip, false);
     }
 
     void standBack() {
-        if (!isJumping) {
-            mario.setTexture(&gifTextureBackward[0]);
-        }
-        else {
-            mario.setTexture(&mario_jump_texture_backward);
-        }
+        pose(idleClip, true);
+    }
+
+    // Multiplies the sprite's colours, e.g. to tell the second player apart
+    void setTint(sf::Color tint) {
+        mario.setFillColor(tint);
+    }
+
+    State saveState() const {
+        return State{ mario.getPosition(), previousPosition, vy, fall_vy, vx, isJumping, isHighJump, isJumpingBackward, isFalling };
+    }
+
+    void loadState(const State& state) {
+        mario.setPosition(state.position);
+        previousPosition = state.previousPosition;
+        vy = state.vy;
+        fall_vy = state.fall_vy;
+        vx = state.vx;
+        isJumping = state.isJumping;
+        isHighJump = state.isHighJump;
+        isJumpingBackward = state.isJumpingBackward;
+        isFalling = state.isFalling;
+    }
+
+    // Shows the animator's current frame; call after the set has been updated
+    void syncSprite() {
+        mario.setTextureRect(sf::IntRect(animators->getUV(animator)));
+    }
+
+    // Remembers the position before a simulation step for render interpolation
+    void beginTick() {
+        previousPosition = mario.getPosition();
+    }
+
+    sf::Vector2f getPreviousPosition() const {
+        return previousPosition;
     }
 
     // Falling down
-    void updateFall() {
-        float dt = clock.restart().asSeconds();
-        std::cout << fall_vy << " Mario Y: " << mario.getPosition().y << std::endl;
-        fall_vy += (float) gravity * dt * 20.f;                        // Accelerate due to gravity
-        mario.move(0.f, (fall_vy * dt));
-        // Move down
-        //std::this_thread::sleep_for(std::chrono::milliseconds(30));
-        // std::this_thread::sleep_for(std::chrono::milliseconds(30));
-        fall_vy = (float) gravity * dt;
+    void updateFall(float dt) {
+        LOG_TRACE << "Falling at " << fall_vy << ", Mario Y: " << mario.getPosition().y;
+        fall_vy += gravity * dt;                                       // Accelerate due to gravity
         const float maxFallSpeed = 1500.f;
         if (fall_vy > maxFallSpeed)
             fall_vy = maxFallSpeed;
+        mario.move(0.f, fall_vy * dt);                                 // Move down
 
         // Clamp to floor (adjusted for height)
         if (mario.getPosition().y >= 1000.f) {
@@ -220,52 +208,26 @@ public:
 
 
 
-    // Play running animation frames
-    void run() {
-        if (animationClock.getElapsedTime().asSeconds() > frameDuration) {
-            currentFrame = (currentFrame + 1) % gifTextures.size();
-            if (mario.getPosition().x < 390.f) {
-                mario.setPosition(mario.getPosition().x + 20.f, mario.getPosition().y);
-            }
-            if (!isJumping) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                mario.setTexture(&gifTextures[currentFrame]);
-            }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                mario.setTexture(&mario_jump_texture);
-            }
-            animationClock.restart();
-            
+    // Run right, playing the run clip
+    void run(float dt) {
+        if (mario.getPosition().x < screenAnchorX) {
+            float x = mario.getPosition().x + runSpeed * dt;
+            mario.setPosition(x < screenAnchorX ? x : screenAnchorX, mario.getPosition().y);
         }
+        pose(runClip, false);
     }
 
-    void runBackward() {
-        if (animationClock.getElapsedTime().asSeconds() > frameDuration) {
-            currentFrame = (currentFrame + 1) % gifTextureBackward.size();
-            if (!isJumping) {
-                sf::Vector2f curr_pos = mario.getPosition();
-                mario.setPosition(sf::Vector2f(curr_pos.x - 20.f, curr_pos.y));
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                mario.setTexture(&gifTextureBackward[currentFrame]);
-            }
-            else {
-                sf::Vector2f curr_pos = mario.getPosition();
-                mario.setPosition(sf::Vector2f(curr_pos.x - 20.f, curr_pos.y));
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                mario.setTexture(&mario_jump_texture_backward);
-            }
-            animationClock.restart();
-
-        }
+    void runBackward(float dt) {
+        mario.move(-runSpeed * dt, 0.f);
+        pose(runClip, true);
     }
 
-    // Return the Mario object for rendering
-    sf::RectangleShape getObj() {
+    // Mario's shape for rendering; a reference, so drawing never copies its vertices
+    const sf::RectangleShape& getObj() const {
         return mario;
     }
 
-    sf::Vector2f getPosition() {
+    sf::Vector2f getPosition() const {
         return mario.getPosition();
     }
 
@@ -280,10 +242,15 @@ public:
         }
     }
 
-    // Update Mario's movement and state during a jump
-    void updateJump() {
-        float dt = clock.restart().asSeconds();
+    // Springs Mario back up after landing on an enemy
+    void bounce() {
+        vy = jumpForce * 0.6f;
+        isJumping = true;
+        isHighJump = false;
+    }
 
+    // Update Mario's movement and state during a jump; true on the tick he lands
+    bool updateJump(float dt) {
         // Gravity affects vertical velocity
         vy += gravity * dt;
 
@@ -294,7 +261,9 @@ public:
         mario.move(moveX, moveY);
 
         // Ground collision check
+        bool landed = false;
         if (mario.getPosition().y >= 475.f) {
+            landed = isJumping;
             mario.setPosition(mario.getPosition().x, 475.f);
             vy = 0.0f;
             vx = 0.0f;
@@ -302,12 +271,139 @@ public:
             isHighJump = false;
             isJumpingBackward = false;
         }
-
+        return landed;
     }
 
     // Destructor logs the object's destruction
     ~Mario() {
-        std::cout << "Mario obj id : " << id << " removed" << std::endl;
+        LOG_DEBUG << "Mario obj id : " << id << " removed";
+    }
+};
+
+// ─────────────────────────────────────────────
+// GameOptions Struct
+// How the game is launched; parsed from the command line in main()
+// ─────────────────────────────────────────────
+struct GameOptions {
+    bool headless = false;              // No window and no audio; input comes from the script
+    bool offscreen = false;             // Headless only: draw every tick into an offscreen texture
+    std::uint64_t ticks = 0;            // Headless: ticks to simulate (0 = length of the script)
+    std::string inputScript;            // Replayed instead of the keyboard when set
+    std::string recordPath;             // Keyboard input is saved here on exit when set
+    unsigned int threads = 0;           // Job system threads including the main one (0 = one per core)
+    std::string tracePath;              // Chrome trace written here on exit (needs ENGINE3D_PROFILE)
+    std::string overlayFont;            // Shows the stats overlay using this font when set
+    unsigned int extraEnemies = 0;      // Stress test: walkers spawned across the level on top of its own
+    std::string packPath = "assets.pak";    // Baked assets; loose files are decoded when it is empty or missing
+    bool renderThread = true;           // Windowed: draw and present on a render thread while the next ticks run
+    bool walls = false;                 // Runs the raycast wall demo (Game) instead of the platformer
+    unsigned int netPlayer = 0;         // Netplay: which of the two players this side is (0 = single player)
+    unsigned short netPort = 0;         // Netplay: local UDP port
+    std::string netPeer;                // Netplay: the other side's host:port
+    unsigned int inputDelay = 1;        // Netplay: ticks local input waits before it applies; both sides must match
+    unsigned int lagMin = 0, lagMax = 0;    // Netplay test shim: milliseconds added to every datagram sent
+    float loss = 0.f;                   // Netplay test shim: share of datagrams dropped (0..1)
+    unsigned int rewindBudget = 32;     // MiB of per-tick history for rewind and death replay (0 = none)
+    unsigned int rewindChecks = 0;      // Headless: replays from this many held ticks must end in the same state
+    bool watch = false;                 // Development: applies edits to the level and images while the game runs
+
+    //   --headless [--ticks N] [--offscreen] --script <file>
+    //   --record <file>
+    //   --threads N
+    //   --trace <file.json>
+    //   --overlay <font.ttf>
+    //   --log <file>
+    //   --enemies N
+    //   --pack <file.pak> | --loose
+    //   --inline-render
+    //   --walls
+    //   --net <1|2> <local_port> <peer_host:port> [--input-delay N] [--lag MIN[-MAX]] [--loss PERCENT]
+    //   --rewind-budget MB
+    //   --rewind-check N
+    //   --watch
+    static GameOptions parse(int argc, char** argv) {
+        GameOptions options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--headless") options.headless = true;
+            else if (arg == "--offscreen") options.offscreen = true;
+            else if (arg == "--ticks" && hasValue) options.ticks = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--script" && hasValue) options.inputScript = argv[++i];
+            else if (arg == "--record" && hasValue) options.recordPath = argv[++i];
+            else if (arg == "--trace" && hasValue) options.tracePath = argv[++i];
+            else if (arg == "--overlay" && hasValue) options.overlayFont = argv[++i];
+            else if (arg == "--log" && hasValue) Log::logger().setFile(argv[++i]);     // Opened now so asset loading is logged too
+            else if (arg == "--enemies" && hasValue) options.extraEnemies = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--pack" && hasValue) options.packPath = argv[++i];
+            else if (arg == "--loose") options.packPath.clear();
+            else if (arg == "--inline-render") options.renderThread = false;
+            else if (arg == "--walls") options.walls = true;
+            else if (arg == "--watch") options.watch = true;
+            else if (arg == "--net" && i + 3 < argc) {
+                options.netPlayer = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+                options.netPort = static_cast<unsigned short>(std::strtoul(argv[++i], nullptr, 10));
+                options.netPeer = argv[++i];
+                if (options.netPlayer != 1 && options.netPlayer != 2) {
+                    LOG_WARNING << "Ignoring --net: the player must be 1 or 2";
+                    options.netPlayer = 0;
+                }
+            }
+            else if (arg == "--input-delay" && hasValue) options.inputDelay = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--lag" && hasValue) {
+                char* end = nullptr;
+                options.lagMin = static_cast<unsigned int>(std::strtoul(argv[++i], &end, 10));
+                options.lagMax = *end == '-' ? static_cast<unsigned int>(std::strtoul(end + 1, nullptr, 10)) : options.lagMin;
+            }
+            else if (arg == "--loss" && hasValue) options.loss = std::strtof(argv[++i], nullptr) / 100.f;
+            else if (arg == "--rewind-budget" && hasValue) options.rewindBudget = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--rewind-check" && hasValue) options.rewindChecks = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            else LOG_WARNING << "Ignoring unknown option " << arg;
+        }
+        return options;
+    }
+};
+
+// ─────────────────────────────────────────────
+// GameAudio Class
+// Background music and sound effects. Only created when the game has a
+// window, so headless runs never open an audio device.
+// ─────────────────────────────────────────────
+class GameAudio {
+private:
+    sf::Music ground_play_bg_audio;
+    sf::Sound jumpSound, dieSound;
+
+public:
+    GameAudio(ResourceCache& resources) {
+        // Load background music, streamed from the asset pack when the game runs from one
+        const std::string music = "assets/audio/gameplay-ground.ogg";
+        auto [data, size] = resources.findStream(music);
+        if (data ? !ground_play_bg_audio.openFromMemory(data, size) : !ground_play_bg_audio.openFromFile(music)) {
+            LOG_ERROR << "Failed to load music";
+        }
+        ground_play_bg_audio.setLoop(true);
+        ground_play_bg_audio.play();
+
+        // Sound effects were preloaded into the shared cache
+        jumpSound.setBuffer(resources.getSoundBuffer("assets/audio/jump-small.wav"));
+        dieSound.setBuffer(resources.getSoundBuffer("assets/audio/mariodie.wav"));
+    }
+
+    void playJump() {
+        jumpSound.play();
+    }
+
+    void playDie() {
+        ground_play_bg_audio.stop();
+        dieSound.play();
+    }
+
+    // After going back to before a death
+    void resumeMusic() {
+        if (ground_play_bg_audio.getStatus() != sf::Music::Playing)
+            ground_play_bg_audio.play();
     }
 };
 
@@ -316,291 +412,1188 @@ public:
 // Main game loop handler: rendering, audio, input, and updates
 // ─────────────────────────────────────────────
 class SuperMarioGamePlay {
+public:
+    // Accumulated time per phase of the loop
+    struct PhaseTimes {
+        sf::Time input, physics, collision, renderPrep, render;
+    };
+
 private:
-    sf::RenderWindow window;                // Main game window
-    sf::Texture skyTexture;                 // Background texture
+    GameOptions options;
+    std::unique_ptr<sf::RenderWindow> window;       // Null in headless runs
+    std::unique_ptr<sf::RenderTexture> offscreen;   // Headless render target, when requested
+    sf::RenderTarget* target = nullptr;             // Where frames are drawn; null = skip drawing
+    RenderThread renderer;                          // Command lists the frames are recorded into, and the thread that plays them
+    AssetPackFile pack;                     // Mapped asset pack, if any; outlives the music streamed from it
+    ResourceCache resources;                // Every texture and sound, loaded once by path
+    AnimationLibrary animations;            // Sprite clips, read before the atlas is packed
+    const TextureAtlas& sprites;            // All sprite frames in one texture
+    AnimatorSet characters{ &animations };  // Mario's animator; advanced once per tick
     sf::RectangleShape background;          // Background shape
 
-    // Audio resources
-    sf::Music ground_play_bg_audio;
-    sf::SoundBuffer jumpBuffer, dieBuffer;
-    sf::Sound jumpSound, dieSound;
-    sf::Clock soundCooldownClock;          // Prevents spamming jump sounds
-
-    std::vector<std::vector<std::shared_ptr<sf::RectangleShape>>> brickslab; // Brick grid
-
-    GroundBrick brick;                      // Brick generator
-    Mario mario;                            // Mario object
-    int defaultpose = 0;                    // 0 -> forward , 1 -> Backward
-    sf::Vector2f running_pos;
+    std::unique_ptr<GameAudio> audio;       // Null in headless runs
+
+    KeyboardInput keyboard;
+    std::unique_ptr<InputSource> input;     // Script or keyboard (possibly recorded)
+
+    FixedTimestep timestep{ sf::seconds(0.01f) };   // 100 simulation ticks per second
+    JobSystem jobs;                         // Worker pool the per-tick entity systems split across
+    PhaseTimes phaseTimes;
+    sf::Clock phaseClock;
+    sf::Clock frameClock;
+    std::size_t drawCalls = 0;              // Recorded by the last prepareFrame()
+    StatsOverlay overlay;
+
+    ChunkedLevel level;                     // Memory-mapped binary level
+    LevelStreamer ground;                   // Tile chunks resident around the camera
+    Camera camera;                          // One view per parallax layer
+    std::unique_ptr<FileWatcher> watcher;   // --watch only: the level and image directories
+    std::vector<std::string> changedFiles;  // Reused by every poll of the watcher
+    ChunkedLevel::ReloadResult levelChanges;
+    std::size_t skyLayer = 0, worldLayer = 0;
+
+    // Static decorations of one of the level's parallax layers, cached in texture strips
+    struct Backdrop {
+        std::size_t cameraLayer = 0;
+        ParallaxLayer layer;
+    };
+    std::vector<std::unique_ptr<Backdrop>> backdrops;     // Back to front
+
+    // One Mario and the state that goes with him. There is a second player
+    // only in netplay; both live in screen space and share the camera.
+    struct Player {
+        Mario mario;
+        int defaultpose = 0;                // 0 -> forward , 1 -> Backward
+        sf::Vector2f running_pos = sf::Vector2f(390.f, 480.f);
+        bool fallen = false;
+        std::uint64_t lastJumpTick = 0;     // Prevents spamming jump sounds
+        bool hasPlayedDieSound = false;
+
+        Player(unsigned int id, const TextureAtlas& atlas, AnimationLibrary& library, AnimatorSet& set, float start_x)
+            : mario(id, atlas, library, set, start_x) {}
+    };
+    std::vector<Player> players;
     float total_length = 0.f;
-    bool fallen;
-    Cloud cloud1, cloud2, cloud3, cloud4, cloud5, cloud6, cloud7;
-    Bush bush1, bush2, bush3, bush4, bush5, bush6, bush7, bush8, bush9, bush10, bush11, bush12;
-    Gomma gomma1;
+
+    // Netplay: input bookkeeping and the link to the other side; null otherwise
+    std::unique_ptr<RollbackSession> session;
+    std::unique_ptr<NetPeer> peer;
+    std::uint64_t netplayEnd = 0;           // Headless netplay stops at this tick (0 = never)
+    bool resimulating = false;              // Sounds stay quiet while a rollback replays ticks
+    struct NetplayTimes {
+        sf::Time resimulate, maxResimulate, save, load;
+        std::uint64_t saves = 0, loads = 0;
+        std::size_t stateBytes = 0;
+    } netTimes;
+    sf::Clock netplayClock;                 // Since both sides connected
+    sf::Clock lingerClock;                  // Since headless netplay had everything it needed
+    bool lingering = false;
+
+    // Single player: the state after every recent tick, for rewinding (hold
+    // Backspace), the death replay and --rewind-check
+    RewindBuffer rewind;
+    std::vector<std::uint8_t> stateImage;   // Scratch image, keeps its capacity
+    sf::Time rewindSaveTime;                // Spent taking the images pushed
+    bool recordingRewind = true;            // Off while the history itself is being replayed
+    std::uint64_t deathTick = 0;            // When player one fell (0 = alive)
+    std::uint64_t replayTick = 0, replayEnd = 0;    // Death replay in progress while replayTick <= replayEnd
+    static constexpr std::uint64_t replayBefore = 200, replayAfter = 100;  // Ticks shown either side of the death
+
+    // Render layers the entity store batches sprites into, back to front
+    enum EntityLayer : std::uint8_t { ActorSprites, EntityLayerCount };
+    EntityStore entities;                   // Enemies spawned from the level
+    EnemySystem enemies;                    // Walking, terrain and stomp rules for those entities
+    ParticleSystem particles;               // Dust and debris; cosmetic, so not part of the saved state
+    static constexpr float activeMargin = 800.f;    // Entities this far off screen still update
 public:
     // Game constructor: initializes window, loads assets, builds level
-    SuperMarioGamePlay() : window(sf::VideoMode(1600, 900), "Super Mario Bros"), mario(100),
-        cloud1(sf::Vector2f(100.f, 100.f), sf::Vector2f(120.f, 80.f)),
-        cloud2(sf::Vector2f(300.f, 200.f), sf::Vector2f(120.f, 80.f)),
-        cloud3(sf::Vector2f(600.f, 100.f), sf::Vector2f(120.f, 80.f)),
-        cloud4(sf::Vector2f(1000.f, 400.f), sf::Vector2f(120.f, 80.f)),
-        cloud5(sf::Vector2f(1200.f, 100.f), sf::Vector2f(120.f, 80.f)),
-        cloud6(sf::Vector2f(1600.f, 100.f), sf::Vector2f(120.f, 80.f)),
-        cloud7(sf::Vector2f(2500.f, 100.f), sf::Vector2f(120.f, 80.f)),
-
-        bush1(sf::Vector2f(0.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush2(sf::Vector2f(150.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush3(sf::Vector2f(600.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush4(sf::Vector2f(900.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush5(sf::Vector2f(1700.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush6(sf::Vector2f(2500.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush7(sf::Vector2f(4500.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush8(sf::Vector2f(6500.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush9(sf::Vector2f(6900.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush10(sf::Vector2f(8000.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush11(sf::Vector2f(9000.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        bush12(sf::Vector2f(9500.f, 500.f), sf::Vector2f(120.f, 80.f)),
-        gomma1(sf::Vector2f(2000.f, 480.f), sf::Vector2f(70.f, 70.f))
-
+    SuperMarioGamePlay(const GameOptions& init_options = GameOptions()) : options(init_options),
+        sprites(loadAssets()), jobs(init_options.threads),
+        camera(sf::Vector2f(1600.f, 900.f)),
+        rewind(init_options.netPlayer ? 0 : static_cast<std::size_t>(init_options.rewindBudget) << 20)
         {
-        window.setFramerateLimit(100);
-        std::vector<std::shared_ptr<sf::RectangleShape>> clouds;
+        // Sky stays put; the level's parallax layers get their own views once it is open
+        skyLayer = camera.addLayer(0.f);
+        worldLayer = camera.addLayer(1.f);
+
+        // Player one starts where Mario always has; in netplay player two starts a little behind, tinted green
+        players.reserve(RollbackSession::PlayerCount);
+        players.emplace_back(100, sprites, animations, characters, 390.f);
+        if (options.netPlayer) {
+            players.emplace_back(101, sprites, animations, characters, 290.f);
+            players.back().mario.setTint(sf::Color(150, 255, 150));
+            session = std::make_unique<RollbackSession>(options.netPlayer - 1, options.inputDelay);
+            peer = std::make_unique<NetPeer>();
+        }
 
-        running_pos = sf::Vector2f(sf::Vector2f(390.f, 480.f));
-        fallen = false;
+        // Headless runs never touch the keyboard; without a script Mario just stands
+        if (!options.inputScript.empty() || options.headless)
+            input = std::make_unique<ScriptedInput>(options.inputScript.empty() ? InputScript() : readInputScript(options.inputScript));
+        else if (!options.recordPath.empty())
+            input = std::make_unique<RecordingInput>(keyboard);
 
-        
+        // Map the level; tiles are streamed in chunk by chunk as the camera moves
+        if (!level.open(LevelAssets::binary)) {
+            LOG_ERROR << "Could not open level";
+        }
+        if (target)
+            ground.addTileTexture(sprites.getTexture(), sprites.getRect(SpriteAssets::brick));
+        ground.attach(level, 1600.f);
+        total_length = level.getWidth();
+        camera.setBounds(0.f, total_length - 1600.f);
+        ground.update(camera.getVisibleRect(worldLayer));
+
+        buildBackdrops();
+        spawnEntities();
+
+        // Music, sound effects and sky background were preloaded into the shared cache
+        if (window)
+            audio = std::make_unique<GameAudio>(resources);
+        if (target) {
+            background.setTexture(&resources.getTexture("assets/img/main_bg.png"));
+            background.setSize(sf::Vector2f(1600, 900));
+        }
+        if (target && !options.overlayFont.empty())
+            overlay.loadFont(options.overlayFont);
+
+        if (options.watch) {
+            watcher = std::make_unique<FileWatcher>();
+            watcher->watch("assets/level");
+            watcher->watch("assets/img");
+            LOG_INFO << "Watching assets/level and assets/img for changes";
+        }
+    }
+
+    // The render thread draws members declared after it, so it stops first
+    ~SuperMarioGamePlay() {
+        renderer.stop();
+    }
 
-        // Load level layout from file
-        std::ifstream level0_brick("assets/level/Level0-brick.dat");
-        if (!level0_brick) {
-            std::cerr << "Could not open file\n";
+    // Main game loop: consume real time in fixed simulation steps, then
+    // record the state interpolated by whatever fraction of a step is left
+    // over. The render thread draws and presents that frame while the next
+    // one is simulated; with --inline-render this thread does both in turn.
+    void run() {
+        if (options.headless) {
+            runHeadless();
+            writeTrace();
+            return;
         }
 
-        brickslab.resize(10);  // Create 10 rows
+        if (session && !startNetplay())
+            return;
+        if (options.renderThread)
+            renderer.start(*window);
+        FrameAllocationCheck frameAllocations;
+        frameClock.restart();
+        while (window->isOpen()) {
+            PROFILE_FRAME();
+            frameAllocations.beginFrame();
+
+            // A whole frame ahead of the render thread: input is still handled while waiting for a free list
+            while (!renderer.waitForSlot(sf::milliseconds(1)))
+                pollWindowEvents();
+            phaseTimes.render += phaseClock.restart();
+            pollWindowEvents();
+            if (!window->isOpen())
+                break;
+            applyFileChanges();
+
+            timestep.beginFrame();
+            while (timestep.shouldStep())
+                simulateTick(timestep.getStep());
+
+            prepareFrame(timestep.getAlpha());
+            if (renderer.isRunning())
+                renderer.submit();
+            else
+                drawFrame(*window);
+            phaseTimes.render += phaseClock.restart();
+            overlay.update(frameClock.restart(), statsSample());
+            recordCounters();
+            frameAllocations.endFrame();
+        }
+        renderer.stop();
+        if (options.renderThread)
+            logRenderStats();
+        Log::flush();
+        if (session)
+            reportNetplay();
+        if (AllocationCounter::enabled())
+            frameAllocations.report(std::cout);
+        if (auto* recorder = dynamic_cast<RecordingInput*>(input.get()))
+            recorder->save(options.recordPath);
+        writeTrace();
+    }
 
-        char ch;
-        int index = 0;
-        while (level0_brick.get(ch)) {
-            if (ch == '1') {
-                for (int h = 0; h < 10; h++) {
-                    auto new_brick_obj = brick.getObj();
-                    new_brick_obj->setPosition(sf::Vector2f{ 50.f * index, 550.f + (50.f * h) });
-                    brickslab[h].push_back(new_brick_obj);
-                }
+    // FNV-1a hash of the simulation state; identical input gives an identical
+    // hash, so headless runs double as regression tests
+    std::uint64_t stateChecksum() const {
+        std::uint64_t hash = Fnv1a::OffsetBasis;
+        auto mix = [&hash](const void* data, std::size_t size) { hash = Fnv1a::hash(data, size, hash); };
+        std::uint64_t tick = timestep.getTick();
+        float scroll = camera.getScroll();
+        mix(&tick, sizeof(tick));
+        for (std::size_t i = 0; i < players.size(); i++) {
+            const Player& player = players[i];
+            sf::Vector2f position = player.mario.getPosition(), previous = player.mario.getPreviousPosition();
+            mix(&position, sizeof(position));
+            mix(&previous, sizeof(previous));
+            if (i == 0)
+                mix(&scroll, sizeof(scroll));
+            mix(&player.fallen, sizeof(player.fallen));
+            mix(&player.defaultpose, sizeof(player.defaultpose));
+        }
+        mix(entities.posX.data(), entities.posX.size() * sizeof(float));
+        mix(entities.posY.data(), entities.posY.size() * sizeof(float));
+        mix(entities.animators.frame.data(), entities.animators.frame.size() * sizeof(std::uint16_t));
+        mix(enemies.state.data(), enemies.state.size());
+        return hash;
+    }
+
+    const PhaseTimes& getPhaseTimes() const {
+        return phaseTimes;
+    }
+
+private:
+    static constexpr float footProbeOffset = 50.f;     // Level x of Mario's gap probe, relative to his left edge
+
+    StatsOverlay::Sample statsSample() const {
+        EntityStore::Stats entityStats = entities.getStats();
+        const LevelStreamer::Stats& groundStats = ground.getStats();
+        StatsOverlay::Sample sample;
+        sample.drawCalls = drawCalls;
+        sample.entitiesVisible = entityStats.visible;
+        sample.entitiesActive = entityStats.active;
+        sample.entitiesTotal = entityStats.total;
+        sample.chunksDrawn = groundStats.drawnChunks;
+        sample.chunksResident = groundStats.residentChunks;
+        RenderThread::Stats renderStats = renderer.getStats();
+        sample.renderQueueDepth = renderStats.queueDepth;
+        sample.renderLatency = renderStats.lastLatency.asMicroseconds() / 1000.f;
+        return sample;
+    }
+
+    // Per-frame counters for the trace
+    void recordCounters() const {
+        PROFILE_COUNTER("Draw calls", drawCalls);
+        PROFILE_COUNTER("Render queue depth", renderer.getStats().queueDepth);
+        PROFILE_COUNTER("Render latency (us)", renderer.getStats().lastLatency.asMicroseconds());
+        PROFILE_COUNTER("Entities drawn", entities.getStats().visible);
+        PROFILE_COUNTER("Entities active", entities.getStats().active);
+        PROFILE_COUNTER("Chunk loads", ground.getStats().chunkLoads);
+        PROFILE_COUNTER("Particles", particles.getCount());
+    }
+
+    void logRenderStats() const {
+        RenderThread::Stats stats = renderer.getStats();
+        auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+        LOG_INFO << "Render thread: " << stats.presented << " of " << stats.submitted << " frames presented, queue depth "
+                 << stats.averageQueueDepth << " average / " << stats.maxQueueDepth << " max, added latency "
+                 << ms(stats.averageLatency) << " ms average / " << ms(stats.maxLatency) << " ms max, "
+                 << stats.stalls << " frames waited " << ms(stats.stallTime) << " ms for a free list";
+    }
+
+    void writeTrace() const {
+        if (options.tracePath.empty())
+            return;
+        if (!Profiler::enabled()) {
+            LOG_WARNING << "Ignoring --trace: built without ENGINE3D_PROFILE";
+            return;
+        }
+        if (Profiler::writeChromeTrace(options.tracePath))
+            LOG_INFO << "Trace written to " << options.tracePath;
+    }
+
+    // Replays the input script for a fixed number of ticks without a window,
+    // one tick per frame, then prints per-phase timings and the state checksum.
+    // Netplay runs in real time instead, since the peer does, and carries on
+    // until the last tick is confirmed by both sides.
+    void runHeadless() {
+        std::uint64_t ticks = options.ticks;
+        if (ticks == 0)
+            ticks = static_cast<ScriptedInput&>(*input).getLength() + 1;
+        if (session) {
+            netplayEnd = ticks;
+            if (!startNetplay())
+                return;
+        }
+
+        FrameAllocationCheck frameAllocations;
+        sf::Clock wallClock;
+        phaseClock.restart();
+        for (std::uint64_t i = 0; session ? !netplayFinished() : i < ticks; i++) {
+            PROFILE_FRAME();
+            frameAllocations.beginFrame();
+            if (session) {
+                sf::sleep(sf::milliseconds(1));
+                timestep.beginFrame();
+                peer->flush();
             }
-            else {
-                float rad = 50.f * index;
-                for (float i = rad; i <= rad + 50; i++) brick.empty.insert(i);
+            else
+                timestep.addTime(sf::seconds(timestep.getStep()));
+            applyFileChanges();
+            while (timestep.shouldStep())
+                simulateTick(timestep.getStep());
+
+            prepareFrame(timestep.getAlpha());
+            if (offscreen) {
+                drawFrame(*offscreen);
+                phaseTimes.render += phaseClock.restart();
             }
+            recordCounters();
+            frameAllocations.endFrame();
+        }
+        float seconds = wallClock.getElapsedTime().asSeconds();
+
+        auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+        EntityStore::Stats entityStats = entities.getStats();
+        const LevelStreamer::Stats& groundStats = ground.getStats();
+        JobSystem::Stats jobStats = jobs.getStats();
+        const EnemySystem::Stats& enemyStats = enemies.getStats();
+        const ParticleSystem::Stats& particleStats = particles.getStats();
+        std::size_t decorations = 0;
+        unsigned int stripsComposed = 0;
+        for (const auto& backdrop : backdrops) {
+            decorations += backdrop->layer.getStats().decorations;
+            stripsComposed += backdrop->layer.getStats().stripsComposed;
+        }
+        Log::flush();       // Keeps queued log lines ahead of the report
+        std::cout << "Headless: " << ticks << " ticks in " << seconds * 1000.f << " ms ("
+                  << (seconds > 0.f ? ticks / seconds : 0.f) << " ticks/s)\n"
+                  << "  input " << ms(phaseTimes.input) << " ms, physics " << ms(phaseTimes.physics)
+                  << " ms, collision " << ms(phaseTimes.collision) << " ms, render-prep " << ms(phaseTimes.renderPrep)
+                  << " ms, render " << ms(phaseTimes.render) << " ms\n"
+                  << "  culling: " << entityStats.visible << " entities drawn, " << entityStats.active << " active of "
+                  << entityStats.total << "; " << groundStats.drawnChunks << " of " << groundStats.residentChunks
+                  << " resident chunks drawn\n"
+                  << "  parallax: " << backdrops.size() << " layers, " << decorations << " decorations, "
+                  << stripsComposed << " strips composed\n"
+                  << "  enemies: " << enemyStats.walking << " walking, " << enemyStats.stomped << " stomped; "
+                  << enemyStats.pairsTested << " pairs tested, " << enemyStats.pairsTouching << " touching in the last tick\n"
+                  << "  particles: " << particleStats.emitted << " emitted, " << particleStats.peak << " live at most, "
+                  << particleStats.live << " at the end, " << particleStats.dropped << " dropped\n"
+                  << "  jobs: " << jobs.getThreadCount() << " threads, " << jobStats.jobs << " jobs run, "
+                  << jobStats.steals << " stolen\n"
+                  << "  checksum 0x" << std::hex << stateChecksum() << std::dec << "\n";
+        if (session)
+            reportNetplay();
+        if (rewind.isEnabled())
+            reportRewind();
+        if (AllocationCounter::enabled())
+            frameAllocations.report(std::cout);
+        if (options.rewindChecks)
+            checkRewind(options.rewindChecks);
+    }
+
+    void reportRewind() const {
+        const RewindBuffer::Stats& stats = rewind.getStats();
+        auto perEach = [](double total, std::uint64_t count) { return count ? total / count : 0.0; };
+        std::cout << "  rewind: " << stats.ticks << " ticks held (" << stats.ticks * timestep.getStep() << " s, "
+                  << stats.keyframes << " keyframes) in " << stats.bytesUsed / 1024 << " of " << stats.budget / 1024 << " KiB; "
+                  << perEach(static_cast<double>(stats.bytesUsed), stats.ticks) << " bytes per tick against "
+                  << perEach(static_cast<double>(stats.rawBytes), stats.ticks) << " raw, "
+                  << perEach(rewindSaveTime.asMicroseconds(), stats.pushes) << " us to save and "
+                  << perEach(stats.encodeTime.asMicroseconds(), stats.pushes) << " us to encode each\n";
+    }
 
-            index += 1;
-            total_length = 50.f * index;
+    // Determinism check: restores count ticks spread over the rewind history
+    // and simulates each up to the present again with the same script; every
+    // replay has to end in exactly the state the run ended in
+    void checkRewind(unsigned int count) {
+        if (rewind.empty())
+            return;
+        std::vector<std::uint8_t> reference;
+        saveState(reference);
+        std::uint64_t end = timestep.getTick();
+        std::uint64_t oldest = rewind.getOldestTick(), newest = rewind.getNewestTick();
+        unsigned int mismatches = 0;
+        sf::Time restoreTime;
+        recordingRewind = false;
+        for (unsigned int k = 0; k < count; k++) {
+            std::uint64_t from = oldest + (newest - oldest) * k / count;
+            sf::Clock restoreClock;
+            if (!rewind.restore(from, stateImage) || !loadState(stateImage)) {
+                LOG_ERROR << "Rewind: could not restore tick " << from;
+                mismatches++;
+                continue;
+            }
+            restoreTime += restoreClock.getElapsedTime();
+            for (std::uint64_t tick = from + 1; tick <= end; tick++) {
+                timestep.setTick(tick);
+                simulateTick(timestep.getStep());
+            }
+            saveState(stateImage);
+            if (stateImage != reference) {
+                std::cout << "  rewind check: MISMATCH replaying from tick " << from << "\n";
+                mismatches++;
+            }
         }
+        recordingRewind = true;
+        std::cout << "  rewind check: " << count << " replays from ticks " << oldest << "-" << newest << " to tick " << end
+                  << ", " << restoreTime.asMicroseconds() / static_cast<double>(count) << " us per restore; "
+                  << (mismatches ? "FAILED, " + std::to_string(mismatches) + " did not match" : std::string("all matched")) << "\n";
+    }
 
-        level0_brick.close();
+    // Waits for the other side, then saves the state every rollback starts from
+    bool startNetplay() {
+        LOG_INFO << "Netplay: player " << options.netPlayer << " on UDP port " << options.netPort << ", waiting for " << options.netPeer;
+        if (!peer->open(options.netPort, options.netPeer, options.netPlayer - 1))
+            return false;
+        peer->setLinkConditions(sf::milliseconds(options.lagMin), sf::milliseconds(options.lagMax), options.loss);
+        if (!peer->connect(*session, sf::seconds(30.f)))
+            return false;
+        saveState(session->getState(0));
+        netTimes.stateBytes = session->getState(0).size();
+        timestep.beginFrame();      // Drops the time spent waiting
+        timestep.setTick(0);
+        netplayClock.restart();
+        LOG_INFO << "Netplay: connected";
+        return true;
+    }
 
-        // Load background music
-        if (!ground_play_bg_audio.openFromFile("assets/audio/gameplay-ground.ogg")) {
-            std::cerr << "Failed to load music\n";
+    // Headless netplay is over once this side has simulated and confirmed the
+    // last tick, and the peer has acknowledged every local input (or has had
+    // a second to). A peer silent for five seconds ends it too.
+    bool netplayFinished() {
+        if (peer->getSilence() > sf::seconds(5.f)) {
+            LOG_ERROR << "Netplay: nothing from the peer for 5 s, stopping at tick " << session->getTick();
+            return true;
         }
-        ground_play_bg_audio.setLoop(true);
-        ground_play_bg_audio.play();
+        if (session->getTick() < netplayEnd || session->getConfirmedTick() < netplayEnd || session->hasRollback())
+            return false;
+        if (!lingering) {
+            lingering = true;
+            lingerClock.restart();
+        }
+        return peer->getPeerAck() >= netplayEnd || lingerClock.getElapsedTime() > sf::seconds(1.f);
+    }
 
-        // Load jump sound effect
-        if (!jumpBuffer.loadFromFile("assets/audio/jump-small.wav")) {
-            std::cerr << "Failed to load jump sound\n";
+    void reportNetplay() const {
+        const RollbackSession::Stats& stats = session->getStats();
+        const NetPeer::Stats& net = peer->getStats();
+        const LinkShim::Stats& link = peer->getLinkStats();
+        float seconds = netplayClock.getElapsedTime().asSeconds();
+        auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+        auto perEach = [](double total, std::uint64_t count) { return count ? total / count : 0.0; };
+        Log::flush();
+        std::cout << "  netplay: player " << options.netPlayer << " of 2, input delay " << session->getInputDelay()
+                  << " ticks, link " << options.lagMin << "-" << options.lagMax << " ms, " << options.loss * 100.f << "% loss; confirmed to tick "
+                  << session->getConfirmedTick() << "\n"
+                  << "  rollbacks: " << stats.rollbacks << " (" << (seconds > 0.f ? stats.rollbacks / seconds : 0.f) << "/s), "
+                  << stats.resimulatedTicks << " ticks resimulated (" << perEach(static_cast<double>(stats.resimulatedTicks), stats.rollbacks)
+                  << " average, " << stats.maxRollbackDepth << " max), " << perEach(ms(netTimes.resimulate), stats.rollbacks)
+                  << " ms per rollback (" << ms(netTimes.maxResimulate) << " ms max)\n"
+                  << "  state: " << netTimes.stateBytes << " bytes, saved in " << perEach(netTimes.save.asMicroseconds(), netTimes.saves)
+                  << " us, loaded in " << perEach(netTimes.load.asMicroseconds(), netTimes.loads) << " us on average\n"
+                  << "  inputs: remote ones arrived " << perEach(static_cast<double>(stats.remoteLateTicks), stats.remoteInputs)
+                  << " ticks after they were first needed; " << stats.stalls << " ticks stalled, " << net.yields << " yielded\n"
+                  << "  packets: " << net.packetsSent << " sent (" << perEach(static_cast<double>(net.bytesSent), net.packetsSent)
+                  << " bytes average), " << net.packetsReceived << " received, " << link.dropped << " dropped by the shim\n";
+    }
+
+    // One fixed simulation step, timed per phase
+    void simulateTick(float dt) {
+        if (session) {
+            netplayTick(dt);
+            return;
         }
-        jumpSound.setBuffer(jumpBuffer);
+        if (rewindTick())
+            return;
+        PROFILE_ZONE("Tick");
+        InputState buttons;
+        {
+            PROFILE_ZONE("Input");
+            buttons = input ? input->poll(timestep.getTick()) : keyboard.poll(timestep.getTick());
+        }
+        phaseTimes.input += phaseClock.restart();
+        advance(dt, &buttons);
+        recordRewind();
+    }
 
-        
-        // Load jump sound effect
-        if (!dieBuffer.loadFromFile("assets/audio/mariodie.wav")) {
-            std::cerr << "Failed to load jump sound\n";
+    // Pushes the state after this tick into the rewind history
+    void recordRewind() {
+        if (!rewind.isEnabled() || !recordingRewind)
+            return;
+        PROFILE_ZONE("Rewind");
+        sf::Clock saveClock;
+        saveState(stateImage);
+        rewindSaveTime += saveClock.getElapsedTime();
+        rewind.push(timestep.getTick(), stateImage);
+        if (!deathTick && players[0].fallen)
+            deathTick = timestep.getTick();
+    }
+
+    // Windowed single player: instead of simulating the tick, steps back
+    // through the history while Backspace is held, or plays the death replay
+    // once player one has been down for a second. True if the tick was used.
+    bool rewindTick() {
+        if (!rewind.isEnabled() || !window)
+            return false;
+        if (replayTick && replayTick <= replayEnd) {
+            // The last tick shown is the present, so the game carries on from there
+            if (!rewind.restore(replayTick++, stateImage) || !loadState(stateImage))
+                replayTick = replayEnd + 1;
+            return true;
+        }
+        if (deathTick && !replayTick && timestep.getTick() > deathTick + replayAfter) {
+            replayEnd = timestep.getTick() - 1;
+            replayTick = std::max(rewind.getOldestTick(), deathTick > replayBefore ? deathTick - replayBefore : 0);
+            particles.clear();
+            return rewindTick();
         }
-        dieSound.setBuffer(dieBuffer);
+        if (!window->hasFocus() || !sf::Keyboard::isKeyPressed(sf::Keyboard::BackSpace))
+            return false;
+        // The present tick has not been simulated yet; two back is the one before the last
+        std::uint64_t target = timestep.getTick() >= 2 ? timestep.getTick() - 2 : 0;
+        if (rewind.restore(target, stateImage) && loadState(stateImage))
+            wentBack();
+        return true;
+    }
 
-        // Load sky background
-        if (!skyTexture.loadFromFile("assets/img/main_bg.png")) {
-            std::cerr << "Failed to load sky texture.\n";
+    // After loading an earlier state: a death not yet reached is forgotten
+    void wentBack() {
+        if (deathTick > timestep.getTick() || !players[0].fallen) {
+            deathTick = 0;
+            replayTick = replayEnd = 0;
         }
-        background.setTexture(&skyTexture);
-        background.setSize(sf::Vector2f(1600, 900));
+        if (audio && !players[0].fallen)
+            audio->resumeMusic();
+        particles.clear();
     }
 
-    // Main game loop
-    void run() {
-        while (window.isOpen()) {
-            processEvents();
+    // F5: the state after the last tick goes to a file; F9 puts it back
+    void quickSave() {
+        saveState(stateImage);
+        if (StateFile::write("quicksave.sav", timestep.getTick(), stateImage))
+            LOG_INFO << "Quick-saved tick " << timestep.getTick();
+    }
+
+    void quickLoad() {
+        std::vector<std::uint8_t> saved;
+        std::uint64_t tick = 0;
+        if (!StateFile::read("quicksave.sav", saved, tick))
+            return;
+        // A save from another level or enemy count would leave this game half overwritten
+        saveState(stateImage);
+        if (saved.size() != stateImage.size() || !loadState(saved)) {
+            LOG_ERROR << "quicksave.sav does not fit this game";
+            loadState(stateImage);
+            return;
+        }
+        wentBack();
+        LOG_INFO << "Quick-loaded tick " << tick;
+    }
+
+    // One fixed step of a netplay session. Remote inputs that arrived since
+    // the last step may prove a prediction wrong; then the game rolls back
+    // to the state before it and resimulates. After that the next tick is
+    // simulated with the local buttons and the remote ones, known or
+    // predicted, unless this side is too far ahead of the other.
+    void netplayTick(float dt) {
+        PROFILE_ZONE("Tick");
+        {
+            PROFILE_ZONE("Input");
+            peer->receive(*session);
+        }
+        if (std::uint64_t from = session->takeRollback())
+            rollback(from, dt);
+
+        bool hold = (netplayEnd && session->getTick() >= netplayEnd) || !session->canAdvance() || peer->shouldYield(*session);
+        if (!hold) {
+            std::uint64_t next = session->getTick() + 1;
+            session->addLocalInput(input ? input->poll(next) : keyboard.poll(next));
+        }
+        peer->send(*session);
+        phaseTimes.input += phaseClock.restart();
+
+        if (!hold)
+            simulateNetplayTick(session->getTick() + 1, dt);
+        timestep.setTick(session->getTick());
+    }
+
+    // Simulates a session tick with every player's buttons and saves the state after it
+    void simulateNetplayTick(std::uint64_t tick, float dt) {
+        InputState buttons[RollbackSession::PlayerCount];
+        for (unsigned int i = 0; i < RollbackSession::PlayerCount; i++) buttons[i] = session->getInput(i, tick);
+        session->setTick(tick);
+        timestep.setTick(tick);
+        advance(dt, buttons);
+
+        sf::Clock saveClock;
+        saveState(session->getState(tick));
+        netTimes.save += saveClock.getElapsedTime();
+        netTimes.saves++;
+    }
+
+    // Restores the state before tick from and simulates up to the present again
+    void rollback(std::uint64_t from, float dt) {
+        PROFILE_ZONE("Rollback");
+        sf::Clock rollbackClock;
+        std::uint64_t to = session->getTick();
+        if (!loadState(session->getState(from - 1))) {
+            LOG_ERROR << "Netplay: no state saved after tick " << from - 1 << ", cannot roll back";
+            return;
+        }
+        netTimes.load += rollbackClock.getElapsedTime();
+        netTimes.loads++;
+
+        resimulating = true;
+        for (std::uint64_t tick = from; tick <= to; tick++)
+            simulateNetplayTick(tick, dt);
+        resimulating = false;
+        sf::Time cost = rollbackClock.getElapsedTime();
+        netTimes.resimulate += cost;
+        netTimes.maxResimulate = std::max(netTimes.maxResimulate, cost);
+    }
+
+    // Flat image of everything a tick changes: the clock, camera, players,
+    // their animators and the enemies. Rendering state, the streamed tile
+    // window and per-tick scratch are rebuilt from it on load.
+    void saveState(std::vector<std::uint8_t>& out) const {
+        out.clear();
+        StateWriter writer(out);
+        writer.write(timestep.getTick());
+        camera.saveState(writer);
+        for (const auto& player : players) {
+            writer.write(player.mario.saveState());
+            writer.write(player.running_pos);
+            writer.write(player.defaultpose);
+            writer.write(player.fallen);
+            writer.write(player.hasPlayedDieSound);
+            writer.write(player.lastJumpTick);
+        }
+        characters.saveState(writer);
+        entities.saveState(writer);
+        enemies.saveState(writer);
+    }
+
+    // Restores a state saved by this game; false (with the game in an
+    // unknown state) if it does not fit
+    bool loadState(const std::vector<std::uint8_t>& in) {
+        StateReader reader(in);
+        std::uint64_t tick = 0;
+        reader.read(tick);
+        camera.loadState(reader);
+        for (auto& player : players) {
+            Mario::State mario{};
+            if (reader.read(mario))
+                player.mario.loadState(mario);
+            reader.read(player.running_pos);
+            reader.read(player.defaultpose);
+            reader.read(player.fallen);
+            reader.read(player.hasPlayedDieSound);
+            reader.read(player.lastJumpTick);
+        }
+        if (!characters.loadState(reader) || !entities.loadState(reader) || !enemies.loadState(reader) || !reader.atEnd())
+            return false;
+
+        timestep.setTick(tick);
+        for (auto& player : players) player.mario.syncSprite();
+        ground.update(camera.getVisibleRect(worldLayer));
+        return true;
+    }
+
+    // Physics and collision for one tick; buttons holds one state per player
+    void advance(float dt, const InputState* buttons) {
+        {
+            PROFILE_ZONE("Physics");
+            for (auto& player : players) player.mario.beginTick();
+            camera.beginTick();
+            processEvents(dt, buttons);
             update();
-            check();
-            gomma1.auto_move();
-            render();
+
+            // Only entities around the view update; the rest stay frozen until the camera nears them.
+            // Views go to the simulated scroll first so the active set does not depend on render timing.
+            camera.interpolate(1.f);
+            entities.clearActive();
+            for (std::uint8_t i = 0; i < EntityLayerCount; i++)
+                entities.activate(i, camera.getVisibleRect(worldLayer, activeMargin));
+            enemies.applyGravity(entities, dt);
+            entities.updateActiveMotion(dt, -200.f, &jobs);
+            enemies.resolveTerrain(entities, ground.getCollision(), &jobs);
+            enemies.resolvePairs(entities);
+            entities.updateActiveAnimation(&jobs);
+            characters.update();
+            for (auto& player : players) player.mario.syncSprite();
+            if (!resimulating)
+                particles.update(dt);
+        }
+        phaseTimes.physics += phaseClock.restart();
+
+        {
+            PROFILE_ZONE("Collision");
+            ground.update(camera.getVisibleRect(worldLayer));
+            check(dt);
         }
+        phaseTimes.collision += phaseClock.restart();
     }
 
-private:
-    float moving_curr_brixk_x = 390.f;
-    float moving_curr_brixk_y = 450.f;
-    bool hasPlayedDieSound = false;
-    // Handles input, sound logic, and character movement
-    void processEvents() {
+    // Collects the spawns of every parallax layer's kinds into one cached
+    // backdrop per layer. Only drawn, so runs without a render target skip it.
+    void buildBackdrops() {
+        if (!target)
+            return;
+        for (std::size_t i = 0; i < level.getParallaxCount(); i++) {
+            const LevelFormat::ParallaxInfo& info = level.getParallax(i);
+            auto backdrop = std::make_unique<Backdrop>();
+            backdrop->cameraLayer = camera.addLayer(info.scrollFactor);
+            backdrop->layer.setTexture(sprites.getTexture());
+            backdrops.push_back(std::move(backdrop));
+        }
+
+        for (std::size_t i = 0; i < level.getSpawnCount(); i++) {
+            const LevelFormat::SpawnEntry& record = level.getSpawn(i);
+            int parallax = level.getParallaxOfKind(record.kind);
+            if (parallax < 0)
+                continue;
+            sf::IntRect uv = sprites.getRect(SpriteAssets::decoration(level.getKindName(record.kind)));
+            if (uv.width == 0) {
+                LOG_WARNING << "No sprite for decoration '" << level.getKindName(record.kind) << "' in level";
+                continue;
+            }
+            backdrops[parallax]->layer.addDecoration(sf::FloatRect(record.x, record.y, record.width, record.height), uv);
+        }
+
+        for (auto& backdrop : backdrops) backdrop->layer.build(1600.f);
+    }
+
+    // Spawns the level's enemies from its spawn table; decorations belong to the backdrops
+    void spawnEntities() {
+        entities.setAnimations(animations);
+        EntityStore::Prefab gomma;
+        gomma.clip = animations.require("gomma-walk");
+        gomma.layer = ActorSprites;
+        gomma.velocity = sf::Vector2f(-250.f, 0.f);
+
+        entities.reserve(level.getSpawnCount() + options.extraEnemies);
+        for (std::size_t i = 0; i < level.getSpawnCount(); i++) {
+            const LevelFormat::SpawnEntry& record = level.getSpawn(i);
+            sf::Vector2f position(record.x, record.y), size(record.width, record.height);
+            if (level.getParallaxOfKind(record.kind) >= 0)
+                continue;
+            std::string kind = level.getKindName(record.kind);
+            if (kind == "gomma")
+                enemies.add(entities, entities.spawn(gomma, position, size));
+            else
+                LOG_WARNING << "Unknown entity kind '" << kind << "' in level";
+        }
+
+        // Stress scene: walkers spread along the level, some dropped from above, half walking right
+        for (unsigned int i = 0; i < options.extraEnemies; i++) {
+            float span = std::max(total_length - 1000.f, 1.f);
+            sf::Vector2f position(800.f + std::fmod(i * 97.f, span), 480.f - (i % 4) * 90.f);
+            EntityStore::Prefab walker = gomma;
+            walker.velocity.x = i % 2 ? 250.f : -250.f;
+            walker.flipX = walker.velocity.x > 0.f;
+            enemies.add(entities, entities.spawn(walker, position, sf::Vector2f(70.f, 70.f)));
+        }
+    }
+
+    // Creates the render target, then loads every image and sound: straight
+    // from the mapped asset pack when there is one, otherwise decoded on
+    // worker threads while a progress bar is shown. Either way the upload
+    // happens on this (the GL) thread. Runs from the constructor's initializer
+    // list, before any sprite object is built. Headless runs without a render
+    // target skip every GL and audio upload and only keep the atlas layout.
+    const TextureAtlas& loadAssets() {
+        PROFILE_THREAD_NAME("Main");
+        PROFILE_ZONE("LoadAssets");
+        if (!options.headless) {
+            window = std::make_unique<sf::RenderWindow>(sf::VideoMode(1600, 900), "Super Mario Bros");
+            window->setVerticalSyncEnabled(true);    // Paces both the loading screen and the game loop
+            target = window.get();
+        }
+        else if (options.offscreen) {
+            offscreen = std::make_unique<sf::RenderTexture>();
+            if (offscreen->create(1600, 900))
+                target = offscreen.get();
+            else
+                LOG_ERROR << "Failed to create offscreen render target";
+        }
+
+        // The clips name the frames the atlas has to hold
+        animations.load(SpriteAssets::animations);
+
+        std::error_code error;
+        if (!options.packPath.empty() && std::filesystem::exists(options.packPath, error) && pack.open(options.packPath))
+            loadPackedAssets();
+        else
+            loadLooseAssets();
+
+        // Already cached by now, unless the pack has no sprite atlas; then it is built from the loose files
+        const TextureAtlas& atlas = resources.getAtlas("sprites", SpriteAssets::all(animations));
+        animations.resolve([&atlas](const std::string& image) { return atlas.getRect(image); });
+        return atlas;
+    }
+
+    // Hands every entry of the mapped pack to the cache: pixels and samples
+    // go to GL and OpenAL as they are in the file, nothing is decoded
+    void loadPackedAssets() {
+        PROFILE_ZONE("UploadAssets");
+        sf::Clock timer;
+        std::size_t loaded = pack.load(resources, target != nullptr, window != nullptr);
+        const ResourceCache::Stats& assetStats = resources.getStats();
+        LOG_INFO << "Assets: " << loaded << " entries from " << options.packPath << " in " << timer.getElapsedTime().asSeconds() * 1000.f
+                 << " ms, " << (assetStats.textureBytes + assetStats.soundBytes) / 1024 << " KiB resident ("
+                 << assetStats.textureBytes / 1024 << " KiB textures, " << assetStats.soundBytes / 1024 << " KiB sounds)";
+
+        const TextureAtlas* packed = pack.find("sprites") ? &resources.getAtlas("sprites", {}) : nullptr;
+        for (const auto& image : SpriteAssets::all(animations)) {
+            if (!packed || !packed->contains(image)) {
+                LOG_WARNING << options.packPath << " has no sprite " << image << "; rebuild it with the asset_pack target";
+                break;
+            }
+        }
+    }
+
+    // Decodes the loose image and sound files on worker threads while a progress bar is shown
+    void loadLooseAssets() {
+        AssetLoader loader;
+        loader.queueAtlas("sprites", SpriteAssets::all(animations));
+        if (target)
+            loader.queueImage("assets/img/main_bg.png");
+        else
+            loader.setTextureUpload(false);
+        if (window) {
+            loader.queueSound("assets/audio/jump-small.wav");
+            loader.queueSound("assets/audio/mariodie.wav");
+        }
+        loader.start();
+
+        sf::RectangleShape track(sf::Vector2f(600.f, 20.f)), bar(sf::Vector2f(0.f, 20.f));
+        track.setPosition(500.f, 440.f);
+        track.setFillColor(sf::Color(60, 60, 60));
+        bar.setPosition(500.f, 440.f);
+        while (window && !loader.isDone()) {
+            pollWindowEvents();
+            bar.setSize(sf::Vector2f(600.f * loader.getProgress(), 20.f));
+            window->clear(sf::Color::Black);
+            window->draw(track);
+            window->draw(bar);
+            window->display();
+        }
+
+        {
+            PROFILE_ZONE("UploadAssets");
+            loader.upload(resources);
+        }
+
+        const ResourceCache::Stats& assetStats = resources.getStats();
+        LOG_INFO << "Assets: " << assetStats.loads << " files decoded in " << loader.getWallSeconds() * 1000.f << " ms on "
+                 << std::max(1u, std::thread::hardware_concurrency()) << " threads, uploaded in " << assetStats.loadSeconds * 1000.f << " ms, "
+                 << (assetStats.textureBytes + assetStats.soundBytes) / 1024 << " KiB resident ("
+                 << assetStats.textureBytes / 1024 << " KiB textures, " << assetStats.soundBytes / 1024 << " KiB sounds)";
+    }
+
+    // --watch: applies the files edited since the last frame. Text level
+    // sources are converted into the binary level, and replacing that is
+    // picked up in the same call like any other change.
+    void applyFileChanges() {
+        if (!watcher)
+            return;
+        changedFiles.clear();
+        std::size_t handled = 0;
+        while (watcher->poll(changedFiles) || handled < changedFiles.size()) {
+            for (; handled < changedFiles.size(); handled++) {
+                const std::string& path = changedFiles[handled];
+                if (path == LevelAssets::binary)
+                    reloadLevel();
+                else if (path == LevelAssets::bricks || path == LevelAssets::entities || path == LevelAssets::parallax)
+                    convertLevel();
+                else if (path.size() > 4 && path.compare(path.size() - 4, 4, ".png") == 0)
+                    reloadImage(path);
+            }
+        }
+    }
+
+    void convertLevel() {
+        sf::Clock timer;
+        std::error_code error;
+        std::string parallax = std::filesystem::exists(LevelAssets::parallax, error) ? LevelAssets::parallax : std::string();
+        LevelFormat::LevelData data;
+        if (LevelSource::read(LevelAssets::bricks, LevelAssets::entities, parallax, level.isOpen() ? level.getChunkColumns() : 16, data)
+            && LevelFormat::writeLevel(LevelAssets::binary, std::move(data)))
+            LOG_INFO << "Level sources converted in " << timer.getElapsedTime().asMicroseconds() / 1000.f << " ms";
+    }
+
+    // Maps the new level file and compares it with the old one. Only the
+    // resident chunks whose tiles changed get new geometry and collision;
+    // a level with a new size or layers streams its window in again.
+    void reloadLevel() {
+        sf::Clock timer;
+        if (!level.reload(LevelAssets::binary, levelChanges))
+            return;
+        if (levelChanges.layoutChanged) {
+            ground.attach(level, 1600.f);
+            total_length = level.getWidth();
+            camera.setBounds(0.f, total_length - 1600.f);
+            ground.update(camera.getVisibleRect(worldLayer));
+            LOG_INFO << "Level reloaded with a new layout (" << level.getChunkCount() << " chunks) in "
+                     << timer.getElapsedTime().asMicroseconds() / 1000.f << " ms";
+        }
+        else {
+            unsigned int rebuilt = ground.reloadChunks(levelChanges.changedChunks);
+            LOG_INFO << "Level reloaded: " << levelChanges.changedChunks.size() << " of " << level.getChunkCount() << " chunks changed, "
+                     << rebuilt << " resident rebuilt, in " << timer.getElapsedTime().asMicroseconds() / 1000.f << " ms";
+        }
+        if (levelChanges.spawnsChanged)
+            LOG_WARNING << "Entities and parallax layers are read at startup; restart to see those level changes";
+    }
+
+    // Images go back into the texture or atlas rect they were loaded into;
+    // the parallax strips composed from the atlas are composed again. The
+    // render thread may be drawing with that texture, so it finishes first.
+    void reloadImage(const std::string& path) {
+        renderer.waitForIdle();
+        if (!resources.reloadTexture(path))
+            return;
+        for (auto& backdrop : backdrops) backdrop->layer.invalidate();
+        LOG_INFO << "Reloaded " << path;
+    }
+
+    void pollWindowEvents() {
         sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
+        while (window->pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                renderer.stop();        // Lets go of the context before the window destroys it
+                window->close();
+            }
+            else if (event.type == sf::Event::KeyPressed && !session) {
+                if (event.key.code == sf::Keyboard::F5) quickSave();
+                else if (event.key.code == sf::Keyboard::F9) quickLoad();
+            }
         }
+    }
+
+    // Handles input, sound logic, and character movement for one simulation
+    // tick; buttons holds one state per player
+    void processEvents(float dt, const InputState* buttons) {
+        float scroll = 0.f;
+        for (std::size_t i = 0; i < players.size(); i++)
+            scroll = std::max(scroll, processEvents(players[i], dt, buttons[i]));
+
+        // World objects stay at fixed coordinates; only the views move, as
+        // far as the player furthest ahead pushes them
+        if (scroll > 0.f)
+            camera.scroll(scroll);
+
+        for (auto& player : players) {
+            if (!player.fallen) {
+                if (player.mario.updateJump(dt))
+                    emitEffect(Effect::LandingDust, feetOf(player.mario));
+
+                // Mario stays in screen space; his level position comes from the camera
+                player.running_pos = sf::Vector2f(camera.toWorldX(player.mario.getPosition().x, worldLayer) + footProbeOffset, player.mario.getPosition().y);
+            }
+        }
+    }
 
-        // Handle jump input with LShift modifier for high jump
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
-            if (!fallen)
+    // One player's buttons; returns how far he pushes the camera this tick
+    float processEvents(Player& player, float dt, InputState buttons) {
+        Mario& mario = player.mario;
+        float scroll = 0.f;
+
+        // Handle jump input with the run button for high jump
+        if (buttons.isDown(JumpButton)) {
+            if (!player.fallen)
             {
-                float cooldown = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ? 1.1f : 1.0f;
-                if (soundCooldownClock.getElapsedTime().asSeconds() > cooldown) {
-                    jumpSound.play();
-                    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) {
+                float cooldown = buttons.isDown(RunButton) ? 1.1f : 1.0f;
+                if (timestep.getTick() - player.lastJumpTick > timestep.ticksFromSeconds(cooldown)) {
+                    if (audio && !resimulating) audio->playJump();
+                    if (buttons.isDown(RunButton)) {
                         mario.startJump(true, false);
                     }
                     else {
                         mario.startJump(false, false);
                     }
-                    soundCooldownClock.restart();
+                    player.lastJumpTick = timestep.getTick();
                 }
             }
         }
 
         // Move scene to left when right key is pressed
         
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) && !fallen) {
+        if (buttons.isDown(RightButton) && !player.fallen) {
             
-            mario.run();
-            float moveSpeed = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ? 15.f : 8.f;
+            mario.run(dt);
+            float moveSpeed = buttons.isDown(RunButton) ? 375.f : 200.f;
             if (mario.getPosition().x > 380.f)
             {
-                for (auto& row : brickslab) {
-                    for (auto& brick : row) {
-                        sf::Vector2f pos = brick->getPosition();
-                        moving_curr_brixk_x = pos.x;
-                        moving_curr_brixk_y = pos.y;
-                        brick->setPosition(pos.x - moveSpeed, pos.y);
-                        running_pos = sf::Vector2f(total_length - moving_curr_brixk_x + moveSpeed + mario.getPosition().x, mario.getPosition().y);
-                    }   
-                }
-
-                // Parallel moving objects
-                cloud1.getObj().setPosition((sf::Vector2f(cloud1.getObj().getPosition().x - 2.f, 100.f)));
-                cloud2.getObj().setPosition((sf::Vector2f(cloud2.getObj().getPosition().x - 2.f, 200.f)));
-                cloud3.getObj().setPosition((sf::Vector2f(cloud3.getObj().getPosition().x - 2.f, 100.f)));
-                cloud4.getObj().setPosition((sf::Vector2f(cloud4.getObj().getPosition().x - 2.f, 400.f)));
-                cloud5.getObj().setPosition((sf::Vector2f(cloud5.getObj().getPosition().x - 2.f, 100.f)));
-                cloud6.getObj().setPosition((sf::Vector2f(cloud6.getObj().getPosition().x - 2.f, 100.f)));
-                cloud7.getObj().setPosition((sf::Vector2f(cloud7.getObj().getPosition().x - 2.f, 100.f)));
-
-                bush1.getObj().setPosition((sf::Vector2f(bush1.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush2.getObj().setPosition((sf::Vector2f(bush2.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush3.getObj().setPosition((sf::Vector2f(bush3.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush4.getObj().setPosition((sf::Vector2f(bush4.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush5.getObj().setPosition((sf::Vector2f(bush5.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush6.getObj().setPosition((sf::Vector2f(bush6.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush7.getObj().setPosition((sf::Vector2f(bush7.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush8.getObj().setPosition((sf::Vector2f(bush8.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush9.getObj().setPosition((sf::Vector2f(bush9.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush10.getObj().setPosition((sf::Vector2f(bush10.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush11.getObj().setPosition((sf::Vector2f(bush11.getObj().getPosition().x - moveSpeed, 500.f)));
-                bush12.getObj().setPosition((sf::Vector2f(bush12.getObj().getPosition().x - moveSpeed, 500.f)));
-
+                scroll = moveSpeed * dt;
             }
-            else {
-                running_pos = sf::Vector2f(total_length - moving_curr_brixk_x + moveSpeed + mario.getPosition().x, mario.getPosition().y);    
-                
-            }
-            
-            defaultpose = 0;
+
+            player.defaultpose = 0;
         } 
         // Move mario to left when left key is pressed, but brick stays at same position
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) && !fallen) {
-            mario.runBackward();
-            running_pos = sf::Vector2f(total_length + mario.getPosition().x - moving_curr_brixk_x, mario.getPosition().y);
-            defaultpose = 1;
+        else if (buttons.isDown(LeftButton) && !player.fallen) {
+            mario.runBackward(dt);
+            player.defaultpose = 1;
         }
         
 
         else {
             // Show standing frame if not moving
-            if (!fallen) {
-                running_pos = sf::Vector2f(total_length - moving_curr_brixk_x + mario.getPosition().x, mario.getPosition().y);
-                if (defaultpose == 1)
+            if (!player.fallen) {
+                if (player.defaultpose == 1)
                     mario.standBack();
                 else
                     mario.stand();
             }
         }
-
-        if(!fallen)
-            mario.updateJump();
+        return scroll;
     }
 
     // Placeholder for additional logic updates
     void update() {}
 
+    // Mario's level position where his feet touch the ground
+    sf::Vector2f feetOf(const Mario& mario) const {
+        return sf::Vector2f(camera.toWorldX(mario.getPosition().x, worldLayer) + 37.5f, mario.getPosition().y + 75.f);
+    }
+
+    // Cosmetic bursts, drawn from the sprite atlas; quiet while a rollback replays ticks, like the sounds
+    enum class Effect { LandingDust, StompPuff, BrickDebris };
+
+    void emitEffect(Effect effect, sf::Vector2f at) {
+        if (resimulating)
+            return;
+        ParticleSystem::Burst burst;
+        burst.position = at;
+        switch (effect) {
+            case Effect::LandingDust:       // Small puffs rolling out along the ground either side
+                burst.count = 12;
+                burst.spread = sf::Vector2f(20.f, 2.f);
+                burst.angleSpread = 2.8f;
+                burst.speedMin = 40.f; burst.speedMax = 140.f;
+                burst.lifeMin = 0.25f; burst.lifeMax = 0.5f;
+                burst.sizeMin = 10.f; burst.sizeMax = 18.f;
+                burst.gravity = 60.f;
+                burst.drag = 3.f;
+                burst.frame = sf::FloatRect(sprites.getRect(SpriteAssets::cloud));
+                burst.color = sf::Color(235, 225, 205);
+                break;
+            case Effect::StompPuff:         // A ring of yellow puffs around the squashed enemy
+                burst.count = 20;
+                burst.spread = sf::Vector2f(25.f, 4.f);
+                burst.angleSpread = 6.2831853f;
+                burst.speedMin = 80.f; burst.speedMax = 220.f;
+                burst.lifeMin = 0.2f; burst.lifeMax = 0.45f;
+                burst.sizeMin = 8.f; burst.sizeMax = 16.f;
+                burst.gravity = 0.f;
+                burst.drag = 4.f;
+                burst.frame = sf::FloatRect(sprites.getRect(SpriteAssets::cloud));
+                burst.color = sf::Color(255, 235, 150);
+                break;
+            case Effect::BrickDebris:       // Chunks of brick thrown up from the edge of the gap
+                burst.count = 24;
+                burst.spread = sf::Vector2f(25.f, 10.f);
+                burst.angleSpread = 1.8f;
+                burst.speedMin = 250.f; burst.speedMax = 550.f;
+                burst.lifeMin = 0.6f; burst.lifeMax = 1.1f;
+                burst.sizeMin = 10.f; burst.sizeMax = 18.f;
+                burst.frame = sf::FloatRect(sprites.getRect(SpriteAssets::brick));
+                burst.pieceSize = 28.f;
+                break;
+        }
+        particles.emit(burst);
+    }
+
+    // Ends the run: Mario drops out of the level
+    void die(Player& player) {
+        if (!player.hasPlayedDieSound) {
+            if (audio && !resimulating) audio->playDie();
+            player.hasPlayedDieSound = true;  // Ensure it only runs once
+        }
+        player.fallen = true;
+        player.mario.isFalling = true;
+    }
+
     // check some confditions
-    void check() {
-        sf::Vector2f curr_pos =  running_pos;
-        float start = curr_pos.x - 30.f;
-        float end = curr_pos.x + 0.f;
-        //std::cout << "Reached the blank space - x : " << start << " - y : " << end << std::endl;
-        if (brick.empty.count(start) || brick.empty.count(end)) {
-            if (curr_pos.y > 450.f) {
-                if (!hasPlayedDieSound && soundCooldownClock.getElapsedTime().asMilliseconds() > 3) {
-                    ground_play_bg_audio.stop();
-                    dieSound.play();
-                    soundCooldownClock.restart();
-                    hasPlayedDieSound = true;  // Ensure it only runs once
-                }
-               fallen = true;
-               mario.isFalling = true;
-               mario.updateFall();
+    void check(float dt) {
+        for (auto& player : players) check(player, dt);
+    }
+
+    void check(Player& player, float dt) {
+        Mario& mario = player.mario;
+        sf::Vector2f curr_pos =  player.running_pos;
+
+        // Anything solid within one tile below Mario's feet holds him up
+        sf::FloatRect below(curr_pos.x - 30.f, curr_pos.y + 75.f, 30.f, 50.f);
+        if (!player.fallen && !ground.getCollision().overlapsSolid(below) && curr_pos.y > 450.f) {
+            emitEffect(Effect::BrickDebris, sf::Vector2f(curr_pos.x - 15.f, LevelSource::GroundTop));
+            die(player);
+        }
 
+        // Landing on an enemy squashes it, walking into one is fatal
+        if (!player.fallen) {
+            sf::FloatRect marioBox(camera.toWorldX(mario.getPosition().x, worldLayer), mario.getPosition().y, 75.f, 75.f);
+            EnemySystem::Contact contact = enemies.touchPlayer(entities, marioBox, mario.getPreviousPosition().y + 75.f);
+            if (contact == EnemySystem::Contact::Stomp) {
+                emitEffect(Effect::StompPuff, feetOf(mario));
+                mario.bounce();
             }
+            else if (contact == EnemySystem::Contact::Hurt)
+                die(player);
         }
+
+        if (player.fallen)
+            mario.updateFall(dt);
     }
 
-    // Renders background, bricks, and Mario to screen
-    void render() {
-        window.clear(sf::Color(222, 161, 161));
-        window.draw(background);
+    // Interpolates the camera and records this frame's draws into the next
+    // command list. Everything that moves is copied into the list; the
+    // backdrops, background and overlay are only ever changed by whoever
+    // plays it. Runs without a render target too, for the culling counts.
+    void prepareFrame(float alpha) {
+        PROFILE_ZONE("RenderPrep");
+        camera.interpolate(alpha);
+        RenderCommandList& list = renderer.beginFrame();
+
+        list.clear(sf::Color(222, 161, 161));
+        list.setView(camera.getView(skyLayer));
+        list.draw(background);
+
+        // One quad per parallax layer, however many decorations it holds; strips
+        // about to scroll into view are composited by the layer as it is drawn
+        for (const auto& backdrop : backdrops) {
+            list.setView(camera.getView(backdrop->cameraLayer));
+            list.draw(backdrop->layer);
+        }
 
-        
+        // One tile map per layer of each chunk in view, then one batched draw per
+        // entity layer, all sprites sharing the atlas texture; only sprites
+        // overlapping the view are appended
+        list.setView(camera.getView(worldLayer));
+        ground.record(list, camera.getView(worldLayer));
+        sf::RenderStates spriteStates(sprites.hasTexture() ? &sprites.getTexture() : nullptr);   // Layout only without a target
+        for (std::uint8_t i = 0; i < EntityLayerCount; i++) {
+            std::size_t first = list.getVertices().getVertexCount();
+            entities.appendVisibleQuads(i, camera.getVisibleRect(worldLayer), list.getVertices(), alpha, &jobs);
+            list.drawVertices(first, sf::Quads, spriteStates);
+        }
 
-        window.draw(cloud1.getObj());
-        window.draw(cloud2.getObj());
-        window.draw(cloud3.getObj());
-        window.draw(cloud4.getObj());
-        window.draw(cloud5.getObj());
-        window.draw(cloud6.getObj());
-        window.draw(cloud7.getObj());
-
-        window.draw(bush1.getObj());
-        window.draw(bush2.getObj());
-        window.draw(bush3.getObj());
-        window.draw(bush4.getObj());
-        window.draw(bush5.getObj());
-        window.draw(bush6.getObj());
-        window.draw(bush7.getObj());
-        window.draw(bush8.getObj());
-        window.draw(bush9.getObj());
-        window.draw(bush10.getObj());
-        window.draw(bush11.getObj());
-        window.draw(bush12.getObj());
-
-        for (const auto& row : brickslab) {
-            for (const auto& brick : row) {
-                window.draw(*brick);
-            }
+        // Every live particle in one more batch on the same texture
+        std::size_t first = list.getVertices().getVertexCount();
+        particles.appendQuads(list.getVertices());
+        list.drawVertices(first, sf::Quads, spriteStates);
+
+        list.setView(target ? target->getDefaultView() : camera.getView(skyLayer));
+        for (const auto& player : players)
+            list.drawRectangle(player.mario.getObj(), interpolatedStates(player.mario.getPreviousPosition(), player.mario.getPosition(), alpha));
+        overlay.record(list);
+        drawCalls = list.getDrawCount();
+        phaseTimes.renderPrep += phaseClock.restart();
+    }
+
+    // Plays the recorded frame on this thread and presents it
+    template <typename Target>
+    void drawFrame(Target& frame_target) {
+        {
+            PROFILE_ZONE("Draw");
+            renderer.playNow(frame_target);
         }
-        window.draw(gomma1.getObj());
-        window.draw(mario.getObj());
-        window.display();
+        PROFILE_ZONE("Present");
+        frame_target.display();
     }
 };
@@ -2,19 +2,33 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include "configs/components/Wall.hpp"
+#include "JobSystem.hpp"
+#include "Raycaster.hpp"
 
 namespace RectangleObj {
+    // Corners of a rectangle of cells in wall order (A top-left, B top-right,
+    // C bottom-right, D bottom-left), whatever order they are passed in
     std::vector<sf::Vector2i> getRectObjVector(sf::Vector2i new_A, sf::Vector2i new_B, sf::Vector2i new_C, sf::Vector2i new_D);
 }
 
 namespace WallObjActions {
-    void moveWall(Wall wall, std::vector<sf::Vector2i> newPosition);
-    void scaleWall(Wall wall, float scale_size);
+    // Gives the wall the corners in newPosition; ignored unless there are four
+    void moveWall(Wall& wall, std::vector<sf::Vector2i> newPosition);
+    // Scales the wall about its centre, keeping at least one cell each way
+    void scaleWall(Wall& wall, float scale_size);
 }
 
+// ─────────────────────────────────────────────
+// Game Class
+// Pseudo-3D wall demo, started with --walls. The raycaster draws a grid
+// level on the CPU, split across the job system, and each frame is streamed
+// into one texture. A minimap in the corner shows the walls and the field
+// of view: drag the yellow wall to move it and scroll over it to resize it.
+// Arrow keys or WASD walk and turn.
+// ─────────────────────────────────────────────
 class Game {
 public:
-    Game();
+    explicit Game(unsigned int thread_count = 0);
     void run();
 
 private:
@@ -22,12 +36,27 @@ private:
     void processEvents();
     void update();
     void render();
+    void rebuildMap();
+    sf::Vector2i cellAt(sf::Vector2i mouse_position) const;
+    sf::ConvexShape minimapShape(const Wall& wall, sf::Color color) const;
 
     sf::RenderWindow window;
-    sf::ConvexShape convex;
-    sf::Vector2i localPosition;
-    sf::Texture skyTexture;
-    sf::RectangleShape background;
-    std::vector<sf::ConvexShape> wall_objects;
-    Wall onewall;
+    JobSystem jobs;                         // Splits the raycaster's columns across cores
+    Raycaster raycaster;
+    GridMap map;                            // Rebuilt from the walls whenever one changes
+    Raycaster::View view;
+    std::vector<Raycaster::Sprite> sprites;
+    sf::Texture frameTexture;               // Updated from the raycaster's pixels every frame
+    sf::Sprite frame;
+    sf::ConvexShape convex;                 // Field of view on the minimap
+    sf::Vector2i localPosition;             // Mouse position at the last drag step
+    bool dragging = false;
+    sf::RectangleShape background;          // Minimap panel
+    std::vector<Wall> walls;                // Fixed walls, the level border included
+    std::vector<sf::ConvexShape> wall_objects;  // Minimap outline of every wall, the movable one last
+    Wall onewall;                           // The wall the mouse moves
+    sf::Clock frameClock;
+    sf::Time titleTime;                     // Since the frame rate in the title was refreshed
+    unsigned int titleFrames = 0;
+    sf::Time raycastTime;
 };
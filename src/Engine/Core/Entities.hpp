@@ -0,0 +1,328 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Animation.hpp"
+#include "JobSystem.hpp"
+#include "Log.hpp"
+#include "QuadBuilder.hpp"
+#include "SpatialHash.hpp"
+#include "StateStream.hpp"
+
+// ─────────────────────────────────────────────
+// EntityStore Class
+// Structure-of-arrays storage for scenery and simple actors. Every component
+// lives in its own contiguous array indexed by entity, and each system is a
+// straight loop over the arrays it needs, so per-tick cost grows linearly
+// and stays cache friendly at tens of thousands of entities.
+// Every render layer also keeps a spatial hash, so the game can update and
+// draw just the entities near the view instead of the whole level.
+// Systems given a JobSystem split their per-entity loop across its threads;
+// entities are independent within a system, so results match the serial run.
+// ─────────────────────────────────────────────
+class EntityStore {
+public:
+    using Entity = std::uint32_t;
+
+    struct Stats {
+        std::size_t total = 0;              // Entities in the store
+        std::size_t active = 0;             // Updated by the last active-set tick
+        std::size_t visible = 0;            // Drawn by the last appendVisibleQuads() of each layer
+    };
+
+    // Spawn template shared by every entity of one kind
+    struct Prefab {
+        AnimationLibrary::ClipId clip = 0;  // Clip the sprite starts with
+        bool flipX = false;                 // Mirror the sprite horizontally
+        std::uint8_t layer = 0;             // Render layer the sprite is batched into
+        sf::Vector2f velocity;              // Pixels per second
+    };
+
+    // Transform
+    std::vector<float> posX, posY, prevX, prevY, width, height;
+    // Velocity
+    std::vector<float> velX, velY;
+    // Sprite and animation state; entity i plays animator i
+    std::vector<std::uint8_t> layer;
+    std::vector<std::uint8_t> live;         // Cleared by despawn()
+    AnimatorSet animators;
+
+private:
+    std::vector<SpatialHash> layerIndex;    // Per render layer
+    std::vector<Entity> active;             // Entities selected by activate()
+    std::vector<Entity> visible;            // Scratch list for appendVisibleQuads()
+    std::vector<std::size_t> visibleCount;  // Per render layer
+    QuadBuilder quads;
+
+    static constexpr std::size_t JobGrain = 4096;  // Fewer entities than this stay on the calling thread
+    static constexpr std::size_t QuadChunk = 256;  // Sprites gathered per QuadBuilder call, on the stack
+
+    // Runs body(begin, end) over [0, count), on the job system when there is one
+    template <typename Function>
+    static void forRange(JobSystem* jobs, std::size_t count, Function&& body) {
+        if (jobs)
+            jobs->parallelFor(count, JobGrain, body);
+        else
+            body(std::size_t(0), count);
+    }
+
+    sf::FloatRect bounds(std::size_t i) const {
+        return sf::FloatRect(posX[i], posY[i], width[i], height[i]);
+    }
+
+    void move(std::size_t i, float dt, float min_x) {
+        prevX[i] = posX[i];
+        prevY[i] = posY[i];
+        bool stopped = velX[i] < 0.f && posX[i] <= min_x;
+        posX[i] = stopped ? posX[i] : posX[i] + velX[i] * dt;
+        posY[i] += velY[i] * dt;
+    }
+
+    // Writes the sprites of entities [0, count) as quads, each placed between
+    // its previous and current position. Sprites are gathered into small
+    // SoA runs so the quad builder can do several per instruction.
+    void writeQuads(const Entity* entities, std::size_t count, sf::Vertex* out, float alpha) const {
+        float x[QuadChunk], y[QuadChunk], w[QuadChunk], h[QuadChunk];
+        float u[QuadChunk], v[QuadChunk], uw[QuadChunk], vh[QuadChunk];
+        QuadBuilder::Sprites sprites;
+        sprites.x = x; sprites.y = y; sprites.width = w; sprites.height = h;
+        sprites.texLeft = u; sprites.texTop = v; sprites.texWidth = uw; sprites.texHeight = vh;
+
+        for (std::size_t first = 0; first < count; first += QuadChunk) {
+            sprites.count = std::min(QuadChunk, count - first);
+            for (std::size_t n = 0; n < sprites.count; n++) {
+                Entity i = entities[first + n];
+                sf::FloatRect uv = animators.getUV(i);
+                x[n] = prevX[i] + (posX[i] - prevX[i]) * alpha;
+                y[n] = prevY[i] + (posY[i] - prevY[i]) * alpha;
+                w[n] = width[i];
+                h[n] = height[i];
+                u[n] = uv.left; v[n] = uv.top; uw[n] = uv.width; vh[n] = uv.height;
+            }
+            quads.build(sprites, out + first * 4);
+        }
+    }
+
+public:
+    // Clips the prefabs refer to; must outlive the store and be set before spawning
+    void setAnimations(const AnimationLibrary& library) {
+        animators.setLibrary(library);
+    }
+
+    std::size_t size() const {
+        return posX.size();
+    }
+
+    void reserve(std::size_t count) {
+        for (auto* v : { &posX, &posY, &prevX, &prevY, &width, &height, &velX, &velY }) v->reserve(count);
+        layer.reserve(count);
+        live.reserve(count);
+        animators.reserve(count);
+    }
+
+    void clear() {
+        for (auto* v : { &posX, &posY, &prevX, &prevY, &width, &height, &velX, &velY }) v->clear();
+        layer.clear();
+        live.clear();
+        animators.clear();
+        layerIndex.clear();
+        active.clear();
+        visibleCount.clear();
+    }
+
+    Entity spawn(const Prefab& prefab, sf::Vector2f position, sf::Vector2f size) {
+        posX.push_back(position.x);
+        posY.push_back(position.y);
+        prevX.push_back(position.x);
+        prevY.push_back(position.y);
+        width.push_back(size.x);
+        height.push_back(size.y);
+        velX.push_back(prefab.velocity.x);
+        velY.push_back(prefab.velocity.y);
+        layer.push_back(prefab.layer);
+        live.push_back(1);
+        animators.add(prefab.clip, prefab.flipX);
+
+        Entity entity = static_cast<Entity>(posX.size() - 1);
+        if (prefab.layer >= layerIndex.size()) {
+            layerIndex.resize(prefab.layer + 1);
+            visibleCount.resize(prefab.layer + 1);
+        }
+        layerIndex[prefab.layer].insert(entity, bounds(entity));
+        return entity;
+    }
+
+    // Re-files an entity whose position or size a system changed directly
+    void refile(Entity entity) {
+        layerIndex[layer[entity]].update(entity, bounds(entity));
+    }
+
+    // Takes an entity out of the world: it stops moving and is never active
+    // or drawn again. Its slot stays, so other entity ids remain valid.
+    void despawn(Entity entity) {
+        velX[entity] = 0.f;
+        velY[entity] = 0.f;
+        live[entity] = 0;
+        layerIndex[layer[entity]].remove(entity);
+    }
+
+    // Every component that changes while the game runs. Sizes and render
+    // layers are fixed once the level is spawned, so width and layer are
+    // left out except for height, which a stomp changes.
+    void saveState(StateWriter& writer) const {
+        for (const auto* v : { &posX, &posY, &prevX, &prevY, &height, &velX, &velY }) writer.writeArray(*v);
+        writer.writeArray(live);
+        animators.saveState(writer);
+    }
+
+    // Restores a state saved from this store with the same entities, then
+    // re-files every live entity in its layer's hash and drops the rest
+    bool loadState(StateReader& reader) {
+        const std::size_t count = size();
+        for (auto* v : { &posX, &posY, &prevX, &prevY, &height, &velX, &velY }) {
+            if (!reader.readArray(*v) || v->size() != count)
+                return false;
+        }
+        if (!reader.readArray(live) || live.size() != count || !animators.loadState(reader))
+            return false;
+        for (std::size_t i = 0; i < count; i++) {
+            SpatialHash& index = layerIndex[layer[i]];
+            Entity entity = static_cast<Entity>(i);
+            if (!live[i])
+                index.remove(entity);
+            else if (index.contains(entity))
+                index.update(entity, bounds(i));
+            else
+                index.insert(entity, bounds(i));
+        }
+        return true;
+    }
+
+    // Motion system: integrate velocity; walkers stop once they reach min_x
+    void updateMotion(float dt, float min_x, JobSystem* jobs = nullptr) {
+        const std::size_t count = size();
+        forRange(jobs, count, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+                move(i, dt, min_x);
+        });
+        // The hash is shared, so re-filing stays on this thread
+        for (std::size_t i = 0; i < count; i++) {
+            if (velX[i] != 0.f || velY[i] != 0.f)
+                layerIndex[layer[i]].update(static_cast<Entity>(i), bounds(i));
+        }
+    }
+
+    // Animation system: advance every sprite by one simulation tick
+    void updateAnimation(JobSystem* jobs = nullptr) {
+        animators.update(jobs);
+    }
+
+    // Render system: appends one textured quad per entity of the layer,
+    // placed between its previous and current position
+    void appendQuads(std::uint8_t render_layer, sf::VertexArray& out, float alpha) const {
+        const std::size_t count = size();
+        Entity run[QuadChunk];
+        std::size_t pending = 0;
+        for (std::size_t i = 0; i <= count; i++) {
+            if (i < count && layer[i] == render_layer)
+                run[pending++] = static_cast<Entity>(i);
+            if (pending == QuadChunk || (i == count && pending > 0)) {
+                std::size_t first = out.getVertexCount();
+                out.resize(first + pending * 4);
+                writeQuads(run, pending, &out[first], alpha);
+                pending = 0;
+            }
+        }
+    }
+
+    // Starts a new active set; entities outside it are frozen until it reaches them
+    void clearActive() {
+        active.clear();
+    }
+
+    // Adds the layer's entities overlapping area (usually the view plus a margin) to the active set
+    void activate(std::uint8_t render_layer, const sf::FloatRect& area) {
+        if (render_layer < layerIndex.size())
+            layerIndex[render_layer].query(area, active);
+    }
+
+    // Entities selected since the last clearActive()
+    const std::vector<Entity>& getActive() const {
+        return active;
+    }
+
+    // Motion system over the active set only
+    void updateActiveMotion(float dt, float min_x, JobSystem* jobs = nullptr) {
+        forRange(jobs, active.size(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t n = begin; n < end; n++)
+                move(active[n], dt, min_x);
+        });
+        for (Entity i : active) {
+            if (velX[i] != 0.f || velY[i] != 0.f)
+                layerIndex[layer[i]].update(i, bounds(i));
+        }
+    }
+
+    // Animation system over the active set only
+    void updateActiveAnimation(JobSystem* jobs = nullptr) {
+        animators.update(active, jobs);
+    }
+
+    // Render system for the entities of a layer overlapping area; returns how many were appended
+    std::size_t appendVisibleQuads(std::uint8_t render_layer, const sf::FloatRect& area, sf::VertexArray& out, float alpha, JobSystem* jobs = nullptr) {
+        if (render_layer >= layerIndex.size())
+            return 0;
+        visible.clear();
+        layerIndex[render_layer].query(area, visible);
+
+        // Size the batch up front so every range writes its own quads in place
+        std::size_t first = out.getVertexCount();
+        out.resize(first + visible.size() * 4);
+        forRange(jobs, visible.size(), [&](std::size_t begin, std::size_t end) {
+            writeQuads(visible.data() + begin, end - begin, &out[first + begin * 4], alpha);
+        });
+        visibleCount[render_layer] = visible.size();
+        return visible.size();
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.total = size();
+        stats.active = active.size();
+        for (std::size_t count : visibleCount) stats.visible += count;
+        return stats;
+    }
+};
+
+// One line of a level's entity spawn table
+struct SpawnRecord {
+    std::string kind;
+    sf::Vector2f position;
+    sf::Vector2f size;
+};
+
+// Reads "kind x y width height" lines; blank lines and '#' comments are skipped
+inline std::vector<SpawnRecord> readSpawnTable(const std::string& path) {
+    std::vector<SpawnRecord> records;
+    std::ifstream file(path);
+    if (!file) {
+        LOG_ERROR << "Could not open spawn table " << path;
+        return records;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        SpawnRecord record;
+        if (fields >> record.kind >> record.position.x >> record.position.y >> record.size.x >> record.size.y)
+            records.push_back(record);
+    }
+    return records;
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Log.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// ─────────────────────────────────────────────
+// FileWatcher Class
+// Reports files written or replaced under a few directories, so content
+// can be reloaded while the game runs. On Linux the kernel queues inotify
+// events on a non-blocking descriptor and polling costs one read() when
+// nothing happened; elsewhere modification times are compared, at most
+// four times a second. Paths come back as the watched directory joined
+// with the file's path below it, e.g. "assets/img/gomma/walk-1.png".
+// ─────────────────────────────────────────────
+class FileWatcher {
+private:
+#ifdef __linux__
+    int fd = -1;
+    std::unordered_map<int, std::string> directories;   // Watch descriptor -> directory
+    alignas(inotify_event) char events[16 * 1024];
+
+    bool watchOne(const std::string& directory) {
+        int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+        if (wd < 0) {
+            LOG_ERROR << "Could not watch " << directory;
+            return false;
+        }
+        directories[wd] = directory;
+        return true;
+    }
+#else
+    std::vector<std::string> roots;
+    std::unordered_map<std::string, std::filesystem::file_time_type> times;
+    std::chrono::steady_clock::time_point nextScan;
+
+    // Records every file's modification time, appending those that changed since the last scan
+    void scan(const std::string& root, std::vector<std::string>* changed) {
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator it(root, error), end; it != end; it.increment(error)) {
+            if (error || !it->is_regular_file(error))
+                continue;
+            std::string path = it->path().generic_string();
+            std::filesystem::file_time_type time = it->last_write_time(error);
+            auto known = times.find(path);
+            if (known != times.end() && known->second == time)
+                continue;
+            bool isNew = known == times.end();
+            times[path] = time;
+            if (changed && !isNew && std::find(changed->begin(), changed->end(), path) == changed->end())
+                changed->push_back(path);
+        }
+    }
+#endif
+
+public:
+    FileWatcher() {
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            LOG_ERROR << "inotify is not available; files will not be watched";
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    ~FileWatcher() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    // Watches directory and every directory below it
+    bool watch(const std::string& directory) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error)) {
+            LOG_ERROR << "Cannot watch " << directory << ": not a directory";
+            return false;
+        }
+#ifdef __linux__
+        if (fd < 0 || !watchOne(directory))
+            return false;
+        for (std::filesystem::recursive_directory_iterator it(directory, error), end; it != end; it.increment(error)) {
+            if (!error && it->is_directory(error))
+                watchOne(it->path().generic_string());
+        }
+#else
+        roots.push_back(directory);
+        scan(directory, nullptr);
+#endif
+        return true;
+    }
+
+    // Appends each file written since the last call to changed, once; never
+    // blocks. Returns whether anything was appended.
+    bool poll(std::vector<std::string>& changed) {
+        std::size_t before = changed.size();
+#ifdef __linux__
+        if (fd < 0)
+            return false;
+        ssize_t length;
+        while ((length = read(fd, events, sizeof(events))) > 0) {
+            for (char* at = events; at < events + length;) {
+                const inotify_event& event = *reinterpret_cast<const inotify_event*>(at);
+                at += sizeof(inotify_event) + event.len;
+                auto directory = directories.find(event.wd);
+                if (event.len == 0 || directory == directories.end())
+                    continue;
+                std::string path = directory->second + "/" + event.name;
+                if (event.mask & IN_ISDIR) {
+                    if (event.mask & (IN_CREATE | IN_MOVED_TO))
+                        watchOne(path);
+                    continue;
+                }
+                // A created file is reported again once it has been written and closed
+                if ((event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && std::find(changed.begin() + before, changed.end(), path) == changed.end())
+                    changed.push_back(path);
+            }
+        }
+#else
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextScan)
+            return false;
+        nextScan = now + std::chrono::milliseconds(250);
+        for (const auto& root : roots) scan(root, &changed);
+#endif
+        return changed.size() > before;
+    }
+};
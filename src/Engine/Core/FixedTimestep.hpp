@@ -0,0 +1,74 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+// ─────────────────────────────────────────────
+// FixedTimestep Class
+// The single authoritative game clock. Real frame time is accumulated and
+// consumed in fixed simulation steps, so physics runs identically on slow and
+// fast machines; whatever is left over becomes the render interpolation factor.
+// ─────────────────────────────────────────────
+class FixedTimestep {
+private:
+    sf::Clock clock;
+    sf::Time step;
+    sf::Time maxFrameTime;          // Caps catch-up after a stall (window drag, breakpoint)
+    sf::Time accumulator = sf::Time::Zero;
+    std::uint64_t tick = 0;
+
+public:
+    explicit FixedTimestep(sf::Time init_step, sf::Time init_max_frame_time = sf::milliseconds(250))
+        : step(init_step), maxFrameTime(init_max_frame_time) {}
+
+    // Adds the real time elapsed since the previous frame to the accumulator
+    void beginFrame() {
+        sf::Time elapsed = clock.restart();
+        accumulator += elapsed < maxFrameTime ? elapsed : maxFrameTime;
+    }
+
+    // Adds a fixed amount of time instead of real time; headless runs feed
+    // exactly one step per frame so every run takes the same ticks
+    void addTime(sf::Time elapsed) {
+        accumulator += elapsed;
+    }
+
+    // Returns true while a full simulation step is pending, consuming it
+    bool shouldStep() {
+        if (accumulator < step)
+            return false;
+        accumulator -= step;
+        tick++;
+        return true;
+    }
+
+    // Fraction of a step left over, used to blend the previous and current state
+    float getAlpha() const {
+        return accumulator.asSeconds() / step.asSeconds();
+    }
+
+    float getStep() const {
+        return step.asSeconds();
+    }
+
+    std::uint64_t getTick() const {
+        return tick;
+    }
+
+    // Puts the clock back (or forward) to a tick already simulated; rollback
+    // resimulates from there without touching the accumulated real time
+    void setTick(std::uint64_t new_tick) {
+        tick = new_tick;
+    }
+
+    std::uint64_t ticksFromSeconds(float seconds) const {
+        return static_cast<std::uint64_t>(seconds / step.asSeconds() + 0.5f);
+    }
+};
+
+// Render states that draw an object at its interpolated position between two
+// simulation steps without touching the simulated transform itself
+inline sf::RenderStates interpolatedStates(sf::Vector2f previous, sf::Vector2f current, float alpha) {
+    sf::RenderStates states;
+    states.transform.translate((previous - current) * (1.f - alpha));
+    return states;
+}
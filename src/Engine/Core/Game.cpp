@@ -0,0 +1,270 @@
+#include "Engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "Log.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    constexpr int MapSize = 48;                     // Cells each way
+    constexpr float MinimapCell = 5.f;              // Minimap pixels per cell
+    const sf::Vector2f MinimapOrigin(16.f, 16.f);
+    constexpr float WalkSpeed = 3.f;                // Cells per second
+    constexpr float TurnSpeed = 2.f;                // Radians per second
+    constexpr float PlayerRadius = 0.2f;            // Cells kept clear between the camera and a wall
+
+    // Copy of image with every pixel multiplied by tint
+    sf::Image tinted(const sf::Image& image, sf::Color tint) {
+        sf::Image result = image;
+        for (unsigned int y = 0; y < result.getSize().y; y++) {
+            for (unsigned int x = 0; x < result.getSize().x; x++)
+                result.setPixel(x, y, result.getPixel(x, y) * tint);
+        }
+        return result;
+    }
+
+    Wall makeWall(sf::Vector2i from, sf::Vector2i to, std::uint8_t texture) {
+        Wall wall;
+        wall.corners = RectangleObj::getRectObjVector(from, sf::Vector2i(to.x, from.y), to, sf::Vector2i(from.x, to.y));
+        wall.texture = texture;
+        return wall;
+    }
+}
+
+namespace RectangleObj {
+    std::vector<sf::Vector2i> getRectObjVector(sf::Vector2i new_A, sf::Vector2i new_B, sf::Vector2i new_C, sf::Vector2i new_D) {
+        int left = std::min({ new_A.x, new_B.x, new_C.x, new_D.x }), right = std::max({ new_A.x, new_B.x, new_C.x, new_D.x });
+        int top = std::min({ new_A.y, new_B.y, new_C.y, new_D.y }), bottom = std::max({ new_A.y, new_B.y, new_C.y, new_D.y });
+        return { sf::Vector2i(left, top), sf::Vector2i(right, top), sf::Vector2i(right, bottom), sf::Vector2i(left, bottom) };
+    }
+}
+
+namespace WallObjActions {
+    void moveWall(Wall& wall, std::vector<sf::Vector2i> newPosition) {
+        if (newPosition.size() != 4)
+            return;
+        wall.corners = RectangleObj::getRectObjVector(newPosition[0], newPosition[1], newPosition[2], newPosition[3]);
+    }
+
+    void scaleWall(Wall& wall, float scale_size) {
+        if (wall.corners.empty() || scale_size <= 0.f)
+            return;
+        sf::Vector2i min = wall.getMin(), max = wall.getMax();
+        sf::Vector2f centre((min.x + max.x + 1) * 0.5f, (min.y + max.y + 1) * 0.5f);
+        sf::Vector2f half(std::max((max.x - min.x + 1) * scale_size, 1.f) * 0.5f, std::max((max.y - min.y + 1) * scale_size, 1.f) * 0.5f);
+        sf::Vector2i from(static_cast<int>(std::lround(centre.x - half.x)), static_cast<int>(std::lround(centre.y - half.y)));
+        sf::Vector2i to(std::max(static_cast<int>(std::lround(centre.x + half.x)) - 1, from.x), std::max(static_cast<int>(std::lround(centre.y + half.y)) - 1, from.y));
+        wall.corners = RectangleObj::getRectObjVector(from, sf::Vector2i(to.x, from.y), to, sf::Vector2i(from.x, to.y));
+    }
+}
+
+Game::Game(unsigned int thread_count) : jobs(thread_count), raycaster(1600, 900) {
+    window.create(sf::VideoMode(1600, 900), "Walls");
+    window.setVerticalSyncEnabled(true);
+
+    // Wall textures: the brick in three colours; sprites: the bush and a gomma
+    sf::Image brick, sky, bush, gomma;
+    if (!brick.loadFromFile("assets/img/brick-1.png")) {
+        LOG_ERROR << "Failed to load wall texture";
+        brick.create(64, 64, sf::Color(150, 60, 40));
+    }
+    raycaster.addTexture(brick);
+    raycaster.addTexture(tinted(brick, sf::Color(120, 150, 255)));
+    std::uint8_t movableTexture = static_cast<std::uint8_t>(raycaster.addTexture(tinted(brick, sf::Color(255, 230, 90))));
+    if (sky.loadFromFile("assets/img/main_bg.png"))
+        raycaster.setSky(sky);
+    std::uint16_t bushTexture = bush.loadFromFile("assets/img/bush.png") ? raycaster.addTexture(bush) : 0;
+    std::uint16_t gommaTexture = gomma.loadFromFile("assets/img/gomma/gomma-1.png") ? raycaster.addTexture(gomma) : 0;
+
+    // Border, a few rooms and pillars; the movable wall starts across the first corridor
+    walls.push_back(makeWall({ 0, 0 }, { MapSize - 1, 0 }, 1));
+    walls.push_back(makeWall({ 0, MapSize - 1 }, { MapSize - 1, MapSize - 1 }, 1));
+    walls.push_back(makeWall({ 0, 1 }, { 0, MapSize - 2 }, 1));
+    walls.push_back(makeWall({ MapSize - 1, 1 }, { MapSize - 1, MapSize - 2 }, 1));
+    walls.push_back(makeWall({ 8, 6 }, { 30, 6 }, 2));
+    walls.push_back(makeWall({ 30, 6 }, { 30, 20 }, 2));
+    walls.push_back(makeWall({ 12, 14 }, { 22, 15 }, 1));
+    walls.push_back(makeWall({ 6, 28 }, { 40, 28 }, 2));
+    walls.push_back(makeWall({ 40, 12 }, { 40, 28 }, 1));
+    for (int y = 34; y < 44; y += 4) {
+        for (int x = 6; x < 44; x += 5) walls.push_back(makeWall({ x, y }, { x, y }, static_cast<std::uint8_t>(1 + (x / 5) % 2)));
+    }
+    onewall = makeWall({ 4, 10 }, { 6, 10 }, movableTexture);
+
+    view.position = sf::Vector2f(3.5f, 3.5f);
+    view.angle = 0.8f;
+    background.setPosition(MinimapOrigin - sf::Vector2f(4.f, 4.f));
+    background.setSize(sf::Vector2f(MapSize * MinimapCell + 8.f, MapSize * MinimapCell + 8.f));
+    background.setFillColor(sf::Color(0, 0, 0, 160));
+    convex.setPointCount(3);
+    convex.setFillColor(sf::Color(255, 255, 255, 70));
+    rebuildMap();
+
+    // Sprites on free cells, the same ones every run
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> cell(1, MapSize - 2);
+    for (int i = 0; i < 60 && (bushTexture || gommaTexture); i++) {
+        sf::Vector2i at(cell(rng), cell(rng));
+        if (map.isSolid(at.x, at.y) || onewall.contains(at))
+            continue;
+        Raycaster::Sprite sprite;
+        sprite.position = sf::Vector2f(at.x + 0.5f, at.y + 0.5f);
+        sprite.texture = i % 3 == 0 && gommaTexture ? gommaTexture : (bushTexture ? bushTexture : gommaTexture);
+        sprite.scale = sprite.texture == gommaTexture ? 0.45f : 0.35f;
+        sprites.push_back(sprite);
+    }
+
+    if (!frameTexture.create(1600, 900))
+        LOG_ERROR << "Failed to create the raycast frame texture";
+    frame.setTexture(frameTexture);
+}
+
+void Game::run() {
+    frameClock.restart();
+    while (window.isOpen()) {
+        PROFILE_FRAME();
+        processEvents();
+        update();
+        render();
+    }
+}
+
+// Cell under a mouse position on the minimap; outside it that is off the map
+sf::Vector2i Game::cellAt(sf::Vector2i mouse_position) const {
+    sf::Vector2f local = (sf::Vector2f(mouse_position) - MinimapOrigin) / MinimapCell;
+    return sf::Vector2i(static_cast<int>(std::floor(local.x)), static_cast<int>(std::floor(local.y)));
+}
+
+sf::ConvexShape Game::minimapShape(const Wall& wall, sf::Color color) const {
+    sf::Vector2i min = wall.getMin(), max = wall.getMax();
+    sf::ConvexShape shape(4);
+    shape.setPoint(0, MinimapOrigin + sf::Vector2f(min.x * MinimapCell, min.y * MinimapCell));
+    shape.setPoint(1, MinimapOrigin + sf::Vector2f((max.x + 1) * MinimapCell, min.y * MinimapCell));
+    shape.setPoint(2, MinimapOrigin + sf::Vector2f((max.x + 1) * MinimapCell, (max.y + 1) * MinimapCell));
+    shape.setPoint(3, MinimapOrigin + sf::Vector2f(min.x * MinimapCell, (max.y + 1) * MinimapCell));
+    shape.setFillColor(color);
+    return shape;
+}
+
+// Stamps every wall into the grid and rebuilds their minimap outlines
+void Game::rebuildMap() {
+    map.resize(MapSize, MapSize);
+    wall_objects.clear();
+    auto stamp = [this](const Wall& wall, sf::Color color) {
+        sf::Vector2i min = wall.getMin(), max = wall.getMax();
+        for (int y = min.y; y <= max.y; y++) {
+            for (int x = min.x; x <= max.x; x++) map.set(x, y, wall.texture);
+        }
+        wall_objects.push_back(minimapShape(wall, color));
+    };
+    for (const auto& wall : walls) stamp(wall, sf::Color(170, 170, 170));
+    stamp(onewall, sf::Color(255, 220, 60));
+}
+
+// Drags the movable wall by whole cells as the mouse crosses them; a move
+// that would leave the map or cover the camera is refused
+void Game::moveWall(sf::Vector2i mouse_current_position) {
+    sf::Vector2i delta = cellAt(mouse_current_position) - cellAt(localPosition);
+    if (delta == sf::Vector2i())
+        return;
+    std::vector<sf::Vector2i> moved = onewall.corners;
+    for (auto& corner : moved) corner += delta;
+
+    Wall candidate = onewall;
+    WallObjActions::moveWall(candidate, moved);
+    sf::Vector2i min = candidate.getMin(), max = candidate.getMax();
+    sf::Vector2i camera(static_cast<int>(view.position.x), static_cast<int>(view.position.y));
+    if (min.x < 1 || min.y < 1 || max.x > MapSize - 2 || max.y > MapSize - 2 || candidate.contains(camera))
+        return;
+    onewall = candidate;
+    localPosition = mouse_current_position;
+    rebuildMap();
+}
+
+void Game::processEvents() {
+    sf::Event event;
+    while (window.pollEvent(event)) {
+        if (event.type == sf::Event::Closed || (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape))
+            window.close();
+        else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+            localPosition = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            dragging = onewall.contains(cellAt(localPosition));
+        }
+        else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left)
+            dragging = false;
+        else if (event.type == sf::Event::MouseMoved && dragging)
+            moveWall(sf::Vector2i(event.mouseMove.x, event.mouseMove.y));
+        else if (event.type == sf::Event::MouseWheelScrolled && onewall.contains(cellAt(sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y)))) {
+            Wall candidate = onewall;
+            WallObjActions::scaleWall(candidate, event.mouseWheelScroll.delta > 0.f ? 1.25f : 0.8f);
+            sf::Vector2i min = candidate.getMin(), max = candidate.getMax();
+            sf::Vector2i camera(static_cast<int>(view.position.x), static_cast<int>(view.position.y));
+            if (min.x >= 1 && min.y >= 1 && max.x <= MapSize - 2 && max.y <= MapSize - 2 && !candidate.contains(camera)) {
+                onewall = candidate;
+                rebuildMap();
+            }
+        }
+    }
+}
+
+// Walks and turns with the keyboard, sliding along walls one axis at a time
+void Game::update() {
+    float dt = std::min(frameClock.restart().asSeconds(), 0.1f);
+    titleTime += sf::seconds(dt);
+    if (!window.hasFocus())
+        return;
+
+    auto down = [](sf::Keyboard::Key a, sf::Keyboard::Key b) { return sf::Keyboard::isKeyPressed(a) || sf::Keyboard::isKeyPressed(b); };
+    float turn = (down(sf::Keyboard::Right, sf::Keyboard::D) ? 1.f : 0.f) - (down(sf::Keyboard::Left, sf::Keyboard::A) ? 1.f : 0.f);
+    float walk = (down(sf::Keyboard::Up, sf::Keyboard::W) ? 1.f : 0.f) - (down(sf::Keyboard::Down, sf::Keyboard::S) ? 1.f : 0.f);
+    view.angle += turn * TurnSpeed * dt;
+
+    sf::Vector2f step(std::cos(view.angle) * walk * WalkSpeed * dt, std::sin(view.angle) * walk * WalkSpeed * dt);
+    auto blocked = [this](float x, float y) {
+        return map.isSolid(static_cast<int>(std::floor(x - PlayerRadius)), static_cast<int>(std::floor(y - PlayerRadius))) ||
+            map.isSolid(static_cast<int>(std::floor(x + PlayerRadius)), static_cast<int>(std::floor(y - PlayerRadius))) ||
+            map.isSolid(static_cast<int>(std::floor(x - PlayerRadius)), static_cast<int>(std::floor(y + PlayerRadius))) ||
+            map.isSolid(static_cast<int>(std::floor(x + PlayerRadius)), static_cast<int>(std::floor(y + PlayerRadius)));
+    };
+    if (!blocked(view.position.x + step.x, view.position.y))
+        view.position.x += step.x;
+    if (!blocked(view.position.x, view.position.y + step.y))
+        view.position.y += step.y;
+}
+
+// Raycasts the frame on the CPU, streams it into the texture, then draws the minimap over it
+void Game::render() {
+    sf::Clock raycastClock;
+    raycaster.render(map, view, sprites, &jobs);
+    {
+        PROFILE_ZONE("Upload");
+        frameTexture.update(raycaster.getPixels());
+    }
+    raycastTime += raycastClock.getElapsedTime();
+    titleFrames++;
+
+    window.clear();
+    window.draw(frame);
+    window.draw(background);
+    for (const auto& shape : wall_objects) window.draw(shape);
+
+    float half = view.fieldOfView * 0.5f, reach = 8.f * MinimapCell;
+    sf::Vector2f eye = MinimapOrigin + view.position * MinimapCell;
+    convex.setPoint(0, eye);
+    convex.setPoint(1, eye + reach * sf::Vector2f(std::cos(view.angle - half), std::sin(view.angle - half)));
+    convex.setPoint(2, eye + reach * sf::Vector2f(std::cos(view.angle + half), std::sin(view.angle + half)));
+    window.draw(convex);
+    window.display();
+
+    // The game ships no font, so the frame rate goes in the title
+    if (titleTime >= sf::seconds(0.5f)) {
+        char title[128];
+        std::snprintf(title, sizeof(title), "Walls - %.0f fps, raycast + upload %.2f ms, %u threads", titleFrames / titleTime.asSeconds(),
+            raycastTime.asSeconds() * 1000.f / titleFrames, jobs.getThreadCount());
+        window.setTitle(title);
+        titleTime = sf::Time::Zero;
+        raycastTime = sf::Time::Zero;
+        titleFrames = 0;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ─────────────────────────────────────────────
+// FNV-1a
+// 64-bit FNV-1a over raw bytes, for state checksums, quick-save files and
+// the asset pack's identical-blob check. Pass the previous result as seed
+// to carry on over several ranges.
+// ─────────────────────────────────────────────
+namespace Fnv1a {
+    constexpr std::uint64_t OffsetBasis = 14695981039346656037ull;
+    constexpr std::uint64_t Prime = 1099511628211ull;
+
+    inline std::uint64_t hash(const void* data, std::size_t size, std::uint64_t seed = OffsetBasis) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            seed ^= bytes[i];
+            seed *= Prime;
+        }
+        return seed;
+    }
+}
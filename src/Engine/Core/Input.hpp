@@ -0,0 +1,186 @@
+#pragma once
+#include <SFML/Window/Keyboard.hpp>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Log.hpp"
+
+// Game buttons, independent of the device they come from
+enum InputButton : std::uint8_t {
+    LeftButton = 1 << 0,
+    RightButton = 1 << 1,
+    JumpButton = 1 << 2,
+    RunButton = 1 << 3,     // Held with a direction or jump for the fast variant
+};
+
+// Buttons held during one simulation tick
+struct InputState {
+    std::uint8_t buttons = 0;
+
+    bool isDown(InputButton button) const {
+        return (buttons & button) != 0;
+    }
+
+    bool operator==(const InputState& other) const {
+        return buttons == other.buttons;
+    }
+
+    bool operator!=(const InputState& other) const {
+        return buttons != other.buttons;
+    }
+};
+
+// ─────────────────────────────────────────────
+// InputSource Class
+// Where the game reads its buttons from each tick: the keyboard for normal
+// play, a script for headless and regression runs.
+// ─────────────────────────────────────────────
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    // Buttons held during the given simulation tick
+    virtual InputState poll(std::uint64_t tick) = 0;
+};
+
+// ─────────────────────────────────────────────
+// KeyboardInput Class
+// Arrow keys move, Space jumps, Left Shift runs and jumps higher
+// ─────────────────────────────────────────────
+class KeyboardInput : public InputSource {
+public:
+    InputState poll(std::uint64_t) override {
+        InputState state;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) state.buttons |= LeftButton;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) state.buttons |= RightButton;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) state.buttons |= JumpButton;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) state.buttons |= RunButton;
+        return state;
+    }
+};
+
+// ─────────────────────────────────────────────
+// Input scripts
+// One line per change: "<tick> <buttons...>", buttons being any of
+// left/right/jump/run or "none". The state holds until the next line;
+// blank lines and '#' comments are skipped.
+// ─────────────────────────────────────────────
+using InputScript = std::vector<std::pair<std::uint64_t, InputState>>;
+
+inline InputScript readInputScript(const std::string& path) {
+    InputScript script;
+    std::ifstream file(path);
+    if (!file) {
+        LOG_ERROR << "Could not open input script " << path;
+        return script;
+    }
+
+    std::string line, word;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::uint64_t tick;
+        if (!(fields >> tick))
+            continue;
+        InputState state;
+        while (fields >> word) {
+            if (word == "left") state.buttons |= LeftButton;
+            else if (word == "right") state.buttons |= RightButton;
+            else if (word == "jump") state.buttons |= JumpButton;
+            else if (word == "run") state.buttons |= RunButton;
+            else if (word != "none") LOG_WARNING << "Unknown button '" << word << "' in " << path;
+        }
+        script.emplace_back(tick, state);
+    }
+    return script;
+}
+
+inline bool writeInputScript(const std::string& path, const InputScript& script) {
+    std::ofstream file(path);
+    if (!file) {
+        LOG_ERROR << "Could not write input script " << path;
+        return false;
+    }
+    file << "# tick buttons\n";
+    for (const auto& [tick, state] : script) {
+        file << tick;
+        if (state.buttons == 0) file << " none";
+        if (state.isDown(LeftButton)) file << " left";
+        if (state.isDown(RightButton)) file << " right";
+        if (state.isDown(JumpButton)) file << " jump";
+        if (state.isDown(RunButton)) file << " run";
+        file << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// ─────────────────────────────────────────────
+// ScriptedInput Class
+// Replays an input script tick by tick. Ticks are polled in order; going
+// back to an earlier one (after a rewind) scans from the start again.
+// ─────────────────────────────────────────────
+class ScriptedInput : public InputSource {
+private:
+    InputScript script;
+    std::size_t next = 0;
+    InputState current;
+    std::uint64_t lastTick = 0;
+
+public:
+    explicit ScriptedInput(InputScript init_script) : script(std::move(init_script)) {}
+
+    InputState poll(std::uint64_t tick) override {
+        if (tick < lastTick) {
+            next = 0;
+            current = InputState();
+        }
+        lastTick = tick;
+        while (next < script.size() && script[next].first <= tick)
+            current = script[next++].second;
+        return current;
+    }
+
+    // Last tick at which the script changes state
+    std::uint64_t getLength() const {
+        return script.empty() ? 0 : script.back().first;
+    }
+};
+
+// ─────────────────────────────────────────────
+// RecordingInput Class
+// Passes another source through and keeps every state change, so a play
+// session can be saved and replayed headless later
+// ─────────────────────────────────────────────
+class RecordingInput : public InputSource {
+private:
+    InputSource& source;
+    InputScript recorded;
+    InputState last;
+
+public:
+    explicit RecordingInput(InputSource& init_source) : source(init_source) {
+        recorded.reserve(4096);
+    }
+
+    InputState poll(std::uint64_t tick) override {
+        // After a rewind the ticks from here on are played again
+        if (!recorded.empty() && tick <= recorded.back().first) {
+            while (!recorded.empty() && recorded.back().first >= tick) recorded.pop_back();
+            last = recorded.empty() ? InputState() : recorded.back().second;
+        }
+        InputState state = source.poll(tick);
+        if (recorded.empty() || state != last) {
+            recorded.emplace_back(tick, state);
+            last = state;
+        }
+        return state;
+    }
+
+    bool save(const std::string& path) const {
+        return writeInputScript(path, recorded);
+    }
+};
@@ -0,0 +1,293 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Profiler.hpp"
+
+// Completion count for a group of jobs; wait on it with JobSystem::wait().
+// Must outlive every job that signals it.
+struct JobCounter {
+    std::atomic<std::size_t> pending{ 0 };
+
+    bool isDone() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+// ─────────────────────────────────────────────
+// JobSystem Class
+// Fixed pool of worker threads, each with its own job deque. A thread pushes
+// and pops at the back of its own deque (newest first, still hot in cache)
+// and, once that is empty, steals the oldest job from the front of another
+// thread's deque, so uneven work spreads out without a shared queue.
+// The thread that created the system is participant 0 and runs jobs too
+// while it waits. Jobs are plain function pointers over an index range and
+// the deques are fixed-size rings, so submitting work never allocates.
+// ─────────────────────────────────────────────
+class JobSystem {
+public:
+    struct Stats {
+        std::uint64_t jobs = 0;             // Jobs executed
+        std::uint64_t steals = 0;           // Jobs taken from another thread's deque
+    };
+
+private:
+    struct Job {
+        void (*function)(void* context, std::size_t begin, std::size_t end) = nullptr;
+        void* context = nullptr;
+        std::size_t begin = 0, end = 0;
+        JobCounter* done = nullptr;         // Decremented once the job ran
+        const JobCounter* after = nullptr;  // Job is held back until this is done
+    };
+
+    // Ring buffer deque; owners use the back, thieves the front
+    struct WorkQueue {
+        static constexpr std::size_t Capacity = 4096;
+
+        std::mutex mutex;
+        std::vector<Job> jobs = std::vector<Job>(Capacity);
+        std::size_t head = 0, count = 0;
+
+        bool push(const Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == Capacity)
+                return false;
+            jobs[(head + count) % Capacity] = job;
+            count++;
+            return true;
+        }
+
+        bool pop(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0)
+                return false;
+            count--;
+            job = jobs[(head + count) % Capacity];
+            return true;
+        }
+
+        bool steal(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0)
+                return false;
+            job = jobs[head];
+            head = (head + 1) % Capacity;
+            count--;
+            return true;
+        }
+    };
+
+    std::vector<WorkQueue> queues;          // One per participant, index 0 = owner thread
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{ 0 };   // Jobs sitting in any deque
+    std::atomic<bool> running{ true };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::uint64_t> jobCount{ 0 };
+    std::atomic<std::uint64_t> stealCount{ 0 };
+
+    // Participant index of the calling thread in this system, 0 for any outside thread
+    std::size_t currentIndex() const {
+        return currentSystem() == this ? currentSlot() : 0;
+    }
+
+    static const JobSystem*& currentSystem() {
+        thread_local const JobSystem* system = nullptr;
+        return system;
+    }
+
+    static std::size_t& currentSlot() {
+        thread_local std::size_t slot = 0;
+        return slot;
+    }
+
+    void submit(const Job& job) {
+        if (job.done)
+            job.done->pending.fetch_add(1, std::memory_order_relaxed);
+        queued.fetch_add(1, std::memory_order_release);
+        if (!queues[currentIndex()].push(job)) {
+            // Deque full: running it here keeps progress without allocating
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            while (job.after && !job.after->isDone())
+                runOne(currentIndex());
+            execute(job);
+        }
+    }
+
+    void notifyWorkers(bool all) {
+        if (workers.empty())
+            return;
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        if (all)
+            wake.notify_all();
+        else
+            wake.notify_one();
+    }
+
+    void execute(const Job& job) {
+        PROFILE_ZONE("Job");
+        job.function(job.context, job.begin, job.end);
+        jobCount.fetch_add(1, std::memory_order_relaxed);
+        if (job.done)
+            job.done->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool takeJob(std::size_t index, Job& job) {
+        if (queued.load(std::memory_order_acquire) == 0)
+            return false;
+        if (queues[index].pop(job))
+            return true;
+        for (std::size_t i = 1; i < queues.size(); i++) {
+            if (queues[(index + i) % queues.size()].steal(job)) {
+                stealCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Runs one ready job if there is any; a job still waiting on its dependency goes back to the deque
+    bool runOne(std::size_t index) {
+        Job job;
+        if (!takeJob(index, job))
+            return false;
+        if (job.after && !job.after->isDone()) {
+            if (queues[index].push(job)) {
+                std::this_thread::yield();
+                return false;
+            }
+            while (!job.after->isDone())
+                runOne(index);
+        }
+        queued.fetch_sub(1, std::memory_order_acq_rel);
+        execute(job);
+        return true;
+    }
+
+    void workerLoop(std::size_t index) {
+        currentSystem() = this;
+        currentSlot() = index;
+        PROFILE_THREAD_NAME("Job worker " + std::to_string(index));
+        while (running.load(std::memory_order_acquire)) {
+            if (runOne(index))
+                continue;
+            // Spin briefly before sleeping; frames submit work in bursts
+            bool found = false;
+            for (int spin = 0; spin < 64 && !found; spin++) {
+                std::this_thread::yield();
+                found = queued.load(std::memory_order_acquire) != 0;
+            }
+            if (found)
+                continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() { return queued.load() != 0 || !running.load(); });
+        }
+    }
+
+    template <typename Function>
+    static void invokeRange(void* context, std::size_t begin, std::size_t end) {
+        (*static_cast<Function*>(context))(begin, end);
+    }
+
+    template <typename Function>
+    static void* contextOf(Function& function) {
+        return const_cast<void*>(static_cast<const void*>(&function));
+    }
+
+public:
+    // thread_count counts the calling thread too (0 = one per hardware thread)
+    explicit JobSystem(unsigned int thread_count = 0) {
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        queues = std::vector<WorkQueue>(thread_count);
+        currentSystem() = this;
+        currentSlot() = 0;
+        for (unsigned int i = 1; i < thread_count; i++)
+            workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem() {
+        running.store(false);
+        notifyWorkers(true);
+        for (auto& worker : workers) worker.join();
+        if (currentSystem() == this)
+            currentSystem() = nullptr;
+    }
+
+    unsigned int getThreadCount() const {
+        return static_cast<unsigned int>(queues.size());
+    }
+
+    // Queues task(begin, end) and counts it in done. With after set, the job
+    // does not start before that counter reaches zero. task is referenced,
+    // not copied, so it must stay alive until done is waited on.
+    template <typename Function>
+    void run(Function& task, JobCounter& done, const JobCounter* after = nullptr, std::size_t begin = 0, std::size_t end = 0) {
+        Job job;
+        job.function = &invokeRange<Function>;
+        job.context = contextOf(task);
+        job.begin = begin;
+        job.end = end;
+        job.done = &done;
+        job.after = after;
+        submit(job);
+        notifyWorkers(false);
+    }
+
+    // Runs queued jobs on this thread until the counter reaches zero
+    void wait(const JobCounter& counter) {
+        std::size_t index = currentIndex();
+        while (!counter.isDone()) {
+            if (!runOne(index))
+                std::this_thread::yield();
+        }
+    }
+
+    // Calls body(begin, end) over [0, count) in ranges of at least grain
+    // items, spread across the pool, and returns once all of them ran.
+    // Ranges that fit in one grain run inline with no synchronization.
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t grain, Function&& body) {
+        if (count == 0)
+            return;
+        grain = std::max<std::size_t>(grain, 1);
+        if (count <= grain || queues.size() == 1) {
+            body(std::size_t(0), count);
+            return;
+        }
+
+        // About four ranges per thread leaves room to balance by stealing
+        std::size_t ranges = std::min((count + grain - 1) / grain, queues.size() * 4);
+        std::size_t step = (count + ranges - 1) / ranges;
+        JobCounter done;
+        Job job;
+        job.function = &invokeRange<std::remove_reference_t<Function>>;
+        job.context = contextOf(body);
+        job.done = &done;
+        for (std::size_t begin = step; begin < count; begin += step) {
+            job.begin = begin;
+            job.end = std::min(begin + step, count);
+            submit(job);
+        }
+        notifyWorkers(true);
+        body(std::size_t(0), std::min(step, count));
+        wait(done);
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.jobs = jobCount.load();
+        stats.steals = stealCount.load();
+        return stats;
+    }
+};
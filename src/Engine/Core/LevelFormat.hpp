@@ -0,0 +1,329 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Log.hpp"
+#include "MappedFile.hpp"
+
+// ─────────────────────────────────────────────
+// Binary level format (.lvl)
+//
+//   Header
+//   LayerInfo[layerCount]
+//   KindName[kindCount]                 entity kind names, indexed by SpawnEntry::kind
+//   ParallaxInfo[parallaxCount]         decoration layers, back to front
+//   SpawnEntry[spawnCount]              sorted by x
+//   chunk data at tileOffset            chunk c, layer l starts at
+//                                       tileOffset + (c * layerCount + l) * chunkBytes
+//
+// A chunk is chunkColumns x rows tile ids, row-major, so every layer of one
+// chunk is a single contiguous range. The last chunk is zero padded. Values
+// are in the byte order of the machine that wrote the file (little-endian
+// on every platform the game builds for); a file from a machine of the
+// other order fails the magic check. Every section is 8-byte aligned so
+// records can be read straight out of the mapping.
+// ─────────────────────────────────────────────
+namespace LevelFormat {
+    constexpr std::uint32_t Magic = 0x314C564C;     // "LVL1"
+    constexpr std::uint16_t Version = 2;
+
+    struct Header {
+        std::uint32_t magic = Magic;
+        std::uint16_t version = Version;
+        std::uint16_t layerCount = 0;
+        std::uint32_t columns = 0;          // Level width in tiles
+        std::uint16_t rows = 0;
+        std::uint16_t chunkColumns = 0;     // Streaming granularity in tiles
+        float tileWidth = 0.f, tileHeight = 0.f;
+        float originX = 0.f, originY = 0.f; // World position of tile (0, 0)
+        std::uint32_t kindCount = 0;
+        std::uint32_t spawnCount = 0;
+        std::uint32_t parallaxCount = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t layerOffset = 0;
+        std::uint64_t kindOffset = 0;
+        std::uint64_t parallaxOffset = 0;
+        std::uint64_t spawnOffset = 0;
+        std::uint64_t tileOffset = 0;
+    };
+
+    enum LayerFlags : std::uint32_t {
+        SolidLayer = 1u << 0,               // Non-empty tiles block movement
+    };
+
+    struct LayerInfo {
+        char name[12] = {};
+        std::uint32_t flags = 0;
+    };
+
+    struct KindName {
+        char name[16] = {};
+    };
+
+    // Spawns whose kind bit is set in kindMask are static decorations of
+    // this layer, positioned in its scrolled space; the game composites
+    // them into cached strips instead of spawning entities
+    struct ParallaxInfo {
+        char name[12] = {};
+        float scrollFactor = 1.f;       // 0 = pinned to the screen, 1 = moves with the world
+        std::uint32_t kindMask = 0;     // Bit k = kind k
+        std::uint32_t reserved = 0;
+    };
+
+    struct SpawnEntry {
+        std::uint32_t kind = 0;
+        float x = 0.f, y = 0.f, width = 0.f, height = 0.f;
+    };
+
+    inline std::uint64_t align8(std::uint64_t offset) {
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+
+    // Whole level in memory, as produced by the converter before writing
+    struct LevelData {
+        Header header;
+        std::vector<LayerInfo> layers;
+        std::vector<std::vector<std::uint8_t>> tiles;   // Per layer, columns x rows, row-major
+        std::vector<KindName> kinds;
+        std::vector<ParallaxInfo> parallax;
+        std::vector<SpawnEntry> spawns;
+    };
+
+    // Returns the kind index for a name, appending it on first use
+    inline std::uint32_t kindIndex(LevelData& level, const std::string& name) {
+        for (std::size_t i = 0; i < level.kinds.size(); i++) {
+            if (name == level.kinds[i].name)
+                return static_cast<std::uint32_t>(i);
+        }
+        KindName kind;
+        std::strncpy(kind.name, name.c_str(), sizeof(kind.name) - 1);
+        level.kinds.push_back(kind);
+        return static_cast<std::uint32_t>(level.kinds.size() - 1);
+    }
+
+    // Writes next to path and renames over it, so a game that has the old
+    // file mapped keeps reading it intact and a watcher sees one replacement
+    inline bool writeLevel(const std::string& path, LevelData level) {
+        Header& header = level.header;
+        if (header.chunkColumns == 0 || level.tiles.size() != level.layers.size()) {
+            LOG_ERROR << "Invalid level data for " << path;
+            return false;
+        }
+        if (!level.parallax.empty() && level.kinds.size() > 32) {
+            LOG_ERROR << "Parallax layers in " << path << " can only refer to the first 32 entity kinds";
+            return false;
+        }
+        std::sort(level.spawns.begin(), level.spawns.end(), [](const SpawnEntry& a, const SpawnEntry& b) { return a.x < b.x; });
+
+        header.layerCount = static_cast<std::uint16_t>(level.layers.size());
+        header.kindCount = static_cast<std::uint32_t>(level.kinds.size());
+        header.spawnCount = static_cast<std::uint32_t>(level.spawns.size());
+        header.parallaxCount = static_cast<std::uint32_t>(level.parallax.size());
+        header.layerOffset = align8(sizeof(Header));
+        header.kindOffset = align8(header.layerOffset + sizeof(LayerInfo) * level.layers.size());
+        header.parallaxOffset = align8(header.kindOffset + sizeof(KindName) * level.kinds.size());
+        header.spawnOffset = align8(header.parallaxOffset + sizeof(ParallaxInfo) * level.parallax.size());
+        header.tileOffset = align8(header.spawnOffset + sizeof(SpawnEntry) * level.spawns.size());
+
+        std::string temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file) {
+            LOG_ERROR << "Could not write " << temporary;
+            return false;
+        }
+        auto padTo = [&file](std::uint64_t offset) {
+            while (static_cast<std::uint64_t>(file.tellp()) < offset) file.put('\0');
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        padTo(header.layerOffset);
+        file.write(reinterpret_cast<const char*>(level.layers.data()), sizeof(LayerInfo) * level.layers.size());
+        padTo(header.kindOffset);
+        file.write(reinterpret_cast<const char*>(level.kinds.data()), sizeof(KindName) * level.kinds.size());
+        padTo(header.parallaxOffset);
+        file.write(reinterpret_cast<const char*>(level.parallax.data()), sizeof(ParallaxInfo) * level.parallax.size());
+        padTo(header.spawnOffset);
+        file.write(reinterpret_cast<const char*>(level.spawns.data()), sizeof(SpawnEntry) * level.spawns.size());
+        padTo(header.tileOffset);
+
+        std::size_t chunkCount = (header.columns + header.chunkColumns - 1) / header.chunkColumns;
+        std::vector<std::uint8_t> chunk(static_cast<std::size_t>(header.chunkColumns) * header.rows);
+        for (std::size_t c = 0; c < chunkCount; c++) {
+            for (const auto& tiles : level.tiles) {
+                std::fill(chunk.begin(), chunk.end(), std::uint8_t(0));
+                for (std::size_t row = 0; row < header.rows; row++) {
+                    for (std::size_t column = 0; column < header.chunkColumns; column++) {
+                        std::size_t levelColumn = c * header.chunkColumns + column;
+                        if (levelColumn < header.columns)
+                            chunk[row * header.chunkColumns + column] = tiles[row * header.columns + levelColumn];
+                    }
+                }
+                file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+            }
+        }
+        file.close();
+        std::error_code error;
+        if (!file || (std::filesystem::rename(temporary, path, error), error)) {
+            LOG_ERROR << "Could not write " << path;
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+}
+
+// ─────────────────────────────────────────────
+// ChunkedLevel Class
+// A memory-mapped .lvl file. Opening only validates the header, so load
+// time does not depend on the level length; chunk tiles and spawn records
+// are read in place straight from the mapping.
+// ─────────────────────────────────────────────
+class ChunkedLevel {
+public:
+    struct ReloadResult {
+        bool layoutChanged = false;             // Size, chunking or layers differ; every chunk counts as changed
+        bool spawnsChanged = false;             // Spawn, kind or parallax records differ
+        std::vector<std::size_t> changedChunks; // Same layout: chunks with any tile changed, ascending
+    };
+
+private:
+    MappedFile file;
+    LevelFormat::Header header;
+    std::size_t chunkCount = 0;
+    std::size_t chunkBytes = 0;     // One layer of one chunk
+
+    template <typename T>
+    const T* section(std::uint64_t offset) const {
+        return reinterpret_cast<const T*>(file.getData() + offset);
+    }
+
+public:
+    bool open(const std::string& path) {
+        if (!file.open(path))
+            return false;
+        if (file.getSize() < sizeof(LevelFormat::Header)) {
+            LOG_ERROR << "Level file " << path << " is truncated";
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.getData(), sizeof(header));
+        if (header.magic != LevelFormat::Magic || header.version != LevelFormat::Version || header.chunkColumns == 0) {
+            LOG_ERROR << "Level file " << path << " has an unsupported format";
+            file.close();
+            return false;
+        }
+
+        chunkCount = (header.columns + header.chunkColumns - 1) / header.chunkColumns;
+        chunkBytes = static_cast<std::size_t>(header.chunkColumns) * header.rows;
+
+        // Every section lies aligned inside the file, so records are read out
+        // of the mapping unchecked; reload() compares kindOffset..tileOffset
+        std::uint64_t size = file.getSize();
+        auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t element) {
+            return offset % 8 == 0 && offset <= size && (element == 0 || count <= (size - offset) / element);
+        };
+        if (!fits(header.layerOffset, header.layerCount, sizeof(LevelFormat::LayerInfo))
+            || !fits(header.kindOffset, header.kindCount, sizeof(LevelFormat::KindName))
+            || !fits(header.parallaxOffset, header.parallaxCount, sizeof(LevelFormat::ParallaxInfo))
+            || !fits(header.spawnOffset, header.spawnCount, sizeof(LevelFormat::SpawnEntry))
+            || !fits(header.tileOffset, static_cast<std::uint64_t>(chunkCount) * header.layerCount, chunkBytes)
+            || header.kindOffset > header.tileOffset) {
+            LOG_ERROR << "Level file " << path << " is truncated or damaged";
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    // Maps path again after it was rewritten and compares the two versions
+    // chunk by chunk, a whole chunk (every layer) per memcmp. False, with
+    // the old file still mapped, if the new one does not open.
+    bool reload(const std::string& path, ReloadResult& result) {
+        ChunkedLevel next;
+        if (!next.open(path))
+            return false;
+
+        result = ReloadResult();
+        const LevelFormat::Header& a = header;
+        const LevelFormat::Header& b = next.header;
+        result.layoutChanged = a.layerCount != b.layerCount || a.columns != b.columns || a.rows != b.rows || a.chunkColumns != b.chunkColumns
+            || a.tileWidth != b.tileWidth || a.tileHeight != b.tileHeight || a.originX != b.originX || a.originY != b.originY
+            || std::memcmp(section<LevelFormat::LayerInfo>(a.layerOffset), next.section<LevelFormat::LayerInfo>(b.layerOffset), sizeof(LevelFormat::LayerInfo) * a.layerCount) != 0;
+        result.spawnsChanged = a.kindCount != b.kindCount || a.spawnCount != b.spawnCount || a.parallaxCount != b.parallaxCount
+            || a.tileOffset - a.kindOffset != b.tileOffset - b.kindOffset || std::memcmp(file.getData() + a.kindOffset, next.file.getData() + b.kindOffset, a.tileOffset - a.kindOffset) != 0;
+        if (!result.layoutChanged) {
+            std::size_t bytes = header.layerCount * chunkBytes;
+            for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+                if (std::memcmp(getChunkTiles(chunk, 0), next.getChunkTiles(chunk, 0), bytes) != 0)
+                    result.changedChunks.push_back(chunk);
+            }
+        }
+
+        file.swap(next.file);
+        header = next.header;
+        chunkCount = next.chunkCount;
+        chunkBytes = next.chunkBytes;
+        return true;
+    }
+
+    bool isOpen() const { return file.isOpen(); }
+    unsigned int getColumns() const { return header.columns; }
+    unsigned int getRows() const { return header.rows; }
+    unsigned int getChunkColumns() const { return header.chunkColumns; }
+    std::size_t getChunkCount() const { return chunkCount; }
+    std::size_t getLayerCount() const { return header.layerCount; }
+    sf::Vector2f getTileSize() const { return sf::Vector2f(header.tileWidth, header.tileHeight); }
+    sf::Vector2f getOrigin() const { return sf::Vector2f(header.originX, header.originY); }
+    std::size_t getFileSize() const { return file.getSize(); }
+
+    float getWidth() const {
+        return header.columns * header.tileWidth;
+    }
+
+    const LevelFormat::LayerInfo& getLayer(std::size_t layer) const {
+        return section<LevelFormat::LayerInfo>(header.layerOffset)[layer];
+    }
+
+    // Row-major chunkColumns x rows tile ids of one layer of a chunk
+    const std::uint8_t* getChunkTiles(std::size_t chunk, std::size_t layer) const {
+        return file.getData() + header.tileOffset + (chunk * header.layerCount + layer) * chunkBytes;
+    }
+
+    // Asks the OS to page a chunk in before it is needed
+    void prefetchChunk(std::size_t chunk) const {
+        if (chunk < chunkCount)
+            file.prefetch(header.tileOffset + chunk * header.layerCount * chunkBytes, header.layerCount * chunkBytes);
+    }
+
+    std::size_t getSpawnCount() const { return header.spawnCount; }
+    std::size_t getParallaxCount() const { return header.parallaxCount; }
+
+    const LevelFormat::ParallaxInfo& getParallax(std::size_t index) const {
+        return section<LevelFormat::ParallaxInfo>(header.parallaxOffset)[index];
+    }
+
+    // Parallax layer a kind is composited into, or -1 for spawned entities
+    int getParallaxOfKind(std::uint32_t kind) const {
+        for (std::size_t i = 0; kind < 32 && i < header.parallaxCount; i++) {
+            if (getParallax(i).kindMask & (1u << kind))
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    const LevelFormat::SpawnEntry& getSpawn(std::size_t index) const {
+        return section<LevelFormat::SpawnEntry>(header.spawnOffset)[index];
+    }
+
+    std::string getKindName(std::uint32_t kind) const {
+        if (kind >= header.kindCount)
+            return std::string();
+        const char* name = section<LevelFormat::KindName>(header.kindOffset)[kind].name;
+        return std::string(name, std::find(name, name + sizeof(LevelFormat::KindName::name), '\0'));
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "Entities.hpp"
+#include "LevelFormat.hpp"
+#include "Log.hpp"
+
+// ─────────────────────────────────────────────
+// Text level sources
+// The hand-edited files a .lvl is converted from, used by level_convert
+// and by the game's --watch mode:
+//
+//   brick.dat       one '0'/'1' per column; every '1' becomes a full
+//                   column of bricks
+//   entities.dat    the "kind x y width height" spawn table
+//   parallax.dat    optional decoration layers back to front, one per line
+//                   as "name scroll_factor kind...": spawns of those kinds
+//                   are composited into the layer instead of becoming
+//                   entities
+// ─────────────────────────────────────────────
+namespace LevelSource {
+    // Ground layout used by the game: 10 rows of 50 px bricks starting at y = 550
+    constexpr unsigned int GroundRows = 10;
+    constexpr float TileSize = 50.f;
+    constexpr float GroundTop = 550.f;
+    constexpr std::uint8_t BrickTile = 1;
+
+    // Fills level from the text files; parallax_path may be empty
+    inline bool read(const std::string& brick_path, const std::string& entities_path, const std::string& parallax_path,
+        unsigned int chunk_columns, LevelFormat::LevelData& level) {
+        std::ifstream bricks(brick_path);
+        if (!bricks) {
+            LOG_ERROR << "Could not open " << brick_path;
+            return false;
+        }
+        std::string layout;
+        char ch;
+        while (bricks.get(ch)) {
+            if (ch == '0' || ch == '1') layout.push_back(ch);
+        }
+
+        level = LevelFormat::LevelData();
+        level.header.columns = static_cast<std::uint32_t>(layout.size());
+        level.header.rows = GroundRows;
+        level.header.chunkColumns = static_cast<std::uint16_t>(chunk_columns);
+        level.header.tileWidth = level.header.tileHeight = TileSize;
+        level.header.originY = GroundTop;
+
+        LevelFormat::LayerInfo ground;
+        std::snprintf(ground.name, sizeof(ground.name), "ground");
+        ground.flags = LevelFormat::SolidLayer;
+        level.layers.push_back(ground);
+        level.tiles.emplace_back(layout.size() * GroundRows, std::uint8_t(0));
+        for (std::size_t column = 0; column < layout.size(); column++) {
+            if (layout[column] != '1')
+                continue;
+            for (std::size_t row = 0; row < GroundRows; row++)
+                level.tiles[0][row * layout.size() + column] = BrickTile;
+        }
+
+        if (!parallax_path.empty()) {
+            std::ifstream parallax(parallax_path);
+            if (!parallax) {
+                LOG_ERROR << "Could not open " << parallax_path;
+                return false;
+            }
+            std::string line, name, kind;
+            while (std::getline(parallax, line)) {
+                if (line.empty() || line[0] == '#')
+                    continue;
+                std::istringstream fields(line);
+                LevelFormat::ParallaxInfo layer;
+                if (!(fields >> name >> layer.scrollFactor))
+                    continue;
+                std::snprintf(layer.name, sizeof(layer.name), "%s", name.c_str());
+                while (fields >> kind) {
+                    std::uint32_t index = LevelFormat::kindIndex(level, kind);
+                    if (index < 32)
+                        layer.kindMask |= 1u << index;
+                }
+                level.parallax.push_back(layer);
+            }
+        }
+
+        for (const auto& record : readSpawnTable(entities_path)) {
+            LevelFormat::SpawnEntry spawn;
+            spawn.kind = LevelFormat::kindIndex(level, record.kind);
+            spawn.x = record.position.x;
+            spawn.y = record.position.y;
+            spawn.width = record.size.x;
+            spawn.height = record.size.y;
+            level.spawns.push_back(spawn);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "Collision.hpp"
+#include "LevelFormat.hpp"
+#include "TileMap.hpp"
+
+// ─────────────────────────────────────────────
+// LevelStreamer Class
+// Keeps a fixed window of level chunks resident around the camera. Chunks
+// live in a ring of slots (chunk c always uses slot c % slotCount), so
+// scrolling one chunk forward overwrites the chunk that fell out behind and
+// memory stays the same whatever the level length. Each slot holds one tile
+// map per level layer, and the collision grid covers exactly the window.
+// ─────────────────────────────────────────────
+class LevelStreamer : public sf::Drawable {
+public:
+    struct Stats {
+        unsigned int residentChunks = 0;    // Slots holding a chunk of the level
+        unsigned int chunkLoads = 0;        // Chunks copied in from the level file so far
+        unsigned int chunkReloads = 0;      // Resident chunks rebuilt after the level file changed
+        std::size_t residentTiles = 0;      // Tile ids held across slot maps
+        unsigned int drawnChunks = 0;       // Slots that overlapped the view in the last draw
+    };
+
+private:
+    static constexpr long NoChunk = std::numeric_limits<long>::min();     // Slot or window not loaded yet
+
+    struct Slot {
+        long chunk = NoChunk;
+        std::vector<TileMap> layers;
+    };
+
+    struct TileTexture {
+        const sf::Texture* texture;
+        sf::IntRect rect;
+    };
+
+    const ChunkedLevel* level = nullptr;
+    std::vector<Slot> slots;
+    std::vector<TileTexture> tileTextures;  // Registered in tile id order
+    CollisionGrid collision;
+    long windowFirst = NoChunk;             // First chunk of the resident window
+    float chunkWidth = 0.f;
+    mutable Stats stats;                    // drawnChunks is counted while drawing or recording
+
+    void loadChunk(Slot& slot, long chunk) {
+        slot.chunk = chunk;
+        bool inLevel = chunk >= 0 && static_cast<std::size_t>(chunk) < level->getChunkCount();
+        if (inLevel)
+            stats.chunkLoads++;
+
+        unsigned int columns = level->getChunkColumns(), rows = level->getRows();
+        for (std::size_t l = 0; l < slot.layers.size(); l++) {
+            TileMap& map = slot.layers[l];
+            map.resize(columns, rows, level->getTileSize());
+            map.setPosition(level->getOrigin().x + chunk * chunkWidth, level->getOrigin().y);
+            if (inLevel) {
+                const std::uint8_t* tiles = level->getChunkTiles(static_cast<std::size_t>(chunk), l);
+                for (unsigned int row = 0; row < rows; row++) {
+                    for (unsigned int column = 0; column < columns; column++)
+                        map.setTile(column, row, tiles[row * columns + column]);
+                }
+            }
+            map.rebuild();
+        }
+    }
+
+    // Writes a slot's solid tiles (non-empty in any solid layer) into its
+    // columns of the collision window
+    void fillCollision(const Slot& slot) {
+        unsigned int columns = level->getChunkColumns(), rows = level->getRows();
+        int firstColumn = static_cast<int>((slot.chunk - windowFirst) * columns);
+        for (unsigned int row = 0; row < rows; row++) {
+            for (unsigned int column = 0; column < columns; column++) {
+                bool solid = false;
+                for (std::size_t l = 0; l < slot.layers.size() && !solid; l++)
+                    solid = (level->getLayer(l).flags & LevelFormat::SolidLayer) && slot.layers[l].getTile(column, row) != TileMap::EmptyTile;
+                collision.setSolid(firstColumn + static_cast<int>(column), static_cast<int>(row), solid);
+            }
+        }
+    }
+
+    // Re-fills the collision window from the solid layers of every slot
+    void rebuildCollision() {
+        unsigned int columns = level->getChunkColumns(), rows = level->getRows();
+        sf::Vector2f origin(level->getOrigin().x + windowFirst * chunkWidth, level->getOrigin().y);
+        collision.resize(static_cast<unsigned int>(slots.size()) * columns, rows, origin, level->getTileSize());
+        for (const auto& slot : slots) fillCollision(slot);
+    }
+
+public:
+    // Prepares enough slots to cover view_width plus one chunk of margin on each side
+    void attach(const ChunkedLevel& new_level, float view_width) {
+        level = &new_level;
+        chunkWidth = level->getChunkColumns() * level->getTileSize().x;
+        std::size_t slotCount = static_cast<std::size_t>(std::ceil(view_width / chunkWidth)) + 3;
+
+        slots.assign(slotCount, Slot());
+        for (auto& slot : slots) {
+            slot.layers.resize(level->getLayerCount());
+            for (auto& map : slot.layers) {
+                map.resize(level->getChunkColumns(), level->getRows(), level->getTileSize());
+                for (const auto& tile : tileTextures) map.addTexture(*tile.texture, tile.rect);
+                map.reserveBatches();
+            }
+        }
+        windowFirst = NoChunk;
+        stats = Stats();
+    }
+
+    // Registers the texture for the next tile id (1, 2, ...) across every layer
+    std::uint8_t addTileTexture(const sf::Texture& texture, sf::IntRect rect = sf::IntRect()) {
+        tileTextures.push_back(TileTexture{ &texture, rect });
+        for (auto& slot : slots) {
+            for (auto& map : slot.layers) {
+                map.addTexture(texture, rect);
+                map.reserveBatches();
+            }
+        }
+        return static_cast<std::uint8_t>(tileTextures.size());
+    }
+
+    // Streams in the chunks around the visible world rectangle; cheap when
+    // the window has not moved since the last call
+    void update(const sf::FloatRect& visible) {
+        if (!level || slots.empty())
+            return;
+        long first = static_cast<long>(std::floor((visible.left - level->getOrigin().x) / chunkWidth)) - 1;
+        if (first == windowFirst)
+            return;
+        windowFirst = first;
+
+        for (long chunk = first; chunk < first + static_cast<long>(slots.size()); chunk++) {
+            std::size_t index = static_cast<std::size_t>(((chunk % static_cast<long>(slots.size())) + static_cast<long>(slots.size())) % static_cast<long>(slots.size()));
+            if (slots[index].chunk != chunk)
+                loadChunk(slots[index], chunk);
+        }
+        level->prefetchChunk(static_cast<std::size_t>(first + static_cast<long>(slots.size())));
+        rebuildCollision();
+
+        stats.residentChunks = 0;
+        stats.residentTiles = 0;
+        for (const auto& slot : slots) {
+            if (slot.chunk >= 0 && static_cast<std::size_t>(slot.chunk) < level->getChunkCount())
+                stats.residentChunks++;
+            stats.residentTiles += slot.layers.size() * level->getChunkColumns() * level->getRows();
+        }
+    }
+
+    // After the level was reloaded with the same layout: rebuilds the
+    // geometry and collision of the resident chunks among changed (as listed
+    // by ChunkedLevel::reload) and leaves every other slot alone. Chunks
+    // not resident stream in from the new data when the camera gets there.
+    unsigned int reloadChunks(const std::vector<std::size_t>& changed) {
+        if (!level || windowFirst == NoChunk)
+            return 0;
+        unsigned int rebuilt = 0;
+        for (auto& slot : slots) {
+            if (slot.chunk < 0 || !std::binary_search(changed.begin(), changed.end(), static_cast<std::size_t>(slot.chunk)))
+                continue;
+            loadChunk(slot, slot.chunk);
+            fillCollision(slot);
+            rebuilt++;
+        }
+        stats.chunkReloads += rebuilt;
+        return rebuilt;
+    }
+
+    // Solid tiles of the resident window; anything outside it reads as empty
+    const CollisionGrid& getCollision() const {
+        return collision;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+    // Records the tile maps of every chunk the view overlaps. The list gets
+    // copies of their vertices, or names the ones the player already keeps
+    // on the GPU, so streaming may carry on while it is drawn.
+    void record(RenderCommandList& list, const sf::View& view, const sf::RenderStates& states = sf::RenderStates::Default) const {
+        forEachVisible(view, [&](const TileMap& map) { map.record(list, states); });
+    }
+
+private:
+    // Calls draw_map for each tile map of the slots inside the view; the
+    // margin chunks are there for collision and streaming, not for drawing
+    template <typename Function>
+    void forEachVisible(const sf::View& view, Function&& draw_map) const {
+        stats.drawnChunks = 0;
+        if (!level)
+            return;
+        float left = view.getCenter().x - view.getSize().x / 2.f;
+        float right = left + view.getSize().x;
+        for (const auto& slot : slots) {
+            float chunkLeft = level->getOrigin().x + slot.chunk * chunkWidth;
+            if (slot.chunk == NoChunk || chunkLeft >= right || chunkLeft + chunkWidth <= left)
+                continue;
+            for (const auto& map : slot.layers) draw_map(map);
+            stats.drawnChunks++;
+        }
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        forEachVisible(target.getView(), [&](const TileMap& map) { target.draw(map, states); });
+    }
+};
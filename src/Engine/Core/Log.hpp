@@ -0,0 +1,322 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warning, 4 error.
+// Calls below it are removed at compile time, arguments included.
+#ifndef ENGINE3D_LOG_LEVEL
+#define ENGINE3D_LOG_LEVEL 2
+#endif
+
+// ─────────────────────────────────────────────
+// Logging
+// Call sites format a line into a fixed-size record on the stack and push
+// it into a bounded lock-free queue; a background thread drains the queue
+// to stdout/stderr and, optionally, a log file. The calling thread never
+// touches a stream, takes a lock or allocates, so logging from the game
+// loop costs a few dozen nanoseconds. When the queue is full the line is
+// dropped and counted instead of blocking the frame.
+//
+//   LOG_INFO << "Loaded " << count << " textures";
+//   LOG_ERROR << "Failed to load texture " << path;
+// ─────────────────────────────────────────────
+namespace Log {
+    enum Level : std::uint8_t { Trace, Debug, Info, Warning, Error };
+
+    constexpr Level CompiledLevel = static_cast<Level>(ENGINE3D_LOG_LEVEL);
+
+    struct Record {
+        static constexpr std::size_t TextSize = 240;
+
+        std::int64_t time = 0;              // Microseconds since the logger started
+        std::uint16_t length = 0;
+        Level level = Info;
+        char text[TextSize];                // Longer lines are cut off
+    };
+
+    // Bounded multi-producer, single-consumer queue. Every cell carries a
+    // sequence number telling producers and the consumer whose turn it is,
+    // so neither side ever waits on the other.
+    class RecordQueue {
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            Record record;
+        };
+
+        std::vector<Cell> cells;
+        std::size_t mask;
+        alignas(64) std::atomic<std::size_t> enqueuePos{ 0 };
+        alignas(64) std::size_t dequeuePos = 0;    // Consumer only
+
+    public:
+        // capacity is rounded up to a power of two
+        explicit RecordQueue(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) size <<= 1;
+            cells = std::vector<Cell>(size);
+            for (std::size_t i = 0; i < size; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+            mask = size - 1;
+        }
+
+        bool push(const Record& record) {
+            std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells[pos & mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        std::memcpy(&cell.record, &record, offsetof(Record, text) + record.length);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;           // Full
+                else
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        bool pop(Record& record) {
+            Cell& cell = cells[dequeuePos & mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence != dequeuePos + 1)
+                return false;               // Empty, or the producer is still copying
+            std::memcpy(&record, &cell.record, offsetof(Record, text) + cell.record.length);
+            cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            dequeuePos++;
+            return true;
+        }
+    };
+
+    // ─────────────────────────────────────────────
+    // Logger Class
+    // Owns the queue and the thread writing it out. One instance per
+    // process, created on first use and drained on exit.
+    // ─────────────────────────────────────────────
+    class Logger {
+    private:
+        RecordQueue queue{ 8192 };
+        std::atomic<Level> minimumLevel{ CompiledLevel };
+        std::atomic<std::uint64_t> pushed{ 0 };
+        std::atomic<std::uint64_t> written{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::atomic<bool> running{ true };
+        std::mutex sinkMutex;               // Guards the file; taken by the writer thread and setFile()
+        std::ofstream file;
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        std::thread writer;
+
+        static const char* levelName(Level level) {
+            switch (level) {
+            case Trace: return "trace";
+            case Debug: return "debug";
+            case Info: return "info";
+            case Warning: return "warning";
+            default: return "error";
+            }
+        }
+
+        void write(const Record& record) {
+            std::string_view text(record.text, record.length);
+            if (record.level >= Warning)
+                std::cerr << levelName(record.level) << ": " << text << '\n';
+            else
+                std::cout << text << '\n';
+            if (file.is_open()) {
+                char stamp[32];
+                std::snprintf(stamp, sizeof(stamp), "%10.3f ", record.time / 1e6);
+                file << stamp << '[' << levelName(record.level) << "] " << text << '\n';
+            }
+        }
+
+        void writerLoop() {
+            Record record;
+            while (true) {
+                bool any = false;
+                {
+                    std::lock_guard<std::mutex> lock(sinkMutex);
+                    while (queue.pop(record)) {
+                        write(record);
+                        written.fetch_add(1, std::memory_order_release);
+                        any = true;
+                    }
+                    // One flush per batch instead of one per line
+                    if (any) {
+                        std::cout.flush();
+                        if (file.is_open()) file.flush();
+                    }
+                }
+                if (!running.load(std::memory_order_acquire) && written.load() == pushed.load())
+                    break;
+                if (!any) {
+                    std::unique_lock<std::mutex> lock(sleepMutex);
+                    wake.wait_for(lock, std::chrono::milliseconds(2));
+                }
+            }
+        }
+
+    public:
+        Logger() : writer([this]() { writerLoop(); }) {}
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        ~Logger() {
+            running.store(false, std::memory_order_release);
+            wake.notify_one();
+            writer.join();
+            std::uint64_t lost = dropped.load();
+            if (lost > 0)
+                std::cerr << "warning: " << lost << " log lines dropped\n";
+        }
+
+        bool isEnabled(Level level) const {
+            return level >= minimumLevel.load(std::memory_order_relaxed);
+        }
+
+        // Raises the level at run time; levels below CompiledLevel stay compiled out
+        void setLevel(Level level) {
+            minimumLevel.store(std::max(level, CompiledLevel));
+        }
+
+        // Also appends every line, with a timestamp and level, to path
+        bool setFile(const std::string& path) {
+            std::lock_guard<std::mutex> lock(sinkMutex);
+            file.close();
+            file.open(path, std::ios::app);
+            if (!file.is_open()) {
+                std::cerr << "error: Could not open log file " << path << "\n";
+                return false;
+            }
+            return true;
+        }
+
+        void push(Record& record) {
+            record.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+            if (queue.push(record))
+                pushed.fetch_add(1, std::memory_order_relaxed);
+            else
+                dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Blocks until everything logged so far has been written out, e.g.
+        // before printing a report straight to stdout
+        void flush() {
+            std::uint64_t target = pushed.load();
+            wake.notify_one();
+            while (written.load(std::memory_order_acquire) < target)
+                std::this_thread::yield();
+            std::lock_guard<std::mutex> lock(sinkMutex);   // Waits out the batch flush
+        }
+
+        std::uint64_t getDropped() const {
+            return dropped.load();
+        }
+    };
+
+    inline Logger& logger() {
+        static Logger instance;
+        return instance;
+    }
+
+    inline bool isEnabled(Level level) {
+        return level >= CompiledLevel && logger().isEnabled(level);
+    }
+
+    inline void flush() {
+        logger().flush();
+    }
+
+    // Builds one record on the stack and queues it when destroyed
+    class Line {
+    private:
+        Record record;
+
+        void append(const char* text, std::size_t length) {
+            length = std::min(length, Record::TextSize - record.length);
+            std::memcpy(record.text + record.length, text, length);
+            record.length = static_cast<std::uint16_t>(record.length + length);
+        }
+
+    public:
+        explicit Line(Level level) {
+            record.level = level;
+        }
+
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        ~Line() {
+            logger().push(record);
+        }
+
+        Line& operator<<(std::string_view text) {
+            append(text.data(), text.size());
+            return *this;
+        }
+
+        Line& operator<<(const char* text) {
+            return *this << std::string_view(text);
+        }
+
+        Line& operator<<(const std::string& text) {
+            return *this << std::string_view(text);
+        }
+
+        Line& operator<<(char c) {
+            append(&c, 1);
+            return *this;
+        }
+
+        Line& operator<<(bool value) {
+            return *this << (value ? "true" : "false");
+        }
+
+        template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        Line& operator<<(Integer value) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            append(digits, static_cast<std::size_t>(result.ptr - digits));
+            return *this;
+        }
+
+        // Six significant digits, as std::ostream prints by default
+        Line& operator<<(double value) {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+            append(digits, static_cast<std::size_t>(result.ptr - digits));
+            return *this;
+        }
+
+        Line& operator<<(float value) {
+            return *this << static_cast<double>(value);
+        }
+    };
+}
+
+// A one-pass for loop rather than an if, so the macros nest in unbraced if/else chains
+#define LOG_AT(level) for (bool logEnabled = Log::isEnabled(level); logEnabled; logEnabled = false) Log::Line(level)
+#define LOG_TRACE LOG_AT(Log::Trace)
+#define LOG_DEBUG LOG_AT(Log::Debug)
+#define LOG_INFO LOG_AT(Log::Info)
+#define LOG_WARNING LOG_AT(Log::Warning)
+#define LOG_ERROR LOG_AT(Log::Error)
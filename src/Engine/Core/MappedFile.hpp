@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include "Log.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ─────────────────────────────────────────────
+// MappedFile Class
+// Read-only memory mapping of a whole file. Opening costs the same for any
+// file size; the OS pages data in on first touch and can drop clean pages
+// again under memory pressure, so only the parts actually read stay resident.
+// ─────────────────────────────────────────────
+class MappedFile {
+private:
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            LOG_ERROR << "Failed to open " << path;
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            LOG_ERROR << "Failed to map empty file " << path;
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            LOG_ERROR << "Failed to map " << path;
+            close();
+            return false;
+        }
+        data = static_cast<const std::uint8_t*>(view);
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG_ERROR << "Failed to open " << path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            LOG_ERROR << "Failed to map empty file " << path;
+            close();
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            LOG_ERROR << "Failed to map " << path;
+            close();
+            return false;
+        }
+        data = static_cast<const std::uint8_t*>(view);
+        size = static_cast<std::size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<std::uint8_t*>(data), size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    // Hints that a byte range will be read soon so the OS can page it in ahead of time
+    void prefetch(std::size_t offset, std::size_t length) const {
+        if (!data || offset >= size)
+            return;
+        if (length > size - offset)
+            length = size - offset;
+#ifdef _WIN32
+        (void)length;
+#else
+        long pageSize = sysconf(_SC_PAGESIZE);
+        std::size_t pageMask = static_cast<std::size_t>(pageSize > 0 ? pageSize : 4096) - 1;
+        std::size_t begin = offset & ~pageMask;
+        madvise(const_cast<std::uint8_t*>(data) + begin, offset + length - begin, MADV_WILLNEED);
+#endif
+    }
+
+    // Trades mappings with other, e.g. to replace a file by a newer version
+    // only once the newer one has mapped successfully
+    void swap(MappedFile& other) {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+
+    bool isOpen() const { return data != nullptr; }
+    const std::uint8_t* getData() const { return data; }
+    std::size_t getSize() const { return size; }
+};
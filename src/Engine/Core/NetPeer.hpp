@@ -0,0 +1,287 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include "Log.hpp"
+#include "Rollback.hpp"
+
+// ─────────────────────────────────────────────
+// LinkShim Class
+// Artificial network conditions for testing on one machine: every datagram
+// is held back for a random delay between minDelay and maxDelay (so they
+// also arrive out of order) and a share of them is dropped outright. Held
+// datagrams wait in a fixed ring, so shimming does not allocate.
+// ─────────────────────────────────────────────
+class LinkShim {
+public:
+    static constexpr std::size_t MaxDatagram = 512;
+
+    sf::Time minDelay, maxDelay;
+    float loss = 0.f;                       // 0..1
+
+    struct Stats {
+        std::uint64_t sent = 0;             // Handed to the socket
+        std::uint64_t dropped = 0;
+        std::uint64_t overflowed = 0;       // Dropped because the ring was full
+    };
+
+private:
+    struct Held {
+        sf::Time due;
+        std::size_t size = 0;
+        std::array<char, MaxDatagram> data;
+    };
+
+    std::array<Held, 512> held;
+    std::size_t heldCount = 0;
+    std::mt19937 rng;
+    Stats stats;
+
+public:
+    explicit LinkShim(unsigned int seed = 1) : rng(seed) {}
+
+    bool isActive() const {
+        return maxDelay > sf::Time::Zero || loss > 0.f;
+    }
+
+    // Queues a datagram to go out at now plus the link delay; false when it is lost
+    bool hold(const void* data, std::size_t size, sf::Time now) {
+        if (loss > 0.f && std::uniform_real_distribution<float>(0.f, 1.f)(rng) < loss) {
+            stats.dropped++;
+            return false;
+        }
+        if (heldCount == held.size() || size > MaxDatagram) {
+            stats.overflowed++;
+            return false;
+        }
+        sf::Int64 spread = (maxDelay - minDelay).asMicroseconds();
+        Held& slot = held[heldCount++];
+        slot.due = now + minDelay + sf::microseconds(spread > 0 ? std::uniform_int_distribution<sf::Int64>(0, spread)(rng) : 0);
+        slot.size = size;
+        std::memcpy(slot.data.data(), data, size);
+        return true;
+    }
+
+    // Sends every held datagram whose delay is up
+    void flush(sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port, sf::Time now) {
+        for (std::size_t i = 0; i < heldCount;) {
+            if (held[i].due > now) {
+                i++;
+                continue;
+            }
+            socket.send(held[i].data.data(), held[i].size, address, port);
+            stats.sent++;
+            std::swap(held[i], held[--heldCount]);
+        }
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
+
+// ─────────────────────────────────────────────
+// NetPeer Class
+// The other player's end of a rollback session, over UDP. Each tick both
+// sides send one small datagram: who they are, the tick they simulated,
+// how far ahead of the other they think they are, the last remote input
+// they hold (the ack), and then every local input the other side has not
+// acknowledged, one byte per tick. Resending everything unacknowledged
+// makes lost datagrams harmless: the next one carries the same inputs.
+// ─────────────────────────────────────────────
+class NetPeer {
+public:
+    struct Stats {
+        std::uint64_t packetsSent = 0;
+        std::uint64_t packetsReceived = 0;
+        std::uint64_t bytesSent = 0;
+        std::uint64_t yields = 0;           // Ticks skipped to let a slower peer catch up
+    };
+
+private:
+    enum PacketKind : sf::Uint8 { Hello = 1, Inputs = 2 };
+    static constexpr std::uint64_t MaxInputsPerPacket = 64;
+    static constexpr sf::Uint32 Magic = 0x52424e31;         // "RBN1"
+    static constexpr float AdvantageSmoothing = 0.05f;
+
+    sf::UdpSocket socket;
+    sf::IpAddress peerAddress;
+    unsigned short peerPort = 0;
+    LinkShim shim;
+    sf::Clock clock;
+    sf::Packet packet;                      // Reused for every datagram built or parsed
+    std::array<char, LinkShim::MaxDatagram> receiveBuffer;
+
+    bool connected = false;
+    sf::Time lastHeard;
+    std::uint64_t peerAck = 0;              // Last of our inputs the peer has
+    std::uint64_t peerTick = 0;             // Last tick the peer said it simulated
+    float peerAdvantage = 0.f;              // Smoothed over the newest datagrams, as the
+    float ownAdvantage = 0.f;               // peer reported it and as this side saw its own
+    std::uint64_t lastYield = 0;
+    Stats stats;
+
+    void transmit(const sf::Packet& datagram) {
+        stats.packetsSent++;
+        stats.bytesSent += datagram.getDataSize();
+        if (shim.isActive())
+            shim.hold(datagram.getData(), datagram.getDataSize(), clock.getElapsedTime());
+        else
+            socket.send(datagram.getData(), datagram.getDataSize(), peerAddress, peerPort);
+    }
+
+    int localAdvantage(const RollbackSession& session) const {
+        return static_cast<int>(session.getTick()) - static_cast<int>(peerTick);
+    }
+
+public:
+    // Binds the local port; peer is "host:port"
+    bool open(unsigned short local_port, const std::string& peer, unsigned int player) {
+        std::size_t colon = peer.rfind(':');
+        if (colon == std::string::npos) {
+            LOG_ERROR << "Peer address must be host:port, got " << peer;
+            return false;
+        }
+        peerAddress = sf::IpAddress(peer.substr(0, colon));
+        peerPort = static_cast<unsigned short>(std::strtoul(peer.c_str() + colon + 1, nullptr, 10));
+        if (peerAddress == sf::IpAddress::None) {
+            LOG_ERROR << "Could not resolve peer " << peer;
+            return false;
+        }
+        if (socket.bind(local_port) != sf::Socket::Done) {
+            LOG_ERROR << "Could not bind UDP port " << local_port;
+            return false;
+        }
+        socket.setBlocking(false);
+        shim = LinkShim(player + 1);
+        return true;
+    }
+
+    // Artificial delay (min..max) and loss on everything this side sends
+    void setLinkConditions(sf::Time min_delay, sf::Time max_delay, float loss) {
+        shim.minDelay = min_delay;
+        shim.maxDelay = std::max(min_delay, max_delay);
+        shim.loss = std::clamp(loss, 0.f, 1.f);
+    }
+
+    // Says hello until the peer answers, at most timeout; both sides start
+    // simulating as soon as they hear from the other
+    bool connect(RollbackSession& session, sf::Time timeout) {
+        sf::Time nextHello;
+        while (!connected && clock.getElapsedTime() < timeout) {
+            if (clock.getElapsedTime() >= nextHello) {
+                packet.clear();
+                packet << Magic << sf::Uint8(Hello) << sf::Uint8(session.getLocalPlayer()) << sf::Uint8(session.getInputDelay());
+                transmit(packet);
+                nextHello = clock.getElapsedTime() + sf::milliseconds(100);
+            }
+            shim.flush(socket, peerAddress, peerPort, clock.getElapsedTime());
+            sf::sleep(sf::milliseconds(1));
+            receive(session);
+        }
+        if (!connected)
+            LOG_ERROR << "No answer from peer " << peerAddress.toString() << ":" << peerPort;
+        return connected;
+    }
+
+    // Reads every datagram waiting on the socket into the session
+    void receive(RollbackSession& session) {
+        std::size_t size = 0;
+        sf::IpAddress sender;
+        unsigned short senderPort = 0;
+        while (socket.receive(receiveBuffer.data(), receiveBuffer.size(), size, sender, senderPort) == sf::Socket::Done) {
+            if (sender != peerAddress || senderPort != peerPort)
+                continue;
+            packet.clear();
+            packet.append(receiveBuffer.data(), size);
+            sf::Uint32 magic = 0;
+            sf::Uint8 kind = 0, player = 0, delay = 0;
+            if (!(packet >> magic >> kind >> player >> delay) || magic != Magic)
+                continue;
+            if (player == session.getLocalPlayer() || delay != session.getInputDelay()) {
+                LOG_ERROR << "Peer is player " << player + 1 << " with input delay " << int(delay) << "; expected player "
+                          << 2 - session.getLocalPlayer() << " with input delay " << session.getInputDelay();
+                continue;
+            }
+            stats.packetsReceived++;
+            connected = true;
+            lastHeard = clock.getElapsedTime();
+            if (kind != Inputs)
+                continue;
+
+            sf::Uint32 tick = 0, ack = 0, first = 0;
+            sf::Int8 advantage = 0;
+            sf::Uint8 count = 0;
+            if (!(packet >> tick >> advantage >> ack >> first >> count))
+                continue;
+            // Jitter makes single readings noisy, and reordered datagrams are stale
+            if (tick >= peerTick) {
+                peerTick = tick;
+                peerAdvantage += (advantage - peerAdvantage) * AdvantageSmoothing;
+                ownAdvantage += (localAdvantage(session) - ownAdvantage) * AdvantageSmoothing;
+            }
+            peerAck = std::max<std::uint64_t>(peerAck, ack);
+            for (sf::Uint8 i = 0; i < count; i++) {
+                InputState state;
+                if (!(packet >> state.buttons))
+                    break;
+                session.addRemoteInput(first + i, state);
+            }
+        }
+    }
+
+    // Sends this tick's datagram and lets held ones go
+    void send(const RollbackSession& session) {
+        std::uint64_t first = std::max(peerAck, session.getInputDelay()) + 1;
+        std::uint64_t last = std::min(session.getLocalLatest(), first + MaxInputsPerPacket - 1);
+        sf::Uint8 count = static_cast<sf::Uint8>(last >= first ? last - first + 1 : 0);
+
+        packet.clear();
+        packet << Magic << sf::Uint8(Inputs) << sf::Uint8(session.getLocalPlayer()) << sf::Uint8(session.getInputDelay())
+               << sf::Uint32(session.getTick()) << sf::Int8(std::clamp(localAdvantage(session), -127, 127))
+               << sf::Uint32(session.getRemoteConfirmed()) << sf::Uint32(first) << count;
+        for (std::uint64_t tick = first; tick < first + count; tick++)
+            packet << session.getLocalInput(tick).buttons;
+        transmit(packet);
+        flush();
+    }
+
+    // Releases datagrams the shim has held long enough
+    void flush() {
+        shim.flush(socket, peerAddress, peerPort, clock.getElapsedTime());
+    }
+
+    // True when this side runs ahead of the peer by a tick or more; the
+    // caller skips a tick (at most one every ten) so both drift back level
+    bool shouldYield(const RollbackSession& session) {
+        if (session.getTick() < lastYield + 10 || (ownAdvantage - peerAdvantage) / 2.f < 1.f)
+            return false;
+        lastYield = session.getTick();
+        stats.yields++;
+        return true;
+    }
+
+    std::uint64_t getPeerAck() const {
+        return peerAck;
+    }
+
+    // Time since the last datagram from the peer
+    sf::Time getSilence() const {
+        return clock.getElapsedTime() - lastHeard;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+    const LinkShim::Stats& getLinkStats() const {
+        return shim.getStats();
+    }
+};
@@ -0,0 +1,196 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "Log.hpp"
+
+// ─────────────────────────────────────────────
+// ParallaxLayer Class
+// Static decorations of one parallax layer (clouds, bushes), pre-rendered
+// into a single render texture instead of being drawn sprite by sprite.
+// The layer is cut into fixed-width strips; strip s lives in ring slot
+// s % slotCount of the texture, so the texture wraps exactly like the
+// world does and one repeated quad spanning the view, with its texture
+// coordinates set to the world x range, shows every visible strip. A strip
+// is composited the first time it nears the view and is then reused until
+// a strip further along the level takes its slot, so memory stays the same
+// whatever the level length and the layer costs one draw per frame.
+// Strips are composed by draw() itself, just before the quad goes out, so
+// all of the layer's GL work happens on the thread that draws it.
+// ─────────────────────────────────────────────
+class ParallaxLayer : public sf::Drawable {
+public:
+    struct Decoration {
+        sf::FloatRect bounds;   // Layer coordinates
+        sf::IntRect uv;         // Source rect in the decoration texture
+    };
+
+    struct Stats {
+        std::size_t decorations = 0;
+        unsigned int stripsComposed = 0;    // Strips rendered into the ring so far
+        unsigned int drawCalls = 0;         // Quads submitted by the last draw
+    };
+
+    static constexpr unsigned int StripWidth = 1024;
+
+private:
+    static constexpr long NoStrip = std::numeric_limits<long>::min();     // Slot not composed yet
+
+    std::vector<Decoration> decorations;    // Sorted by left edge once built
+    const sf::Texture* texture = nullptr;
+    mutable sf::RenderTexture ring;
+    mutable std::vector<long> slotStrips;   // Strip held by each slot
+    mutable sf::VertexArray batch{ sf::Quads };     // Reused while composing
+    float top = 0.f, height = 0.f;          // Vertical band covered by the decorations
+    float widestDecoration = 0.f;
+    bool built = false;
+    mutable std::atomic<bool> stale{ false };   // Set from any thread; the drawing thread recomposes
+    mutable Stats stats;
+
+    std::size_t slotOf(long strip) const {
+        long count = static_cast<long>(slotStrips.size());
+        return static_cast<std::size_t>(((strip % count) + count) % count);
+    }
+
+    // Clears the strip's slot and draws every decoration overlapping it in one batch
+    void compose(long strip) const {
+        std::size_t slot = slotOf(strip);
+        slotStrips[slot] = strip;
+        stats.stripsComposed++;
+
+        float stripLeft = static_cast<float>(strip) * StripWidth, stripRight = stripLeft + StripWidth;
+        float ringWidth = static_cast<float>(ring.getSize().x);
+        sf::View view(sf::FloatRect(stripLeft, top, static_cast<float>(StripWidth), height));
+        view.setViewport(sf::FloatRect(slot * StripWidth / ringWidth, 0.f, StripWidth / ringWidth, 1.f));
+        ring.setView(view);
+
+        // clear() ignores the viewport, so the old strip is overwritten with a transparent quad instead
+        const sf::Vertex eraser[4] = {
+            sf::Vertex(sf::Vector2f(stripLeft, top), sf::Color::Transparent),
+            sf::Vertex(sf::Vector2f(stripRight, top), sf::Color::Transparent),
+            sf::Vertex(sf::Vector2f(stripRight, top + height), sf::Color::Transparent),
+            sf::Vertex(sf::Vector2f(stripLeft, top + height), sf::Color::Transparent)
+        };
+        ring.draw(eraser, 4, sf::Quads, sf::RenderStates(sf::BlendNone));
+
+        batch.clear();
+        auto first = std::lower_bound(decorations.begin(), decorations.end(), stripLeft - widestDecoration,
+            [](const Decoration& decoration, float x) { return decoration.bounds.left < x; });
+        for (auto it = first; it != decorations.end() && it->bounds.left < stripRight; ++it) {
+            const sf::FloatRect& bounds = it->bounds;
+            if (bounds.left + bounds.width <= stripLeft)
+                continue;
+            float u = static_cast<float>(it->uv.left), v = static_cast<float>(it->uv.top);
+            float uvWidth = static_cast<float>(it->uv.width), uvHeight = static_cast<float>(it->uv.height);
+            batch.append(sf::Vertex(sf::Vector2f(bounds.left, bounds.top), sf::Vector2f(u, v)));
+            batch.append(sf::Vertex(sf::Vector2f(bounds.left + bounds.width, bounds.top), sf::Vector2f(u + uvWidth, v)));
+            batch.append(sf::Vertex(sf::Vector2f(bounds.left + bounds.width, bounds.top + bounds.height), sf::Vector2f(u + uvWidth, v + uvHeight)));
+            batch.append(sf::Vertex(sf::Vector2f(bounds.left, bounds.top + bounds.height), sf::Vector2f(u, v + uvHeight)));
+        }
+        ring.draw(batch, sf::RenderStates(texture));
+    }
+
+    // Composes the strips under visible (layer coordinates) that are not in
+    // the ring yet, plus the next one to the right
+    void composeVisible(const sf::FloatRect& visible) const {
+        long first = static_cast<long>(std::floor(visible.left / StripWidth));
+        long last = static_cast<long>(std::floor((visible.left + visible.width) / StripWidth)) + 1;
+        bool composed = false;
+        for (long strip = first; strip <= last; strip++) {
+            if (slotStrips[slotOf(strip)] != strip) {
+                compose(strip);
+                composed = true;
+            }
+        }
+        if (composed)
+            ring.display();
+    }
+
+public:
+    // Texture every decoration's uv rect refers to, e.g. the sprite atlas
+    void setTexture(const sf::Texture& decoration_texture) {
+        texture = &decoration_texture;
+    }
+
+    void addDecoration(const sf::FloatRect& bounds, const sf::IntRect& uv) {
+        decorations.push_back(Decoration{ bounds, uv });
+        built = false;
+    }
+
+    // Sizes the ring for a view of view_width: enough strips to cover it
+    // plus one composed ahead, rounded up to a power of two
+    bool build(float view_width) {
+        built = false;
+        stats = Stats();
+        stats.decorations = decorations.size();
+        if (decorations.empty() || !texture)
+            return false;
+
+        std::sort(decorations.begin(), decorations.end(),
+            [](const Decoration& a, const Decoration& b) { return a.bounds.left < b.bounds.left; });
+        float bottom = -std::numeric_limits<float>::max();
+        top = std::numeric_limits<float>::max();
+        widestDecoration = 0.f;
+        for (const auto& decoration : decorations) {
+            top = std::min(top, decoration.bounds.top);
+            bottom = std::max(bottom, decoration.bounds.top + decoration.bounds.height);
+            widestDecoration = std::max(widestDecoration, decoration.bounds.width);
+        }
+        height = std::ceil(bottom - top);
+
+        unsigned int slotCount = 1;
+        while (slotCount < static_cast<unsigned int>(std::ceil(view_width / StripWidth)) + 2)
+            slotCount <<= 1;
+        if (!ring.create(slotCount * StripWidth, static_cast<unsigned int>(height))) {
+            LOG_ERROR << "Could not create a " << slotCount * StripWidth << "x" << height << " parallax texture";
+            return false;
+        }
+        ring.setRepeated(true);
+        ring.clear(sf::Color::Transparent);
+        slotStrips.assign(slotCount, NoStrip);
+        built = true;
+        return true;
+    }
+
+    // The decoration texture changed: every strip is composed again as it is
+    // next drawn, on the thread that draws it
+    void invalidate() {
+        stale = true;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    // Composes what the view is about to show, then one quad across it; its
+    // texture coordinates are the world x range itself, which the repeating
+    // ring texture maps onto the slots
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        stats.drawCalls = 0;
+        if (!built)
+            return;
+        if (stale.exchange(false))
+            std::fill(slotStrips.begin(), slotStrips.end(), NoStrip);
+        const sf::View& view = target.getView();
+        float left = view.getCenter().x - view.getSize().x / 2.f;
+        float right = left + view.getSize().x;
+        composeVisible(sf::FloatRect(left, view.getCenter().y - view.getSize().y / 2.f, right - left, view.getSize().y));
+
+        sf::Vertex quad[4] = {
+            sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(left, 0.f)),
+            sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(right, 0.f)),
+            sf::Vertex(sf::Vector2f(right, top + height), sf::Vector2f(right, height)),
+            sf::Vertex(sf::Vector2f(left, top + height), sf::Vector2f(left, height)),
+        };
+        // The strips hold colours already multiplied by their alpha
+        states.texture = &ring.getTexture();
+        states.blendMode = sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+        target.draw(quad, 4, sf::Quads, states);
+        stats.drawCalls = 1;
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "QuadBuilder.hpp"
+
+// ─────────────────────────────────────────────
+// ParticleSystem Class
+// Short-lived cosmetic sprites (dust, debris, sparks) held as structure of
+// arrays in a pool sized once for the whole budget. Bursts are appended at
+// the end. One update moves every live particle under its own gravity and
+// drag and shrinks it about its centre as its life runs out, 4 at a time
+// with SSE. Then the slots of dead particles are refilled from the end, so
+// the live ones stay packed at the front. Nothing is allocated after
+// construction: a full pool drops new particles instead of growing.
+// The quads of the whole pool come from QuadBuilder in one run, so every
+// frame of one texture draws in a single batch. Particles are not part of
+// the simulation state: random numbers come from the system's own
+// generator and the game never reads a particle back.
+// ─────────────────────────────────────────────
+class ParticleSystem {
+public:
+    // What one emitter call spawns
+    struct Burst {
+        unsigned int count = 12;
+        sf::Vector2f position;                  // Centre of the burst
+        sf::Vector2f spread;                    // Particles start up to this far either side of it
+        float angle = -1.5707964f;              // Direction in radians; -pi/2 is straight up
+        float angleSpread = 3.1415927f;         // Directions vary by up to half this either way
+        float speedMin = 50.f, speedMax = 200.f;    // Pixels per second
+        float lifeMin = 0.3f, lifeMax = 0.8f;   // Seconds
+        float sizeMin = 6.f, sizeMax = 12.f;    // Starting size; particles shrink to nothing as they die
+        float gravity = 980.f;                  // Pixels per second squared, downwards
+        float drag = 0.f;                       // Fraction of the velocity lost per second
+        sf::FloatRect frame;                    // Texture rect in pixels
+        float pieceSize = 0.f;                  // Each particle shows a random square this big cut from frame; 0 shows all of it
+        sf::Color color = sf::Color::White;
+    };
+
+    struct Stats {
+        std::size_t live = 0;
+        std::size_t peak = 0;                   // Most live at once
+        std::uint64_t emitted = 0;
+        std::uint64_t dropped = 0;              // Not emitted because the pool was full
+    };
+
+private:
+    std::size_t capacity;
+    std::size_t count = 0;
+    std::vector<float> posX, posY, velX, velY, life, shrink, side, gravity, drag;
+    std::vector<float> texLeft, texTop, texWidth, texHeight;
+    std::vector<sf::Color> color;
+    std::uint32_t seed = 0x9e3779b9u;
+    QuadBuilder quads;
+    Stats stats;
+
+    // xorshift32, in [0, 1)
+    float random() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return (seed >> 8) * (1.f / 16777216.f);
+    }
+
+    static float between(float low, float high, float t) {
+        return low + (high - low) * t;
+    }
+
+    // Moves particles [first, last) on by dt; the SSE loop does the same float operations
+    void stepScalar(std::size_t first, std::size_t last, float dt) {
+        for (std::size_t i = first; i < last; i++) {
+            float keep = std::max(1.f - drag[i] * dt, 0.f);
+            float vx = velX[i] * keep;
+            float vy = velY[i] * keep + gravity[i] * dt;
+            float remaining = life[i] - dt;
+            float size = std::max(remaining * shrink[i], 0.f);
+            float shift = (side[i] - size) * 0.5f;
+            posX[i] = posX[i] + vx * dt + shift;
+            posY[i] = posY[i] + vy * dt + shift;
+            velX[i] = vx;
+            velY[i] = vy;
+            life[i] = remaining;
+            side[i] = size;
+        }
+    }
+
+#ifdef ENGINE3D_QUADS_X86
+    // SSE is part of every x86-64 CPU, so this needs no runtime check; returns how many it moved
+    std::size_t stepSSE(float dt) {
+        float* px = posX.data(); float* py = posY.data();
+        float* vx = velX.data(); float* vy = velY.data();
+        float* left = life.data(); float* sz = side.data();
+        const float* rate = shrink.data(); const float* g = gravity.data(); const float* d = drag.data();
+        const __m128 step = _mm_set1_ps(dt), one = _mm_set1_ps(1.f), half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps();
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 keep = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(d + i), step)), zero);
+            __m128 newX = _mm_mul_ps(_mm_loadu_ps(vx + i), keep);
+            __m128 newY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), keep), _mm_mul_ps(_mm_loadu_ps(g + i), step));
+            __m128 remaining = _mm_sub_ps(_mm_loadu_ps(left + i), step);
+            __m128 size = _mm_max_ps(_mm_mul_ps(remaining, _mm_loadu_ps(rate + i)), zero);
+            __m128 shift = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(sz + i), size), half);
+            _mm_storeu_ps(px + i, _mm_add_ps(_mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(newX, step)), shift));
+            _mm_storeu_ps(py + i, _mm_add_ps(_mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(newY, step)), shift));
+            _mm_storeu_ps(vx + i, newX);
+            _mm_storeu_ps(vy + i, newY);
+            _mm_storeu_ps(left + i, remaining);
+            _mm_storeu_ps(sz + i, size);
+        }
+        return i;
+    }
+#endif
+
+    void move(std::size_t from, std::size_t to) {
+        posX[to] = posX[from]; posY[to] = posY[from];
+        velX[to] = velX[from]; velY[to] = velY[from];
+        life[to] = life[from]; shrink[to] = shrink[from]; side[to] = side[from];
+        gravity[to] = gravity[from]; drag[to] = drag[from];
+        texLeft[to] = texLeft[from]; texTop[to] = texTop[from];
+        texWidth[to] = texWidth[from]; texHeight[to] = texHeight[from];
+        color[to] = color[from];
+    }
+
+    // Fills the slot of every dead particle with the last live one
+    void compact() {
+        for (std::size_t i = 0; i < count;) {
+            if (life[i] > 0.f) {
+                i++;
+                continue;
+            }
+            if (i != --count)
+                move(count, i);
+        }
+    }
+
+public:
+    // The scalar path (or a CPU without SSE) also moves particles one at a time
+    explicit ParticleSystem(std::size_t init_capacity = 100000, QuadBuilder::Path init_path = QuadBuilder::detect())
+        : capacity(init_capacity), quads(init_path) {
+        for (auto* array : { &posX, &posY, &velX, &velY, &life, &shrink, &side, &gravity, &drag, &texLeft, &texTop, &texWidth, &texHeight })
+            array->resize(capacity);
+        color.resize(capacity);
+    }
+
+    void emit(const Burst& burst) {
+        std::size_t spawned = std::min<std::size_t>(burst.count, capacity - count);
+        stats.emitted += spawned;
+        stats.dropped += burst.count - spawned;
+        for (std::size_t n = 0; n < spawned; n++) {
+            std::size_t i = count++;
+            float angle = burst.angle + (random() - 0.5f) * burst.angleSpread;
+            float speed = between(burst.speedMin, burst.speedMax, random());
+            float lifetime = std::max(between(burst.lifeMin, burst.lifeMax, random()), 0.001f);
+            float size = between(burst.sizeMin, burst.sizeMax, random());
+            posX[i] = burst.position.x + (random() * 2.f - 1.f) * burst.spread.x - size * 0.5f;
+            posY[i] = burst.position.y + (random() * 2.f - 1.f) * burst.spread.y - size * 0.5f;
+            velX[i] = std::cos(angle) * speed;
+            velY[i] = std::sin(angle) * speed;
+            life[i] = lifetime;
+            shrink[i] = size / lifetime;
+            side[i] = size;
+            gravity[i] = burst.gravity;
+            drag[i] = burst.drag;
+
+            float piece = std::min({ burst.pieceSize, burst.frame.width, burst.frame.height });
+            if (piece > 0.f) {
+                texLeft[i] = burst.frame.left + std::floor(random() * (burst.frame.width - piece));
+                texTop[i] = burst.frame.top + std::floor(random() * (burst.frame.height - piece));
+                texWidth[i] = texHeight[i] = piece;
+            }
+            else {
+                texLeft[i] = burst.frame.left;
+                texTop[i] = burst.frame.top;
+                texWidth[i] = burst.frame.width;
+                texHeight[i] = burst.frame.height;
+            }
+            color[i] = burst.color;
+        }
+        stats.live = count;
+        stats.peak = std::max(stats.peak, count);
+    }
+
+    // Moves every particle on by dt seconds and drops the ones whose life ran out
+    void update(float dt) {
+        std::size_t done = 0;
+#ifdef ENGINE3D_QUADS_X86
+        if (quads.getPath() != QuadBuilder::Path::Scalar)
+            done = stepSSE(dt);
+#endif
+        stepScalar(done, count, dt);
+        compact();
+        stats.live = count;
+    }
+
+    // Appends one quad per live particle to a sf::Quads array; returns how many
+    std::size_t appendQuads(sf::VertexArray& out) const {
+        QuadBuilder::Sprites sprites;
+        sprites.count = count;
+        sprites.x = posX.data();
+        sprites.y = posY.data();
+        sprites.width = sprites.height = side.data();
+        sprites.texLeft = texLeft.data();
+        sprites.texTop = texTop.data();
+        sprites.texWidth = texWidth.data();
+        sprites.texHeight = texHeight.data();
+        sprites.color = color.data();
+        quads.append(sprites, out);
+        return count;
+    }
+
+    void clear() {
+        count = 0;
+        stats.live = 0;
+    }
+
+    std::size_t getCount() const {
+        return count;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    QuadBuilder::Path getPath() const {
+        return quads.getPath();
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
@@ -0,0 +1,198 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Log.hpp"
+
+// ─────────────────────────────────────────────
+// Profiler
+// Scoped zones, counters and frame markers, recorded into one ring buffer
+// per thread and written out as Chrome trace_event JSON (open it in
+// chrome://tracing or ui.perfetto.dev). Only the owning thread writes its
+// ring, so recording takes no lock: an event is a clock read and a store.
+//
+// Instrument through the PROFILE_* macros. They compile to nothing unless
+// ENGINE3D_PROFILE is defined (CMake option of the same name), so release
+// builds pay nothing; arguments of disabled macros are not evaluated.
+// Event names must be string literals, as only the pointer is stored.
+// ─────────────────────────────────────────────
+namespace Profiler {
+    constexpr bool enabled() {
+#ifdef ENGINE3D_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    enum class EventType : std::uint8_t { Zone, Counter, Frame };
+
+    struct Event {
+        const char* name = nullptr;
+        std::int64_t start = 0;             // Nanoseconds since the profiler started
+        std::int64_t value = 0;             // Zone: duration in ns, Counter: value, Frame: frame number
+        EventType type = EventType::Zone;
+    };
+
+    // Single-writer ring; once full, the oldest events are overwritten
+    class ThreadBuffer {
+    public:
+        static constexpr std::size_t Capacity = 1 << 16;
+
+        const std::uint32_t id;
+        std::string name;
+
+    private:
+        std::vector<Event> events;
+        std::atomic<std::uint64_t> head{ 0 };   // Events ever written
+
+    public:
+        explicit ThreadBuffer(std::uint32_t init_id) : id(init_id), events(Capacity) {}
+
+        void push(const Event& event) {
+            std::uint64_t index = head.load(std::memory_order_relaxed);
+            events[index & (Capacity - 1)] = event;
+            head.store(index + 1, std::memory_order_release);
+        }
+
+        // Calls visit(event) for the retained events, oldest first
+        template <typename Visitor>
+        void forEach(Visitor&& visit) const {
+            std::uint64_t end = head.load(std::memory_order_acquire);
+            std::uint64_t begin = end > Capacity ? end - Capacity : 0;
+            for (std::uint64_t i = begin; i < end; i++)
+                visit(events[i & (Capacity - 1)]);
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;                   // Guards threads; taken once per thread, not per event
+        std::vector<std::unique_ptr<ThreadBuffer>> threads;
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        std::atomic<std::int64_t> frame{ 0 };
+    };
+
+    inline Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    inline std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+    }
+
+    // The calling thread's ring, created on its first event; buffers outlive
+    // their threads so a dump still shows finished workers
+    inline ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.threads.push_back(std::make_unique<ThreadBuffer>(static_cast<std::uint32_t>(reg.threads.size())));
+            buffer = reg.threads.back().get();
+        }
+        return *buffer;
+    }
+
+    inline void setThreadName(const std::string& name) {
+        threadBuffer().name = name;
+    }
+
+    inline void counter(const char* name, std::int64_t value) {
+        threadBuffer().push(Event{ name, now(), value, EventType::Counter });
+    }
+
+    // Marks the start of a new frame
+    inline void frameMark() {
+        threadBuffer().push(Event{ "Frame", now(), registry().frame++, EventType::Frame });
+    }
+
+    // Records the time between construction and destruction as one zone
+    class Zone {
+    private:
+        const char* name;
+        std::int64_t start;
+
+    public:
+        explicit Zone(const char* zone_name) : name(zone_name), start(now()) {}
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+        ~Zone() {
+            threadBuffer().push(Event{ name, start, now() - start, EventType::Zone });
+        }
+    };
+
+    inline std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+        }
+        return escaped;
+    }
+
+    // Writes every thread's retained events as Chrome trace_event JSON; call
+    // while the instrumented threads are idle, e.g. on exit
+    inline bool writeChromeTrace(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            LOG_ERROR << "Could not write trace " << path;
+            return false;
+        }
+
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() -> std::ofstream& {
+            file << (first ? "" : ",\n");
+            first = false;
+            return file;
+        };
+        for (const auto& thread : reg.threads) {
+            std::string threadName = thread->name.empty() ? "Thread " + std::to_string(thread->id) : thread->name;
+            separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+                        << ",\"args\":{\"name\":\"" << jsonEscape(threadName) << "\"}}";
+            thread->forEach([&](const Event& event) {
+                double ts = event.start / 1000.0;
+                switch (event.type) {
+                case EventType::Zone:
+                    separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id
+                                << ",\"ts\":" << ts << ",\"dur\":" << event.value / 1000.0 << "}";
+                    break;
+                case EventType::Counter:
+                    separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << thread->id
+                                << ",\"ts\":" << ts << ",\"args\":{\"value\":" << event.value << "}}";
+                    break;
+                case EventType::Frame:
+                    separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << thread->id
+                                << ",\"ts\":" << ts << ",\"args\":{\"frame\":" << event.value << "}}";
+                    break;
+                }
+            });
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+}
+
+#ifdef ENGINE3D_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) Profiler::counter(name, static_cast<std::int64_t>(value))
+#define PROFILE_FRAME() Profiler::frameMark()
+#define PROFILE_THREAD_NAME(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
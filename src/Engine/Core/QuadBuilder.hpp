@@ -0,0 +1,249 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ENGINE3D_QUADS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ENGINE3D_TARGET_AVX
+#else
+#define ENGINE3D_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+// ─────────────────────────────────────────────
+// QuadBuilder Class
+// Writes textured quads for a whole run of sprites at once, straight from
+// structure-of-arrays inputs, instead of one sf::RectangleShape (and one
+// sf::Transform) per sprite. Corners and texture coordinates of 4 (SSE) or
+// 8 (AVX) sprites are computed per instruction, then stored interleaved as
+// sf::Vertex in the order sf::Quads expects.
+// The widest path the CPU supports is picked at runtime; the scalar path
+// covers other CPUs and the sprites left over at the end of a run. Every
+// path does the same float operations, so all of them write the same quads.
+// ─────────────────────────────────────────────
+class QuadBuilder {
+public:
+    enum class Path : std::uint8_t { Scalar, SSE, AVX };
+
+    // One run of sprites; every array holds count values
+    struct Sprites {
+        std::size_t count = 0;
+        const float* x = nullptr;           // Top-left corner before rotation
+        const float* y = nullptr;
+        const float* width = nullptr;
+        const float* height = nullptr;
+        const float* texLeft = nullptr;     // Texture rectangle in pixels
+        const float* texTop = nullptr;
+        const float* texWidth = nullptr;    // Negative mirrors the sprite
+        const float* texHeight = nullptr;
+        const float* cosine = nullptr;      // Rotation about the sprite's centre; both null for axis-aligned sprites
+        const float* sine = nullptr;
+        const sf::Color* color = nullptr;   // Per sprite; null gives every quad tint
+        sf::Color tint = sf::Color::White;
+    };
+
+private:
+    Path path;
+
+    // Corners of up to 8 sprites, one array per corner, ready to interleave
+    struct Block {
+        alignas(32) float cornerX[4][8];
+        alignas(32) float cornerY[4][8];
+        alignas(32) float texRight[8], texBottom[8];
+    };
+
+    static void emit(const Sprites& sprites, std::size_t first, std::size_t lanes, const Block& block, sf::Vertex* out) {
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            std::size_t i = first + lane;
+            sf::Color color = sprites.color ? sprites.color[i] : sprites.tint;
+            float u0 = sprites.texLeft[i], v0 = sprites.texTop[i];
+            float u1 = block.texRight[lane], v1 = block.texBottom[lane];
+            const float texU[4] = { u0, u1, u1, u0 }, texV[4] = { v0, v0, v1, v1 };
+
+            // Field by field: sf::Vertex's constructors are not inline
+            sf::Vertex* quad = out + i * 4;
+            for (int corner = 0; corner < 4; corner++) {
+                quad[corner].position.x = block.cornerX[corner][lane];
+                quad[corner].position.y = block.cornerY[corner][lane];
+                quad[corner].color = color;
+                quad[corner].texCoords.x = texU[corner];
+                quad[corner].texCoords.y = texV[corner];
+            }
+        }
+    }
+
+    // Sprites [first, last) one at a time
+    static void buildScalar(const Sprites& sprites, std::size_t first, std::size_t last, sf::Vertex* out) {
+        Block block;
+        for (std::size_t i = first; i < last; i++) {
+            float x = sprites.x[i], y = sprites.y[i], w = sprites.width[i], h = sprites.height[i];
+            block.texRight[0] = sprites.texLeft[i] + sprites.texWidth[i];
+            block.texBottom[0] = sprites.texTop[i] + sprites.texHeight[i];
+            if (sprites.cosine) {
+                // Half of each edge, rotated; corners are the centre plus or minus both
+                float halfW = w * 0.5f, halfH = h * 0.5f;
+                float centreX = x + halfW, centreY = y + halfH;
+                float c = sprites.cosine[i], s = sprites.sine[i];
+                float acrossX = c * halfW, acrossY = s * halfW;
+                float downX = -(s * halfH), downY = c * halfH;
+                block.cornerX[0][0] = centreX - acrossX - downX;
+                block.cornerY[0][0] = centreY - acrossY - downY;
+                block.cornerX[1][0] = centreX + acrossX - downX;
+                block.cornerY[1][0] = centreY + acrossY - downY;
+                block.cornerX[2][0] = centreX + acrossX + downX;
+                block.cornerY[2][0] = centreY + acrossY + downY;
+                block.cornerX[3][0] = centreX - acrossX + downX;
+                block.cornerY[3][0] = centreY - acrossY + downY;
+            }
+            else {
+                float right = x + w, bottom = y + h;
+                block.cornerX[0][0] = x;     block.cornerY[0][0] = y;
+                block.cornerX[1][0] = right; block.cornerY[1][0] = y;
+                block.cornerX[2][0] = right; block.cornerY[2][0] = bottom;
+                block.cornerX[3][0] = x;     block.cornerY[3][0] = bottom;
+            }
+            emit(sprites, i, 1, block, out);
+        }
+    }
+
+#ifdef ENGINE3D_QUADS_X86
+    // Returns where the vector loop stopped; the caller finishes the rest scalar
+    static std::size_t buildSSE(const Sprites& sprites, sf::Vertex* out) {
+        Block block;
+        std::size_t i = 0;
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= sprites.count; i += 4) {
+            __m128 x = _mm_loadu_ps(sprites.x + i), y = _mm_loadu_ps(sprites.y + i);
+            __m128 w = _mm_loadu_ps(sprites.width + i), h = _mm_loadu_ps(sprites.height + i);
+            _mm_store_ps(block.texRight, _mm_add_ps(_mm_loadu_ps(sprites.texLeft + i), _mm_loadu_ps(sprites.texWidth + i)));
+            _mm_store_ps(block.texBottom, _mm_add_ps(_mm_loadu_ps(sprites.texTop + i), _mm_loadu_ps(sprites.texHeight + i)));
+            if (sprites.cosine) {
+                __m128 halfW = _mm_mul_ps(w, half), halfH = _mm_mul_ps(h, half);
+                __m128 centreX = _mm_add_ps(x, halfW), centreY = _mm_add_ps(y, halfH);
+                __m128 c = _mm_loadu_ps(sprites.cosine + i), s = _mm_loadu_ps(sprites.sine + i);
+                __m128 acrossX = _mm_mul_ps(c, halfW), acrossY = _mm_mul_ps(s, halfW);
+                __m128 downX = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(s, halfH)), downY = _mm_mul_ps(c, halfH);
+                _mm_store_ps(block.cornerX[0], _mm_sub_ps(_mm_sub_ps(centreX, acrossX), downX));
+                _mm_store_ps(block.cornerY[0], _mm_sub_ps(_mm_sub_ps(centreY, acrossY), downY));
+                _mm_store_ps(block.cornerX[1], _mm_sub_ps(_mm_add_ps(centreX, acrossX), downX));
+                _mm_store_ps(block.cornerY[1], _mm_sub_ps(_mm_add_ps(centreY, acrossY), downY));
+                _mm_store_ps(block.cornerX[2], _mm_add_ps(_mm_add_ps(centreX, acrossX), downX));
+                _mm_store_ps(block.cornerY[2], _mm_add_ps(_mm_add_ps(centreY, acrossY), downY));
+                _mm_store_ps(block.cornerX[3], _mm_add_ps(_mm_sub_ps(centreX, acrossX), downX));
+                _mm_store_ps(block.cornerY[3], _mm_add_ps(_mm_sub_ps(centreY, acrossY), downY));
+            }
+            else {
+                __m128 right = _mm_add_ps(x, w), bottom = _mm_add_ps(y, h);
+                _mm_store_ps(block.cornerX[0], x);     _mm_store_ps(block.cornerY[0], y);
+                _mm_store_ps(block.cornerX[1], right); _mm_store_ps(block.cornerY[1], y);
+                _mm_store_ps(block.cornerX[2], right); _mm_store_ps(block.cornerY[2], bottom);
+                _mm_store_ps(block.cornerX[3], x);     _mm_store_ps(block.cornerY[3], bottom);
+            }
+            emit(sprites, i, 4, block, out);
+        }
+        return i;
+    }
+
+    ENGINE3D_TARGET_AVX static std::size_t buildAVX(const Sprites& sprites, sf::Vertex* out) {
+        Block block;
+        std::size_t i = 0;
+        const __m256 half = _mm256_set1_ps(0.5f);
+        for (; i + 8 <= sprites.count; i += 8) {
+            __m256 x = _mm256_loadu_ps(sprites.x + i), y = _mm256_loadu_ps(sprites.y + i);
+            __m256 w = _mm256_loadu_ps(sprites.width + i), h = _mm256_loadu_ps(sprites.height + i);
+            _mm256_store_ps(block.texRight, _mm256_add_ps(_mm256_loadu_ps(sprites.texLeft + i), _mm256_loadu_ps(sprites.texWidth + i)));
+            _mm256_store_ps(block.texBottom, _mm256_add_ps(_mm256_loadu_ps(sprites.texTop + i), _mm256_loadu_ps(sprites.texHeight + i)));
+            if (sprites.cosine) {
+                __m256 halfW = _mm256_mul_ps(w, half), halfH = _mm256_mul_ps(h, half);
+                __m256 centreX = _mm256_add_ps(x, halfW), centreY = _mm256_add_ps(y, halfH);
+                __m256 c = _mm256_loadu_ps(sprites.cosine + i), s = _mm256_loadu_ps(sprites.sine + i);
+                __m256 acrossX = _mm256_mul_ps(c, halfW), acrossY = _mm256_mul_ps(s, halfW);
+                __m256 downX = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(s, halfH)), downY = _mm256_mul_ps(c, halfH);
+                _mm256_store_ps(block.cornerX[0], _mm256_sub_ps(_mm256_sub_ps(centreX, acrossX), downX));
+                _mm256_store_ps(block.cornerY[0], _mm256_sub_ps(_mm256_sub_ps(centreY, acrossY), downY));
+                _mm256_store_ps(block.cornerX[1], _mm256_sub_ps(_mm256_add_ps(centreX, acrossX), downX));
+                _mm256_store_ps(block.cornerY[1], _mm256_sub_ps(_mm256_add_ps(centreY, acrossY), downY));
+                _mm256_store_ps(block.cornerX[2], _mm256_add_ps(_mm256_add_ps(centreX, acrossX), downX));
+                _mm256_store_ps(block.cornerY[2], _mm256_add_ps(_mm256_add_ps(centreY, acrossY), downY));
+                _mm256_store_ps(block.cornerX[3], _mm256_add_ps(_mm256_sub_ps(centreX, acrossX), downX));
+                _mm256_store_ps(block.cornerY[3], _mm256_add_ps(_mm256_sub_ps(centreY, acrossY), downY));
+            }
+            else {
+                __m256 right = _mm256_add_ps(x, w), bottom = _mm256_add_ps(y, h);
+                _mm256_store_ps(block.cornerX[0], x);     _mm256_store_ps(block.cornerY[0], y);
+                _mm256_store_ps(block.cornerX[1], right); _mm256_store_ps(block.cornerY[1], y);
+                _mm256_store_ps(block.cornerX[2], right); _mm256_store_ps(block.cornerY[2], bottom);
+                _mm256_store_ps(block.cornerX[3], x);     _mm256_store_ps(block.cornerY[3], bottom);
+            }
+            emit(sprites, i, 8, block, out);
+        }
+        return i;
+    }
+#endif
+
+public:
+    // Widest path this CPU (and, for AVX, the OS) supports
+    static Path detect() {
+#ifdef ENGINE3D_QUADS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        bool osSavesAvx = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        if (osSavesAvx && (info[2] & (1 << 28)))
+            return Path::AVX;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx"))
+            return Path::AVX;
+#endif
+        return Path::SSE;                   // Part of every x86-64 CPU
+#else
+        return Path::Scalar;
+#endif
+    }
+
+    static const char* getName(Path path) {
+        switch (path) {
+            case Path::AVX: return "avx";
+            case Path::SSE: return "sse";
+            default: return "scalar";
+        }
+    }
+
+    // Asking for a path the CPU lacks falls back to the best one it has
+    explicit QuadBuilder(Path init_path = detect()) : path(init_path) {
+        Path best = detect();
+        if (static_cast<std::uint8_t>(path) > static_cast<std::uint8_t>(best))
+            path = best;
+    }
+
+    Path getPath() const {
+        return path;
+    }
+
+    // Writes sprites.count quads, 4 vertices each, to out
+    void build(const Sprites& sprites, sf::Vertex* out) const {
+        std::size_t done = 0;
+#ifdef ENGINE3D_QUADS_X86
+        if (path == Path::AVX)
+            done = buildAVX(sprites, out);
+        else if (path == Path::SSE)
+            done = buildSSE(sprites, out);
+#endif
+        buildScalar(sprites, done, sprites.count, out);
+    }
+
+    // Appends the quads to the end of a sf::Quads array
+    void append(const Sprites& sprites, sf::VertexArray& out) const {
+        std::size_t first = out.getVertexCount();
+        out.resize(first + sprites.count * 4);
+        if (sprites.count > 0)
+            build(sprites, &out[first]);
+    }
+};
@@ -0,0 +1,405 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+
+// ─────────────────────────────────────────────
+// GridMap Class
+// The level of the raycast view: one byte per square cell, 0 for empty,
+// otherwise the id of the wall texture the cell is built from.
+// ─────────────────────────────────────────────
+class GridMap {
+public:
+    static constexpr std::uint8_t Empty = 0;
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> cells;        // Row-major
+
+public:
+    GridMap() = default;
+
+    GridMap(int init_width, int init_height) {
+        resize(init_width, init_height);
+    }
+
+    // Every cell becomes empty
+    void resize(int new_width, int new_height) {
+        width = std::max(new_width, 0);
+        height = std::max(new_height, 0);
+        cells.assign(static_cast<std::size_t>(width) * height, Empty);
+    }
+
+    void set(int x, int y, std::uint8_t id) {
+        if (x >= 0 && y >= 0 && x < width && y < height)
+            cells[static_cast<std::size_t>(y) * width + x] = id;
+    }
+
+    // Empty outside the map
+    std::uint8_t get(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height)
+            return Empty;
+        return cells[static_cast<std::size_t>(y) * width + x];
+    }
+
+    // Outside the map counts as solid, so nothing walks off it
+    bool isSolid(int x, int y) const {
+        return x < 0 || y < 0 || x >= width || y >= height || cells[static_cast<std::size_t>(y) * width + x] != Empty;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+// ─────────────────────────────────────────────
+// Raycaster Class
+// Software pseudo-3D renderer over a GridMap. Every screen column casts one
+// ray through the grid (DDA, one cell boundary per step), draws the sky
+// above the wall it hits, the texture-mapped wall, then the floor, and
+// keeps the wall's distance in a per-column depth buffer that billboard
+// sprites are tested against. Columns are independent, so they are split
+// across the job system. They are drawn into a column-major frame, where
+// each column is contiguous, and a blocked transpose then produces the
+// row-major RGBA pixels sf::Texture::update() takes. Textures are kept
+// column-major too, so sampling a wall or sprite stripe walks memory in
+// order. Pixels are RGBA bytes read as little-endian 32-bit words.
+// ─────────────────────────────────────────────
+class Raycaster {
+public:
+    struct View {
+        sf::Vector2f position;              // In cells
+        float angle = 0.f;                  // Radians, 0 = towards +x, growing towards +y
+        float fieldOfView = 1.15f;          // Horizontal, radians (about 66 degrees)
+    };
+
+    struct Sprite {
+        sf::Vector2f position;              // In cells; the sprite stands on the floor there
+        std::uint16_t texture = 0;          // Id returned by addTexture()
+        float scale = 1.f;                  // Height, in wall heights
+    };
+
+    struct Stats {
+        std::size_t spritesProjected = 0;   // In front of the camera and inside the screen last frame
+        std::size_t wallColumns = 0;        // Columns whose ray hit a wall
+    };
+
+    static constexpr std::size_t ColumnGrain = 32;     // Screen columns per job, at least
+    static constexpr std::size_t RowGrain = 32;        // Rows per transpose job, at least
+
+private:
+    struct Texture {
+        int width = 0, height = 0;
+        std::vector<std::uint32_t> texels;  // Column-major: texel (x, y) at x * height + y
+    };
+
+    struct Projected {
+        float depth = 0.f;
+        int left = 0, right = 0;            // Screen columns [left, right)
+        int top = 0, bottom = 0;            // Unclipped screen rows
+        float screenLeft = 0.f, width = 0.f;
+        const Texture* texture = nullptr;
+    };
+
+    static constexpr std::uint32_t AlphaMask = 0xFF000000u;
+    static constexpr std::uint32_t OpaqueAlpha = 0x80000000u;  // Sprite texels at or above half alpha are drawn
+
+    int width = 0, height = 0;
+    std::vector<std::uint32_t> columns;     // Column-major frame: pixel (x, y) at x * height + y
+    std::vector<std::uint32_t> pixels;      // Row-major frame, as getPixels() returns it
+    std::vector<float> depth;               // Perpendicular wall distance per column
+    std::vector<std::uint32_t> floorShade;  // Floor colour of each row below the horizon
+    std::vector<int> skyRows;               // Sky texel row of each row above the horizon
+    std::vector<Texture> textures;          // Id - 1
+    Texture sky;
+    sf::Color ceilingColor{ 100, 140, 220 };
+    sf::Color floorColor{ 96, 84, 72 };
+    float skyRepeat = 2.f;                  // Times the sky image wraps around a full turn
+    std::vector<Projected> projected;       // This frame's sprites, far to near
+    Stats stats;
+
+    static std::uint32_t pack(sf::Color color) {
+        return static_cast<std::uint32_t>(color.r) | static_cast<std::uint32_t>(color.g) << 8 |
+            static_cast<std::uint32_t>(color.b) << 16 | static_cast<std::uint32_t>(color.a) << 24;
+    }
+
+    // Walls facing north and south are drawn at half brightness
+    static std::uint32_t shade(std::uint32_t color) {
+        return ((color >> 1) & 0x007F7F7Fu) | AlphaMask;
+    }
+
+    static Texture makeTexture(const sf::Image& image) {
+        Texture texture;
+        texture.width = static_cast<int>(image.getSize().x);
+        texture.height = static_cast<int>(image.getSize().y);
+        texture.texels.resize(static_cast<std::size_t>(texture.width) * texture.height);
+        const sf::Uint8* source = image.getPixelsPtr();
+        for (int y = 0; y < texture.height; y++) {
+            for (int x = 0; x < texture.width; x++)
+                std::memcpy(&texture.texels[static_cast<std::size_t>(x) * texture.height + y], source + (static_cast<std::size_t>(y) * texture.width + x) * 4, 4);
+        }
+        return texture;
+    }
+
+    void buildRowTables() {
+        int horizon = height / 2;
+        floorShade.assign(height, 0);
+        for (int y = horizon; y < height; y++) {
+            // Rows near the horizon show floor far away, which fades towards black
+            float distance = static_cast<float>(height) / std::max(2 * y - height + 1, 1);
+            float light = std::clamp(2.5f / (distance + 1.5f), 0.25f, 1.f);
+            floorShade[y] = pack(sf::Color(static_cast<sf::Uint8>(floorColor.r * light), static_cast<sf::Uint8>(floorColor.g * light),
+                static_cast<sf::Uint8>(floorColor.b * light)));
+        }
+        skyRows.assign(horizon, 0);
+        for (int y = 0; y < horizon && sky.height > 0; y++)
+            skyRows[y] = std::min(y * sky.height / std::max(horizon, 1), sky.height - 1);
+    }
+
+    // Sprites in front of the camera, projected to the screen and sorted far to near
+    void projectSprites(const View& view, const std::vector<Sprite>& sprites, float dirX, float dirY, float planeX, float planeY) {
+        projected.clear();
+        float inverse = 1.f / (planeX * dirY - dirX * planeY);
+        for (const Sprite& sprite : sprites) {
+            if (sprite.texture == 0 || sprite.texture > textures.size())
+                continue;
+            float relX = sprite.position.x - view.position.x, relY = sprite.position.y - view.position.y;
+            float side = inverse * (dirY * relX - dirX * relY);
+            float ahead = inverse * (-planeY * relX + planeX * relY);
+            if (ahead < 0.1f)
+                continue;
+
+            const Texture& texture = textures[sprite.texture - 1];
+            Projected p;
+            p.depth = ahead;
+            p.texture = &texture;
+            float wallHeight = height / ahead;
+            float spriteHeight = wallHeight * sprite.scale;
+            p.width = spriteHeight * texture.width / std::max(texture.height, 1);
+            float centre = width * 0.5f * (1.f + side / ahead);
+            p.screenLeft = centre - p.width * 0.5f;
+            p.left = std::max(static_cast<int>(std::floor(p.screenLeft)), 0);
+            p.right = std::min(static_cast<int>(std::ceil(p.screenLeft + p.width)), width);
+            p.bottom = static_cast<int>((height + wallHeight) * 0.5f);
+            p.top = p.bottom - static_cast<int>(spriteHeight);
+            if (p.left < p.right && p.bottom > 0 && p.top < height && spriteHeight >= 1.f)
+                projected.push_back(p);
+        }
+        std::sort(projected.begin(), projected.end(), [](const Projected& a, const Projected& b) { return a.depth > b.depth; });
+        stats.spritesProjected = projected.size();
+    }
+
+    // Sky, wall and floor of columns [begin, end), then the sprite stripes in them
+    std::size_t drawColumns(const GridMap& map, const View& view, int begin, int end, float dirX, float dirY, float planeX, float planeY) {
+        const int horizon = height / 2;
+        const int maxSteps = map.getWidth() + map.getHeight() + 2;
+        const float posX = view.position.x, posY = view.position.y;
+        const float turn = 6.28318531f;
+        const std::uint32_t ceiling = pack(ceilingColor);
+        std::size_t hits = 0;
+
+        for (int x = begin; x < end; x++) {
+            std::uint32_t* out = columns.data() + static_cast<std::size_t>(x) * height;
+            float cameraX = 2.f * (x + 0.5f) / width - 1.f;
+            float rayX = dirX + planeX * cameraX, rayY = dirY + planeY * cameraX;
+
+            // Step from one cell boundary to the next until a wall is hit
+            int mapX = static_cast<int>(std::floor(posX)), mapY = static_cast<int>(std::floor(posY));
+            float deltaX = rayX == 0.f ? 1e30f : std::fabs(1.f / rayX);
+            float deltaY = rayY == 0.f ? 1e30f : std::fabs(1.f / rayY);
+            int stepX = rayX < 0.f ? -1 : 1, stepY = rayY < 0.f ? -1 : 1;
+            float sideX = rayX < 0.f ? (posX - mapX) * deltaX : (mapX + 1.f - posX) * deltaX;
+            float sideY = rayY < 0.f ? (posY - mapY) * deltaY : (mapY + 1.f - posY) * deltaY;
+            int side = 0;
+            std::uint8_t hit = GridMap::Empty;
+            for (int steps = 0; steps < maxSteps && hit == GridMap::Empty; steps++) {
+                if (sideX < sideY) {
+                    sideX += deltaX;
+                    mapX += stepX;
+                    side = 0;
+                }
+                else {
+                    sideY += deltaY;
+                    mapY += stepY;
+                    side = 1;
+                }
+                if (mapX < 0 || mapY < 0 || mapX >= map.getWidth() || mapY >= map.getHeight())
+                    break;
+                hit = map.get(mapX, mapY);
+            }
+            const Texture* texture = hit != GridMap::Empty && hit <= textures.size() ? &textures[hit - 1] : nullptr;
+
+            float distance = texture ? std::max(side == 0 ? sideX - deltaX : sideY - deltaY, 1e-4f) : 1e30f;
+            int lineHeight = texture ? static_cast<int>(std::min(height / distance, 1e7f)) : 0;
+            int top = (height - lineHeight) / 2;
+            int drawTop = std::max(top, 0), drawBottom = std::min(top + lineHeight, height);
+            if (!texture)
+                drawTop = drawBottom = horizon;
+            depth[x] = distance;
+
+            // Sky: a panorama wrapped skyRepeat times around a full turn
+            if (sky.height > 0) {
+                float u = std::atan2(rayY, rayX) / turn * skyRepeat;
+                u -= std::floor(u);
+                const std::uint32_t* skyColumn = sky.texels.data() + static_cast<std::size_t>(std::min(static_cast<int>(u * sky.width), sky.width - 1)) * sky.height;
+                for (int y = 0; y < drawTop; y++) out[y] = skyColumn[skyRows[y]];
+            }
+            else {
+                std::fill(out, out + drawTop, ceiling);
+            }
+
+            if (texture) {
+                hits++;
+                float wallX = side == 0 ? posY + distance * rayY : posX + distance * rayX;
+                wallX -= std::floor(wallX);
+                int texX = std::min(static_cast<int>(wallX * texture->width), texture->width - 1);
+                if ((side == 0 && rayX > 0.f) || (side == 1 && rayY < 0.f))
+                    texX = texture->width - texX - 1;
+                const std::uint32_t* texColumn = texture->texels.data() + static_cast<std::size_t>(texX) * texture->height;
+
+                // 16.16 fixed point texel row, starting where the clipped wall starts
+                std::uint64_t step = (static_cast<std::uint64_t>(texture->height) << 16) / std::max(lineHeight, 1);
+                std::uint64_t texY = static_cast<std::uint64_t>(drawTop - top) * step;
+                const std::uint32_t lastRow = static_cast<std::uint32_t>(texture->height - 1);
+                if (side == 0) {
+                    for (int y = drawTop; y < drawBottom; y++, texY += step)
+                        out[y] = texColumn[std::min(static_cast<std::uint32_t>(texY >> 16), lastRow)];
+                }
+                else {
+                    for (int y = drawTop; y < drawBottom; y++, texY += step)
+                        out[y] = shade(texColumn[std::min(static_cast<std::uint32_t>(texY >> 16), lastRow)]);
+                }
+            }
+
+            std::copy(floorShade.begin() + drawBottom, floorShade.end(), out + drawBottom);
+        }
+
+        // Sprites far to near, each stripe only where it is closer than the wall
+        for (const Projected& sprite : projected) {
+            int first = std::max(sprite.left, begin), last = std::min(sprite.right, end);
+            const Texture& texture = *sprite.texture;
+            int spriteHeight = sprite.bottom - sprite.top;
+            std::uint64_t step = (static_cast<std::uint64_t>(texture.height) << 16) / std::max(spriteHeight, 1);
+            int drawTop = std::max(sprite.top, 0), drawBottom = std::min(sprite.bottom, height);
+            const std::uint32_t lastRow = static_cast<std::uint32_t>(texture.height - 1);
+            for (int x = first; x < last; x++) {
+                if (sprite.depth >= depth[x])
+                    continue;
+                int texX = std::clamp(static_cast<int>((x + 0.5f - sprite.screenLeft) * texture.width / sprite.width), 0, texture.width - 1);
+                const std::uint32_t* texColumn = texture.texels.data() + static_cast<std::size_t>(texX) * texture.height;
+                std::uint32_t* out = columns.data() + static_cast<std::size_t>(x) * height;
+                std::uint64_t texY = static_cast<std::uint64_t>(drawTop - sprite.top) * step;
+                for (int y = drawTop; y < drawBottom; y++, texY += step) {
+                    std::uint32_t texel = texColumn[std::min(static_cast<std::uint32_t>(texY >> 16), lastRow)];
+                    if (texel >= OpaqueAlpha)
+                        out[y] = texel;
+                }
+            }
+        }
+        return hits;
+    }
+
+    // Rows [begin, end) of the row-major frame, copied out of the columns in
+    // blocks small enough that both sides stay in cache
+    void transposeRows(int begin, int end) {
+        constexpr int Block = 16;
+        for (int x0 = 0; x0 < width; x0 += Block) {
+            int x1 = std::min(x0 + Block, width);
+            for (int y = begin; y < end; y++) {
+                std::uint32_t* row = pixels.data() + static_cast<std::size_t>(y) * width;
+                const std::uint32_t* source = columns.data() + y;
+                for (int x = x0; x < x1; x++) row[x] = source[static_cast<std::size_t>(x) * height];
+            }
+        }
+    }
+
+public:
+    Raycaster() = default;
+
+    Raycaster(unsigned int init_width, unsigned int init_height) {
+        resize(init_width, init_height);
+    }
+
+    void resize(unsigned int new_width, unsigned int new_height) {
+        width = static_cast<int>(new_width);
+        height = static_cast<int>(new_height);
+        columns.assign(static_cast<std::size_t>(width) * height, 0);
+        pixels.assign(static_cast<std::size_t>(width) * height, 0);
+        depth.assign(width, 0.f);
+        buildRowTables();
+    }
+
+    // Registers a wall or sprite texture and returns its id (1, 2, ...); a
+    // wall cell holding that id is drawn with it
+    std::uint16_t addTexture(const sf::Image& image) {
+        textures.push_back(makeTexture(image));
+        return static_cast<std::uint16_t>(textures.size());
+    }
+
+    // Panorama above the horizon; without one the ceiling is a flat colour
+    void setSky(const sf::Image& image, float repeat = 2.f) {
+        sky = makeTexture(image);
+        skyRepeat = repeat;
+        buildRowTables();
+    }
+
+    void setColors(sf::Color ceiling, sf::Color floor) {
+        ceilingColor = ceiling;
+        floorColor = floor;
+        buildRowTables();
+    }
+
+    // Draws a frame of map seen from view, sprites included; with jobs the
+    // columns and the transpose are split across the pool
+    void render(const GridMap& map, const View& view, const std::vector<Sprite>& sprites, JobSystem* jobs = nullptr) {
+        PROFILE_ZONE("Raycast");
+        if (width == 0 || height == 0)
+            return;
+        float dirX = std::cos(view.angle), dirY = std::sin(view.angle);
+        float planeLength = std::tan(view.fieldOfView * 0.5f);
+        float planeX = -dirY * planeLength, planeY = dirX * planeLength;
+        projectSprites(view, sprites, dirX, dirY, planeX, planeY);
+
+        std::atomic<std::size_t> hits{ 0 };
+        auto columnRange = [&](std::size_t begin, std::size_t end) {
+            hits.fetch_add(drawColumns(map, view, static_cast<int>(begin), static_cast<int>(end), dirX, dirY, planeX, planeY), std::memory_order_relaxed);
+        };
+        auto rowRange = [this](std::size_t begin, std::size_t end) {
+            transposeRows(static_cast<int>(begin), static_cast<int>(end));
+        };
+        if (jobs) {
+            jobs->parallelFor(static_cast<std::size_t>(width), ColumnGrain, columnRange);
+            jobs->parallelFor(static_cast<std::size_t>(height), RowGrain, rowRange);
+        }
+        else {
+            columnRange(0, static_cast<std::size_t>(width));
+            rowRange(0, static_cast<std::size_t>(height));
+        }
+        stats.wallColumns = hits.load();
+    }
+
+    // Row-major RGBA, width * height * 4 bytes, ready for sf::Texture::update()
+    const sf::Uint8* getPixels() const {
+        return reinterpret_cast<const sf::Uint8*>(pixels.data());
+    }
+
+    // Distance to the wall drawn in each column, in cells along the view direction
+    const std::vector<float>& getDepth() const {
+        return depth;
+    }
+
+    sf::Vector2u getSize() const {
+        return sf::Vector2u(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
@@ -0,0 +1,278 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// Drawable whose text arrives through a render command list; setText() and
+// draw() both run on the thread that plays the list, so the text is laid
+// out there and the recording thread never touches the sf::Text.
+class TextDrawable : public sf::Drawable {
+public:
+    virtual void setText(const char* text, std::size_t length) = 0;
+};
+
+// ─────────────────────────────────────────────
+// RenderCommandList Class
+// One frame of drawing, recorded by the simulation thread and played back
+// on whichever thread owns the render target. Everything that changes from
+// frame to frame (vertices, views, shapes, text) is copied into the list's
+// arenas, so the list stays valid however the game state moves on after it
+// is recorded. Only textures and drawables the recording side never
+// modifies again are referenced by pointer. reset() keeps the capacity, so
+// after the first few frames recording does not allocate.
+// Retained geometry (see RenderCommandPlayer) is the exception: once a
+// version has gone out in a list, later lists only name it, as long as the
+// player said it keeps geometry in vertex buffers.
+// ─────────────────────────────────────────────
+class RenderCommandList {
+public:
+    enum class Kind : std::uint8_t { Clear, View, Vertices, Retained, Drawable, Text };
+
+    // Version of each retained key sent in an earlier list, shared by the
+    // lists played one after another by the same player
+    using SentVersions = std::unordered_map<const void*, std::uint64_t>;
+
+    struct Command {
+        Kind kind = Kind::Clear;
+        sf::PrimitiveType primitive = sf::Quads;
+        sf::Color color;                    // Clear
+        std::uint32_t first = 0, count = 0; // Range in the arena of the command's kind
+        sf::RenderStates states;
+        const sf::Drawable* drawable = nullptr;
+        TextDrawable* text = nullptr;
+        const void* retainedKey = nullptr;  // Vertices, Retained: geometry the player may keep on the GPU
+        std::uint64_t version = 0;          // Changes whenever that geometry does
+    };
+
+private:
+    std::vector<Command> commands;
+    sf::VertexArray vertices;
+    std::vector<sf::View> views;
+    std::vector<char> chars;
+    std::size_t drawCount = 0;
+    SentVersions* sent = nullptr;
+    bool playerRetains = false;
+
+public:
+    sf::Time submitTime;                    // Stamped by RenderThread::submit()
+
+    void reset() {
+        commands.clear();
+        vertices.clear();
+        views.clear();
+        chars.clear();
+        drawCount = 0;
+    }
+
+    // Lets retained geometry already sent be drawn without copying it;
+    // player_retains comes from RenderCommandPlayer::isRetaining()
+    void setRetention(SentVersions* sent_versions, bool player_retains) {
+        sent = sent_versions;
+        playerRetains = player_retains;
+    }
+
+    void clear(const sf::Color& color) {
+        Command command;
+        command.kind = Kind::Clear;
+        command.color = color;
+        commands.push_back(command);
+    }
+
+    void setView(const sf::View& view) {
+        Command command;
+        command.kind = Kind::View;
+        command.first = static_cast<std::uint32_t>(views.size());
+        views.push_back(view);
+        commands.push_back(command);
+    }
+
+    // Vertex arena; append to it directly, then draw the appended range with drawVertices(first, ...)
+    sf::VertexArray& getVertices() {
+        return vertices;
+    }
+
+    // Draws every vertex appended to the arena from first on
+    void drawVertices(std::size_t first, sf::PrimitiveType primitive, const sf::RenderStates& states = sf::RenderStates::Default) {
+        if (first >= vertices.getVertexCount())
+            return;
+        Command command;
+        command.kind = Kind::Vertices;
+        command.primitive = primitive;
+        command.first = static_cast<std::uint32_t>(first);
+        command.count = static_cast<std::uint32_t>(vertices.getVertexCount() - first);
+        command.states = states;
+        commands.push_back(command);
+        drawCount++;
+    }
+
+    // Copies the vertices; with a retained key the player uploads them to
+    // a vertex buffer once per version and draws that buffer afterwards.
+    // A version an earlier list already carried is not copied again.
+    void drawVertices(const sf::Vertex* source, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states,
+        const void* retained_key = nullptr, std::uint64_t version = 0) {
+        if (retained_key && count > 0 && sent) {
+            auto it = sent->find(retained_key);
+            if (playerRetains && it != sent->end() && it->second == version) {
+                Command command;
+                command.kind = Kind::Retained;
+                command.primitive = primitive;
+                command.count = static_cast<std::uint32_t>(count);
+                command.states = states;
+                command.retainedKey = retained_key;
+                command.version = version;
+                commands.push_back(command);
+                drawCount++;
+                return;
+            }
+            (*sent)[retained_key] = version;
+        }
+        std::size_t first = vertices.getVertexCount();
+        vertices.resize(first + count);
+        for (std::size_t i = 0; i < count; i++) vertices[first + i] = source[i];
+        drawVertices(first, primitive, states);
+        if (count > 0) {
+            commands.back().retainedKey = retained_key;
+            commands.back().version = version;
+        }
+    }
+
+    // Copies the shape as one textured quad in its fill colour; outlines are not drawn
+    void drawRectangle(const sf::RectangleShape& shape, sf::RenderStates states = sf::RenderStates::Default) {
+        static const sf::Vector2f corners[4] = { { 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f } };
+        const sf::Transform& transform = shape.getTransform();
+        sf::Vector2f size = shape.getSize();
+        sf::FloatRect uv(shape.getTextureRect());
+        std::size_t first = vertices.getVertexCount();
+        vertices.resize(first + 4);
+        for (std::size_t k = 0; k < 4; k++) {
+            sf::Vertex& vertex = vertices[first + k];
+            vertex.position = transform.transformPoint(corners[k].x * size.x, corners[k].y * size.y);
+            vertex.color = shape.getFillColor();
+            vertex.texCoords = sf::Vector2f(uv.left + uv.width * corners[k].x, uv.top + uv.height * corners[k].y);
+        }
+        states.texture = shape.getTexture();
+        drawVertices(first, sf::Quads, states);
+    }
+
+    // The drawable is used as it is at playback time, so the recording side
+    // must not change it while a list that holds it may still be playing
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        Command command;
+        command.kind = Kind::Drawable;
+        command.drawable = &drawable;
+        command.states = states;
+        commands.push_back(command);
+        drawCount++;
+    }
+
+    void drawText(TextDrawable& target, const char* text, std::size_t length, const sf::RenderStates& states = sf::RenderStates::Default) {
+        Command command;
+        command.kind = Kind::Text;
+        command.text = &target;
+        command.first = static_cast<std::uint32_t>(chars.size());
+        command.count = static_cast<std::uint32_t>(length);
+        command.states = states;
+        chars.insert(chars.end(), text, text + length);
+        commands.push_back(command);
+        drawCount++;
+    }
+
+    const std::vector<Command>& getCommands() const { return commands; }
+    const sf::VertexArray& getVertexArena() const { return vertices; }
+    const sf::View& getView(std::size_t index) const { return views[index]; }
+    const char* getChars(std::size_t first) const { return chars.data() + first; }
+
+    // Draw commands recorded, the draw calls the frame will cost at most
+    std::size_t getDrawCount() const {
+        return drawCount;
+    }
+};
+
+// ─────────────────────────────────────────────
+// RenderCommandPlayer Class
+// Replays command lists onto a render target. Retained geometry (the tile
+// chunks) lives in static vertex buffers keyed by the recording object, and
+// is uploaded again only when the command carries a new version. Must be
+// used from the thread whose GL context is active on the target, except
+// isRetaining(), which the recording thread reads.
+// ─────────────────────────────────────────────
+class RenderCommandPlayer {
+private:
+    struct Retained {
+        sf::VertexBuffer buffer{ sf::Quads, sf::VertexBuffer::Static };
+        std::uint64_t version = 0;
+        bool uploaded = false;
+    };
+    std::unordered_map<const void*, Retained> retained;
+    std::atomic<bool> retaining{ false };
+
+public:
+    // True once a list has been played with vertex buffers available: from
+    // then on geometry it was sent stays on the GPU
+    bool isRetaining() const {
+        return retaining.load(std::memory_order_relaxed);
+    }
+
+    // Returns the number of draw calls issued
+    unsigned int play(const RenderCommandList& list, sf::RenderTarget& target) {
+        retaining.store(sf::VertexBuffer::isAvailable(), std::memory_order_relaxed);
+        unsigned int drawCalls = 0;
+        const sf::VertexArray& vertices = list.getVertexArena();
+        for (const RenderCommandList::Command& command : list.getCommands()) {
+            switch (command.kind) {
+                case RenderCommandList::Kind::Clear:
+                    target.clear(command.color);
+                    break;
+                case RenderCommandList::Kind::View:
+                    target.setView(list.getView(command.first));
+                    break;
+                case RenderCommandList::Kind::Vertices:
+                    if (command.retainedKey && sf::VertexBuffer::isAvailable()) {
+                        Retained& geometry = retained[command.retainedKey];
+                        if (!geometry.uploaded || geometry.version != command.version) {
+                            geometry.buffer.setPrimitiveType(command.primitive);
+                            if (geometry.buffer.getVertexCount() != command.count)
+                                geometry.buffer.create(command.count);
+                            geometry.buffer.update(&vertices[command.first]);
+                            geometry.version = command.version;
+                            geometry.uploaded = true;
+                        }
+                        target.draw(geometry.buffer, command.states);
+                    }
+                    else
+                        target.draw(&vertices[command.first], command.count, command.primitive, command.states);
+                    drawCalls++;
+                    break;
+                case RenderCommandList::Kind::Retained: {
+                    // Sent by an earlier list; missing only if the buffers were released since
+                    auto it = retained.find(command.retainedKey);
+                    if (it != retained.end() && it->second.uploaded && it->second.version == command.version) {
+                        target.draw(it->second.buffer, command.states);
+                        drawCalls++;
+                    }
+                    break;
+                }
+                case RenderCommandList::Kind::Drawable:
+                    target.draw(*command.drawable, command.states);
+                    drawCalls++;
+                    break;
+                case RenderCommandList::Kind::Text:
+                    command.text->setText(list.getChars(command.first), command.count);
+                    target.draw(*command.text, command.states);
+                    drawCalls++;
+                    break;
+            }
+        }
+        return drawCalls;
+    }
+
+    // Drops every retained vertex buffer; call on the thread that played the
+    // lists, and forget what was sent before recording the next one
+    void releaseRetained() {
+        retained.clear();
+        retaining.store(false, std::memory_order_relaxed);
+    }
+};
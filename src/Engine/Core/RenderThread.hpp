@@ -0,0 +1,209 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "Profiler.hpp"
+#include "RenderCommands.hpp"
+
+// ─────────────────────────────────────────────
+// RenderThread Class
+// Plays the frames the simulation records on a thread of their own, which
+// owns the target's GL context and presents, so the next ticks run while
+// the previous frame is drawn and waits for vsync. There are two command
+// lists: the simulation records into one while the other is drawn. Handing
+// a list over is one atomic store and taking it one atomic exchange; the
+// only waits are the render thread sleeping until a list arrives and the
+// simulation waiting for a free list when it is a whole frame ahead, which
+// it does in short slices so the caller can keep handling input, and
+// waitForIdle() before resources the frames draw with are changed.
+//
+// Without start() nothing runs in the background and playNow() draws the
+// recorded list on the calling thread instead.
+// ─────────────────────────────────────────────
+class RenderThread {
+public:
+    struct Stats {
+        std::uint64_t submitted = 0;        // Lists handed to the render thread
+        std::uint64_t presented = 0;        // Frames it has drawn and presented
+        unsigned int queueDepth = 0;        // Submitted and not presented yet: 0, 1 or 2
+        unsigned int maxQueueDepth = 0;
+        float averageQueueDepth = 0.f;      // Sampled at every submit, the new list included
+        sf::Time lastLatency, averageLatency, maxLatency;  // From submit to the end of present
+        std::uint64_t stalls = 0;           // Frames the simulation had to wait for a free list
+        sf::Time stallTime;
+        unsigned int drawCalls = 0;         // Issued by the last frame played
+    };
+
+private:
+    static constexpr int NoList = -1;
+    static constexpr int StopRequest = -2;
+
+    RenderCommandList lists[2];
+    RenderCommandPlayer player;             // Used by the thread that owns the context only
+    RenderCommandList::SentVersions sentVersions;   // Retained geometry the recorded lists carried; simulation thread only
+    sf::RenderTarget* target = nullptr;
+    void (*present)(sf::RenderTarget&) = nullptr;
+    std::thread thread;
+    sf::Clock clock;                        // Read from both threads
+
+    int recording = 0;                      // List the simulation records into next
+    std::atomic<int> pending{ NoList };     // Submitted list the render thread has not taken yet
+    std::atomic<unsigned int> queued{ 0 };
+
+    // Written by the simulation thread only
+    std::uint64_t submitted = 0, depthTotal = 0, stalls = 0;
+    unsigned int maxDepth = 0;
+    sf::Time stallTime;
+
+    // Written by the render thread only, in microseconds
+    std::atomic<std::uint64_t> presented{ 0 };
+    std::atomic<std::int64_t> lastLatency{ 0 }, latencyTotal{ 0 }, maxLatency{ 0 };
+    std::atomic<unsigned int> drawCalls{ 0 };
+
+    void loop() {
+        PROFILE_THREAD_NAME("Render");
+        target->setActive(true);
+        for (;;) {
+            // Taking the list also tells the simulation the other one is free again
+            int index = pending.exchange(NoList, std::memory_order_acq_rel);
+            if (index == StopRequest)
+                break;
+            if (index == NoList) {
+                pending.wait(NoList, std::memory_order_acquire);
+                continue;
+            }
+
+            const RenderCommandList& list = lists[index];
+            {
+                PROFILE_ZONE("Draw");
+                drawCalls.store(player.play(list, *target), std::memory_order_relaxed);
+            }
+            {
+                PROFILE_ZONE("Present");
+                present(*target);
+            }
+            std::int64_t latency = (clock.getElapsedTime() - list.submitTime).asMicroseconds();
+            lastLatency.store(latency, std::memory_order_relaxed);
+            latencyTotal.fetch_add(latency, std::memory_order_relaxed);
+            if (latency > maxLatency.load(std::memory_order_relaxed))
+                maxLatency.store(latency, std::memory_order_relaxed);
+            presented.fetch_add(1, std::memory_order_relaxed);
+            queued.fetch_sub(1, std::memory_order_release);
+        }
+        player.releaseRetained();
+        target->setActive(false);
+    }
+
+public:
+    RenderThread() = default;
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    ~RenderThread() {
+        stop();
+    }
+
+    // Moves render_target's context to the render thread. Target is
+    // sf::RenderWindow or sf::RenderTexture; the caller keeps polling the
+    // window's events but must not draw to it until stop().
+    template <typename Target>
+    void start(Target& render_target) {
+        if (isRunning())
+            return;
+        target = &render_target;
+        present = [](sf::RenderTarget& presented_target) { static_cast<Target&>(presented_target).display(); };
+        render_target.setActive(false);
+        pending.store(NoList);
+        thread = std::thread([this]() { loop(); });
+    }
+
+    // Waits for the frame being drawn and drops one that was not taken yet;
+    // the context is released, so the caller can make it current again
+    void stop() {
+        if (!thread.joinable())
+            return;
+        pending.store(StopRequest, std::memory_order_release);
+        pending.notify_one();
+        thread.join();
+        queued.store(0);
+        recording = 0;
+        sentVersions.clear();   // The player let go of its buffers and a pending list may have been dropped
+    }
+
+    bool isRunning() const {
+        return thread.joinable();
+    }
+
+    // True once the next list is free to record into. While the render
+    // thread is still on the frame before last, waits at most timeout so
+    // the caller can poll input between tries.
+    bool waitForSlot(sf::Time timeout) {
+        if (!isRunning() || pending.load(std::memory_order_acquire) == NoList)
+            return true;
+        PROFILE_ZONE("WaitForRender");
+        sf::Clock waited;
+        bool free = false;
+        while (!free && waited.getElapsedTime() < timeout) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            free = pending.load(std::memory_order_acquire) == NoList;
+        }
+        stallTime += waited.getElapsedTime();
+        stalls += free;
+        return free;
+    }
+
+    // Blocks until every submitted frame has been presented. Until the next
+    // submit() the render thread touches nothing, so the caller may change
+    // what recorded frames use, e.g. reload a texture in place.
+    void waitForIdle() {
+        if (!isRunning())
+            return;
+        PROFILE_ZONE("WaitForRender");
+        while (queued.load(std::memory_order_acquire) != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // Emptied list for the next frame; only valid after waitForSlot() returned true
+    RenderCommandList& beginFrame() {
+        lists[recording].reset();
+        lists[recording].setRetention(&sentVersions, player.isRetaining());
+        return lists[recording];
+    }
+
+    // Hands the recorded list to the render thread
+    void submit() {
+        RenderCommandList& list = lists[recording];
+        list.submitTime = clock.getElapsedTime();
+        unsigned int depth = queued.fetch_add(1, std::memory_order_relaxed) + 1;
+        submitted++;
+        depthTotal += depth;
+        maxDepth = std::max(maxDepth, depth);
+        pending.store(recording, std::memory_order_release);
+        pending.notify_one();
+        recording ^= 1;
+    }
+
+    // Draws the recorded list on the calling thread, for runs without the render thread
+    void playNow(sf::RenderTarget& render_target) {
+        drawCalls.store(player.play(lists[recording], render_target), std::memory_order_relaxed);
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.submitted = submitted;
+        stats.presented = presented.load(std::memory_order_relaxed);
+        stats.queueDepth = queued.load(std::memory_order_relaxed);
+        stats.maxQueueDepth = maxDepth;
+        stats.averageQueueDepth = submitted ? static_cast<float>(depthTotal) / submitted : 0.f;
+        stats.lastLatency = sf::microseconds(lastLatency.load(std::memory_order_relaxed));
+        stats.averageLatency = stats.presented ? sf::microseconds(latencyTotal.load(std::memory_order_relaxed) / static_cast<std::int64_t>(stats.presented)) : sf::Time::Zero;
+        stats.maxLatency = sf::microseconds(maxLatency.load(std::memory_order_relaxed));
+        stats.stalls = stalls;
+        stats.stallTime = stallTime;
+        stats.drawCalls = drawCalls.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
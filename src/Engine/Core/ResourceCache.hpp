@@ -0,0 +1,376 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Log.hpp"
+
+// ─────────────────────────────────────────────
+// TextureAtlas Class
+// Packs many sprite images into one texture with a sub-rectangle per image,
+// so switching animation frames is a texture-rect change instead of a bind.
+// Headless runs can pack the layout alone, without creating the texture.
+// ─────────────────────────────────────────────
+class TextureAtlas {
+private:
+    static constexpr unsigned int Padding = 1;      // Keeps filtering from bleeding between frames
+
+    std::unique_ptr<sf::Texture> texture;   // Null until uploaded
+    std::unordered_map<std::string, sf::IntRect> rects;
+
+public:
+    using NamedImage = std::pair<std::string, const sf::Image*>;
+
+    // Loads the images from disk and packs them
+    bool build(const std::vector<std::string>& paths, unsigned int max_width = 2048) {
+        std::vector<sf::Image> images(paths.size());
+        std::vector<NamedImage> entries;
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (!images[i].loadFromFile(paths[i])) {
+                LOG_ERROR << "Failed to load atlas image " << paths[i];
+                continue;
+            }
+            entries.emplace_back(paths[i], &images[i]);
+        }
+        return pack(entries, max_width);
+    }
+
+    // Shelf-packs already decoded images (tallest first) into rows no wider than
+    // max_width; with upload off only the rects are computed and no GL context is
+    // needed. page_out, when given, receives the composed page either way.
+    bool pack(std::vector<NamedImage> entries, unsigned int max_width = 2048, bool upload = true, sf::Image* page_out = nullptr) {
+        std::sort(entries.begin(), entries.end(), [](const NamedImage& a, const NamedImage& b) {
+            if (a.second->getSize().y != b.second->getSize().y)
+                return a.second->getSize().y > b.second->getSize().y;
+            return a.first < b.first;
+        });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const NamedImage& a, const NamedImage& b) {
+            return a.first == b.first;
+        }), entries.end());
+
+        unsigned int maxSize = upload ? sf::Texture::getMaximumSize() : 0xFFFFu;
+        max_width = std::min(max_width, maxSize);
+        unsigned int x = 0, y = 0, shelfHeight = 0, width = 0;
+        std::vector<sf::Vector2u> positions;
+        for (const auto& entry : entries) {
+            sf::Vector2u size = entry.second->getSize();
+            if (x + size.x > max_width) {
+                x = 0;
+                y += shelfHeight + Padding;
+                shelfHeight = 0;
+            }
+            positions.emplace_back(x, y);
+            x += size.x + Padding;
+            width = std::max(width, x);
+            shelfHeight = std::max(shelfHeight, size.y);
+        }
+        unsigned int height = y + shelfHeight;
+        if (entries.empty() || height > maxSize)
+            return false;
+
+        for (std::size_t i = 0; i < entries.size(); i++) {
+            sf::Vector2u size = entries[i].second->getSize();
+            rects[entries[i].first] = sf::IntRect(positions[i].x, positions[i].y, size.x, size.y);
+        }
+        if (!upload && !page_out)
+            return true;
+
+        sf::Image composed;
+        sf::Image& page = page_out ? *page_out : composed;
+        page.create(width, height, sf::Color::Transparent);
+        for (std::size_t i = 0; i < entries.size(); i++)
+            page.copy(*entries[i].second, positions[i].x, positions[i].y);
+        if (!upload)
+            return true;
+        texture = std::make_unique<sf::Texture>();
+        return texture->loadFromImage(page);
+    }
+
+    // Takes a page packed ahead of time (e.g. from an asset pack) as is: the
+    // RGBA pixels go straight to the texture, the rects are used unchanged
+    bool adopt(const std::uint8_t* pixels, sf::Vector2u size, const std::vector<std::pair<std::string, sf::IntRect>>& frames, bool upload = true) {
+        for (const auto& frame : frames)
+            rects[frame.first] = frame.second;
+        if (!upload)
+            return !frames.empty();
+        texture = std::make_unique<sf::Texture>();
+        if (!texture->create(size.x, size.y))
+            return false;
+        texture->update(pixels);
+        return true;
+    }
+
+    // Puts a new version of a packed image into its rect, in place, so the
+    // texture and every rect handed out stay valid. False if the image was
+    // never packed or changed size; repacking needs a restart.
+    bool replace(const std::string& path, const sf::Image& image) {
+        sf::IntRect rect = getRect(path);
+        if (rect == sf::IntRect() || image.getSize() != sf::Vector2u(rect.width, rect.height))
+            return false;
+        if (texture)
+            texture->update(image, static_cast<unsigned int>(rect.left), static_cast<unsigned int>(rect.top));
+        return true;
+    }
+
+    // False when only the layout was packed
+    bool hasTexture() const {
+        return texture != nullptr;
+    }
+
+    // Only when hasTexture()
+    const sf::Texture& getTexture() const {
+        assert(texture && "Atlas was packed without a texture");
+        return *texture;
+    }
+
+    bool contains(const std::string& path) const {
+        return rects.count(path) != 0;
+    }
+
+    const std::unordered_map<std::string, sf::IntRect>& getRects() const {
+        return rects;
+    }
+
+    // Sub-rectangle of an image inside the atlas; empty if it was never packed
+    sf::IntRect getRect(const std::string& path) const {
+        auto it = rects.find(path);
+        return it != rects.end() ? it->second : sf::IntRect();
+    }
+
+    std::size_t getByteSize() const {
+        return texture ? static_cast<std::size_t>(texture->getSize().x) * texture->getSize().y * 4 : 0;
+    }
+};
+
+// ─────────────────────────────────────────────
+// ResourceCache Class
+// Central owner of textures, sound buffers and atlases, keyed by path so each
+// file is decoded and uploaded once no matter how many objects use it.
+// References stay valid for the lifetime of the cache.
+// ─────────────────────────────────────────────
+class ResourceCache {
+public:
+    struct Stats {
+        unsigned int loads = 0;             // Files decoded from disk
+        unsigned int hits = 0;              // Requests served from the cache
+        float loadSeconds = 0.f;            // Time spent decoding and uploading
+        std::size_t textureBytes = 0;       // RGBA bytes resident in textures and atlases
+        std::size_t soundBytes = 0;         // 16-bit sample bytes resident in sound buffers
+    };
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
+    std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> soundBuffers;
+    std::unordered_map<std::string, std::unique_ptr<TextureAtlas>> atlases;
+    std::unordered_map<std::string, std::pair<const void*, std::size_t>> streams;     // Not owned
+    Stats stats;
+
+public:
+    const sf::Texture& getTexture(const std::string& path) {
+        auto it = textures.find(path);
+        if (it != textures.end()) {
+            stats.hits++;
+            return *it->second;
+        }
+
+        sf::Clock timer;
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromFile(path)) {
+            LOG_ERROR << "Failed to load texture " << path;
+        }
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += static_cast<std::size_t>(texture->getSize().x) * texture->getSize().y * 4;
+        return *textures.emplace(path, std::move(texture)).first->second;
+    }
+
+    const sf::SoundBuffer& getSoundBuffer(const std::string& path) {
+        auto it = soundBuffers.find(path);
+        if (it != soundBuffers.end()) {
+            stats.hits++;
+            return *it->second;
+        }
+
+        sf::Clock timer;
+        auto buffer = std::make_unique<sf::SoundBuffer>();
+        if (!buffer->loadFromFile(path)) {
+            LOG_ERROR << "Failed to load sound " << path;
+        }
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.soundBytes += static_cast<std::size_t>(buffer->getSampleCount()) * sizeof(sf::Int16);
+        return *soundBuffers.emplace(path, std::move(buffer)).first->second;
+    }
+
+    // Returns the named atlas, packing it from the given images on first use
+    const TextureAtlas& getAtlas(const std::string& name, const std::vector<std::string>& paths) {
+        auto it = atlases.find(name);
+        if (it != atlases.end()) {
+            stats.hits++;
+            return *it->second;
+        }
+
+        sf::Clock timer;
+        auto atlas = std::make_unique<TextureAtlas>();
+        if (!atlas->build(paths)) {
+            LOG_ERROR << "Failed to build atlas " << name;
+        }
+        stats.loads += static_cast<unsigned int>(paths.size());
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += atlas->getByteSize();
+        return *atlases.emplace(name, std::move(atlas)).first->second;
+    }
+
+    // Uploads an image decoded elsewhere (e.g. by AssetLoader) under its path
+    const sf::Texture& addTexture(const std::string& path, const sf::Image& image) {
+        auto it = textures.find(path);
+        if (it != textures.end())
+            return *it->second;
+
+        sf::Clock timer;
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromImage(image)) {
+            LOG_ERROR << "Failed to upload texture " << path;
+        }
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += static_cast<std::size_t>(texture->getSize().x) * texture->getSize().y * 4;
+        return *textures.emplace(path, std::move(texture)).first->second;
+    }
+
+    // Uploads raw RGBA pixels (e.g. mapped from an asset pack) without an sf::Image in between
+    const sf::Texture& addTexture(const std::string& path, const std::uint8_t* pixels, sf::Vector2u size) {
+        auto it = textures.find(path);
+        if (it != textures.end())
+            return *it->second;
+
+        sf::Clock timer;
+        auto texture = std::make_unique<sf::Texture>();
+        if (texture->create(size.x, size.y))
+            texture->update(pixels);
+        else
+            LOG_ERROR << "Failed to upload texture " << path;
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += static_cast<std::size_t>(texture->getSize().x) * texture->getSize().y * 4;
+        return *textures.emplace(path, std::move(texture)).first->second;
+    }
+
+    // Wraps samples decoded elsewhere into a sound buffer under its path
+    const sf::SoundBuffer& addSoundBuffer(const std::string& path, const std::vector<sf::Int16>& samples, unsigned int channel_count, unsigned int sample_rate) {
+        return addSoundBuffer(path, samples.data(), samples.size(), channel_count, sample_rate);
+    }
+
+    const sf::SoundBuffer& addSoundBuffer(const std::string& path, const sf::Int16* samples, std::size_t sample_count, unsigned int channel_count, unsigned int sample_rate) {
+        auto it = soundBuffers.find(path);
+        if (it != soundBuffers.end())
+            return *it->second;
+
+        sf::Clock timer;
+        auto buffer = std::make_unique<sf::SoundBuffer>();
+        if (sample_count == 0 || !buffer->loadFromSamples(samples, sample_count, channel_count, sample_rate)) {
+            LOG_ERROR << "Failed to create sound " << path;
+        }
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.soundBytes += static_cast<std::size_t>(buffer->getSampleCount()) * sizeof(sf::Int16);
+        return *soundBuffers.emplace(path, std::move(buffer)).first->second;
+    }
+
+    // Packs images decoded elsewhere into a named atlas (layout only when upload is off)
+    const TextureAtlas& addAtlas(const std::string& name, const std::vector<TextureAtlas::NamedImage>& images, bool upload = true) {
+        auto it = atlases.find(name);
+        if (it != atlases.end())
+            return *it->second;
+
+        sf::Clock timer;
+        auto atlas = std::make_unique<TextureAtlas>();
+        if (!atlas->pack(images, 2048, upload)) {
+            LOG_ERROR << "Failed to build atlas " << name;
+        }
+        stats.loads += static_cast<unsigned int>(images.size());
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += atlas->getByteSize();
+        return *atlases.emplace(name, std::move(atlas)).first->second;
+    }
+
+    // Atlas packed ahead of time; see TextureAtlas::adopt()
+    const TextureAtlas& addAtlas(const std::string& name, const std::uint8_t* pixels, sf::Vector2u size,
+        const std::vector<std::pair<std::string, sf::IntRect>>& frames, bool upload = true) {
+        auto it = atlases.find(name);
+        if (it != atlases.end())
+            return *it->second;
+
+        sf::Clock timer;
+        auto atlas = std::make_unique<TextureAtlas>();
+        if (!atlas->adopt(pixels, size, frames, upload)) {
+            LOG_ERROR << "Failed to load atlas " << name;
+        }
+        stats.loads += static_cast<unsigned int>(frames.size());
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        stats.textureBytes += atlas->getByteSize();
+        return *atlases.emplace(name, std::move(atlas)).first->second;
+    }
+
+    // Re-reads an image that changed on disk into whatever already holds it:
+    // the texture loaded from that path and the rect of every atlas it was
+    // packed into. Objects stay where they are, so references taken before
+    // remain valid. False if nothing holds the path or it could not be
+    // applied (unreadable, or an atlas image changed size).
+    bool reloadTexture(const std::string& path) {
+        bool held = textures.count(path) != 0;
+        for (const auto& [name, atlas] : atlases) held = held || atlas->contains(path);
+        if (!held)
+            return false;
+
+        sf::Clock timer;
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            LOG_ERROR << "Failed to reload " << path;
+            return false;
+        }
+        bool applied = true;
+        auto it = textures.find(path);
+        if (it != textures.end()) {
+            sf::Texture& texture = *it->second;
+            std::size_t oldBytes = static_cast<std::size_t>(texture.getSize().x) * texture.getSize().y * 4;
+            if (texture.getSize() == image.getSize())
+                texture.update(image);
+            else if (texture.loadFromImage(image))
+                stats.textureBytes += static_cast<std::size_t>(image.getSize().x) * image.getSize().y * 4 - oldBytes;
+            else
+                applied = false;
+        }
+        for (const auto& [name, atlas] : atlases) {
+            if (atlas->contains(path) && !atlas->replace(path, image)) {
+                LOG_WARNING << path << " changed size; restart to repack the " << name << " atlas";
+                applied = false;
+            }
+        }
+        stats.loads++;
+        stats.loadSeconds += timer.getElapsedTime().asSeconds();
+        return applied;
+    }
+
+    // Registers an encoded file already in memory (e.g. in a mapped asset
+    // pack) for sf::Music to stream from; the memory must outlive the cache
+    void addStream(const std::string& path, const void* data, std::size_t size) {
+        streams[path] = { data, size };
+    }
+
+    // Bytes registered with addStream(), or { nullptr, 0 }
+    std::pair<const void*, std::size_t> findStream(const std::string& path) const {
+        auto it = streams.find(path);
+        return it != streams.end() ? it->second : std::pair<const void*, std::size_t>(nullptr, 0);
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
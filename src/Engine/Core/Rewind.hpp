@@ -0,0 +1,304 @@
+#pragma once
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// RewindBuffer Class
+// Per-tick history of state images (see StateStream.hpp) in a fixed byte
+// budget. Every keyframeInterval ticks the full image is kept; the ticks in
+// between are XORed against that keyframe and stored as runs of unchanged
+// bytes and changed ones, so a tick costs only the bytes that moved since
+// the keyframe. Restoring any tick decodes at most one keyframe and one
+// delta. Entries go into a ring arena allocated once: when it is full the
+// oldest ticks are dropped, so memory never grows while the game runs.
+//
+// Ticks are pushed in order, one per tick. Pushing a tick already held
+// drops it and everything after (the timeline was rewritten, e.g. after a
+// rewind); a gap in the ticks starts the history over.
+// ─────────────────────────────────────────────
+class RewindBuffer {
+public:
+    struct Stats {
+        std::size_t ticks = 0;              // Held now
+        std::size_t keyframes = 0;
+        std::size_t bytesUsed = 0;          // Encoded bytes held
+        std::size_t rawBytes = 0;           // What the same ticks take as full images
+        std::size_t budget = 0;
+        std::uint64_t pushes = 0;
+        sf::Time encodeTime;                // Over every push
+    };
+
+private:
+    struct Entry {
+        std::uint64_t tick = 0;
+        std::uint64_t keyTick = 0;          // Equal to tick for a keyframe
+        std::size_t offset = 0, size = 0;   // Encoded bytes in the arena
+        std::size_t rawSize = 0;
+    };
+
+    std::unique_ptr<std::uint8_t[]> arena;
+    std::size_t capacity = 0;
+    std::size_t head = 0;                   // Next free byte
+    std::vector<Entry> entries;             // Ring of maxTicks entries, oldest at first
+    std::size_t first = 0, count = 0;
+    std::uint64_t keyframeInterval;
+    std::vector<std::uint8_t> keyframe;     // Raw image of the newest keyframe
+    std::uint64_t keyTick = 0;
+    std::vector<std::uint8_t> scratch;      // Encoded entry before it is copied in
+    Stats stats;
+
+    Entry& at(std::size_t index) {
+        return entries[(first + index) % entries.size()];
+    }
+
+    const Entry& at(std::size_t index) const {
+        return entries[(first + index) % entries.size()];
+    }
+
+    void popFront() {
+        const Entry& oldest = at(0);
+        stats.bytesUsed -= oldest.size;
+        stats.rawBytes -= oldest.rawSize;
+        if (oldest.keyTick == oldest.tick)
+            stats.keyframes--;
+        first = (first + 1) % entries.size();
+        count--;
+    }
+
+    void popBack() {
+        const Entry& newest = at(count - 1);
+        stats.bytesUsed -= newest.size;
+        stats.rawBytes -= newest.rawSize;
+        if (newest.keyTick == newest.tick)
+            stats.keyframes--;
+        head = newest.offset;
+        count--;
+    }
+
+    static std::uint8_t* putCount(std::uint8_t* out, std::size_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(value);
+        return out;
+    }
+
+    static std::size_t getCount(const std::uint8_t*& in) {
+        std::size_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            std::uint8_t byte = *in++;
+            value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+    }
+
+    static std::uint64_t load8(const std::uint8_t* at) {
+        std::uint64_t value;
+        std::memcpy(&value, at, 8);
+        return value;
+    }
+
+    // Length of the run of bytes equal in a and b from offset on: whole
+    // cache lines at a time while they match, then eight bytes at a time
+    static std::size_t sameRun(const std::uint8_t* a, const std::uint8_t* b, std::size_t offset, std::size_t size) {
+        std::size_t i = offset;
+        while (i + 64 <= size && std::memcmp(a + i, b + i, 64) == 0) i += 64;
+        while (i + 8 <= size) {
+            std::uint64_t diff = load8(a + i) ^ load8(b + i);
+            if (diff) {
+                int bits = std::endian::native == std::endian::little ? std::countr_zero(diff) : std::countl_zero(diff);
+                return i + static_cast<std::size_t>(bits / 8) - offset;
+            }
+            i += 8;
+        }
+        while (i < size && a[i] == b[i]) i++;
+        return i - offset;
+    }
+
+    // XOR of state against the keyframe as (unchanged count, changed count,
+    // changed bytes) runs; unchanged gaps shorter than a run header are
+    // folded into the changed run. False, with scratch undefined, once the
+    // delta would be no smaller than the state itself.
+    bool encodeDelta(const std::vector<std::uint8_t>& state) {
+        const std::uint8_t* base = keyframe.data();
+        const std::uint8_t* now = state.data();
+        std::size_t size = state.size(), i = 0;
+        scratch.resize(size + 32);          // Room for one more run header past the limit
+        std::uint8_t* out = scratch.data();
+        std::uint8_t* limit = out + size;
+        while (i < size) {
+            std::size_t same = sameRun(base, now, i, size);
+            i += same;
+            if (i == size)
+                break;
+            std::size_t end = i + 1;
+            while (end < size) {
+                std::size_t gap = sameRun(base, now, end, size);
+                if (gap >= 4 || end + gap == size)
+                    break;
+                end += gap + 1;
+            }
+            out = putCount(out, same);
+            out = putCount(out, end - i);
+            if (out + (end - i) >= limit)
+                return false;
+            for (std::size_t k = i; k < end; k++) *out++ = static_cast<std::uint8_t>(base[k] ^ now[k]);
+            i = end;
+        }
+        scratch.resize(static_cast<std::size_t>(out - scratch.data()));
+        return true;
+    }
+
+    // Finds room for size bytes, dropping the oldest ticks it overlaps
+    std::size_t allocate(std::size_t size) {
+        if (head + size > capacity) {
+            // Entries past the old head are from the previous lap, older than
+            // everything at the start of the arena, so they go first
+            while (count > 0 && at(0).offset >= head) popFront();
+            head = 0;
+        }
+        while (count > 0) {
+            const Entry& oldest = at(0);
+            bool overlaps = oldest.offset < head + size && head < oldest.offset + oldest.size;
+            if (!overlaps)
+                break;
+            popFront();
+        }
+        // Deltas whose keyframe went are useless
+        while (count > 0 && at(0).keyTick != at(0).tick) popFront();
+        std::size_t offset = head;
+        head += size;
+        return offset;
+    }
+
+public:
+    // max_ticks caps the ticks held whatever the budget; at 100 ticks per
+    // second the default is ten minutes
+    explicit RewindBuffer(std::size_t budget_bytes = 32u << 20, std::uint64_t keyframe_interval = 64, std::size_t max_ticks = 60000)
+        : arena(budget_bytes ? new std::uint8_t[budget_bytes] : nullptr), capacity(budget_bytes),
+          entries(budget_bytes ? max_ticks : 0), keyframeInterval(std::max<std::uint64_t>(keyframe_interval, 1)) {
+        stats.budget = budget_bytes;
+    }
+
+    bool isEnabled() const {
+        return capacity > 0;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    std::uint64_t getOldestTick() const {
+        return count ? at(0).tick : 0;
+    }
+
+    std::uint64_t getNewestTick() const {
+        return count ? at(count - 1).tick : 0;
+    }
+
+    bool contains(std::uint64_t tick) const {
+        return count > 0 && tick >= getOldestTick() && tick <= getNewestTick();
+    }
+
+    void clear() {
+        first = count = head = 0;
+        keyframe.clear();
+        stats.ticks = stats.keyframes = stats.bytesUsed = stats.rawBytes = 0;
+    }
+
+    // Drops every tick after tick
+    void truncate(std::uint64_t tick) {
+        while (count > 0 && at(count - 1).tick > tick) popBack();
+        if (count == 0 || keyTick > tick)
+            keyframe.clear();
+        stats.ticks = count;
+    }
+
+    // Adds the image of the state after tick
+    void push(std::uint64_t tick, const std::vector<std::uint8_t>& state) {
+        if (!isEnabled())
+            return;
+        sf::Clock timer;
+        if (count > 0 && tick <= getNewestTick())
+            truncate(tick - 1);
+        if (count > 0 && tick != getNewestTick() + 1)
+            clear();
+        if (count == entries.size())
+            popFront();
+
+        // A keyframe when the interval is up, the size changed or the last keyframe has been dropped
+        bool isKey = keyframe.empty() || keyframe.size() != state.size() || tick - keyTick >= keyframeInterval ||
+            count == 0 || at(0).tick > keyTick;
+        if (!isKey && !encodeDelta(state))
+            isKey = true;
+        const std::vector<std::uint8_t>& bytes = isKey ? state : scratch;
+        if (bytes.size() > capacity / 2) {
+            clear();            // Cannot hold even two ticks; keep nothing rather than thrash
+            return;
+        }
+
+        Entry entry;
+        entry.tick = tick;
+        entry.keyTick = isKey ? tick : keyTick;
+        entry.size = bytes.size();
+        entry.rawSize = state.size();
+        entry.offset = allocate(bytes.size());
+        if (!isKey && (count == 0 || at(0).tick > keyTick)) {
+            // Making room dropped this delta's own keyframe: store the tick whole instead
+            isKey = true;
+            entry.keyTick = tick;
+            entry.size = state.size();
+            head = entry.offset;
+            entry.offset = allocate(state.size());
+        }
+        std::memcpy(arena.get() + entry.offset, isKey ? state.data() : scratch.data(), entry.size);
+        if (isKey) {
+            keyframe.assign(state.begin(), state.end());
+            keyTick = tick;
+            stats.keyframes++;
+        }
+        entries[(first + count) % entries.size()] = entry;
+        count++;
+
+        stats.ticks = count;
+        stats.bytesUsed += entry.size;
+        stats.rawBytes += entry.rawSize;
+        stats.pushes++;
+        stats.encodeTime += timer.getElapsedTime();
+    }
+
+    // Rebuilds the image of the state after tick into out; false if it is not held
+    bool restore(std::uint64_t tick, std::vector<std::uint8_t>& out) const {
+        if (!contains(tick))
+            return false;
+        const Entry& entry = at(static_cast<std::size_t>(tick - getOldestTick()));
+        const Entry& key = at(static_cast<std::size_t>(entry.keyTick - getOldestTick()));
+        out.assign(arena.get() + key.offset, arena.get() + key.offset + key.size);
+        if (entry.keyTick == entry.tick)
+            return true;
+
+        const std::uint8_t* in = arena.get() + entry.offset;
+        const std::uint8_t* end = in + entry.size;
+        std::size_t position = 0;
+        while (in < end) {
+            position += getCount(in);
+            std::size_t changed = getCount(in);
+            for (std::size_t k = 0; k < changed; k++) out[position + k] ^= in[k];
+            in += changed;
+            position += changed;
+        }
+        return true;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Input.hpp"
+
+// ─────────────────────────────────────────────
+// RollbackSession Class
+// Input bookkeeping for two peers simulating the same game. Every tick is
+// simulated as soon as the local buttons for it are known; the remote
+// player's buttons are predicted (held from the last ones received) until
+// the real ones arrive. When a received input differs from the prediction
+// that was simulated, the session asks for a rollback to that tick: the
+// game restores the state saved after the tick before it and resimulates
+// up to the present with the corrected inputs.
+//
+//   addLocalInput()     once per new tick, for tick + input delay
+//   addRemoteInput()    per input received, in tick order
+//   getInput()          while simulating a tick, once per player
+//   getState(tick)      buffer the game saves the state after tick into
+//   takeRollback()      earliest mispredicted tick, 0 when there is none
+//
+// The session never runs more than MaxPrediction ticks past the last
+// confirmed remote input, so a state to roll back to always exists. Input
+// delay moves local inputs that many ticks into the future: both peers
+// then need fewer predictions, at the cost of that much input lag.
+// ─────────────────────────────────────────────
+class RollbackSession {
+public:
+    static constexpr unsigned int PlayerCount = 2;
+    static constexpr std::uint64_t MaxPrediction = 30;     // Ticks simulated ahead of the remote inputs
+    static constexpr std::uint64_t MaxInputDelay = 8;
+
+    struct Stats {
+        std::uint64_t rollbacks = 0;
+        std::uint64_t resimulatedTicks = 0;
+        std::uint64_t maxRollbackDepth = 0;     // Ticks resimulated by the longest rollback
+        std::uint64_t stalls = 0;               // Ticks waited because the remote inputs were too far behind
+        std::uint64_t remoteInputs = 0;         // Confirmed remote inputs
+        std::uint64_t remoteLateTicks = 0;      // Summed over those: ticks already simulated when each arrived
+    };
+
+private:
+    static constexpr std::size_t Ring = 128;                // Input history per player, in ticks
+    static constexpr std::size_t StateRing = MaxPrediction + 2;
+
+    unsigned int localPlayer;
+    std::uint64_t inputDelay;
+    std::array<std::array<InputState, Ring>, PlayerCount> inputs{};
+    std::array<InputState, Ring> predicted{};   // Remote input each simulated tick used
+    std::uint64_t localLatest;                  // Last tick with a local input
+    std::uint64_t remoteConfirmed;              // Remote inputs known up to here
+    std::uint64_t tick = 0;                     // Last tick simulated
+    std::uint64_t rollbackTick = 0;             // Earliest tick simulated with a wrong prediction
+    std::array<std::vector<std::uint8_t>, StateRing> states;
+    Stats stats;
+
+    unsigned int remotePlayer() const {
+        return 1 - localPlayer;
+    }
+
+public:
+    // Both peers must use the same input delay. Ticks up to it have no
+    // input on either side, so they count as confirmed from the start.
+    RollbackSession(unsigned int local_player, std::uint64_t input_delay)
+        : localPlayer(std::min(local_player, PlayerCount - 1)), inputDelay(std::min(input_delay, MaxInputDelay)),
+          localLatest(inputDelay), remoteConfirmed(inputDelay) {}
+
+    unsigned int getLocalPlayer() const {
+        return localPlayer;
+    }
+
+    std::uint64_t getInputDelay() const {
+        return inputDelay;
+    }
+
+    // Last tick simulated
+    std::uint64_t getTick() const {
+        return tick;
+    }
+
+    // Last tick whose inputs are all known
+    std::uint64_t getConfirmedTick() const {
+        return std::min(remoteConfirmed, localLatest);
+    }
+
+    std::uint64_t getRemoteConfirmed() const {
+        return remoteConfirmed;
+    }
+
+    std::uint64_t getLocalLatest() const {
+        return localLatest;
+    }
+
+    const InputState& getLocalInput(std::uint64_t at_tick) const {
+        return inputs[localPlayer][at_tick % Ring];
+    }
+
+    // True when the next tick may be simulated; counts a stall otherwise
+    bool canAdvance() {
+        if (tick + 1 <= remoteConfirmed + MaxPrediction)
+            return true;
+        stats.stalls++;
+        return false;
+    }
+
+    // The local buttons read while simulating up to tick; they apply inputDelay ticks later
+    void addLocalInput(InputState state) {
+        localLatest = tick + 1 + inputDelay;
+        inputs[localPlayer][localLatest % Ring] = state;
+    }
+
+    // Takes the next remote input; anything but the tick after the last
+    // confirmed one (a duplicate, or a gap after a lost packet) is ignored
+    // and comes again in a later packet. Returns true when it was taken.
+    bool addRemoteInput(std::uint64_t at_tick, InputState state) {
+        if (at_tick != remoteConfirmed + 1 || at_tick >= tick + Ring - MaxPrediction)
+            return false;
+        inputs[remotePlayer()][at_tick % Ring] = state;
+        remoteConfirmed = at_tick;
+        stats.remoteInputs++;
+        if (at_tick <= tick) {
+            stats.remoteLateTicks += tick - at_tick + 1;
+            if (predicted[at_tick % Ring] != state && (rollbackTick == 0 || at_tick < rollbackTick))
+                rollbackTick = at_tick;
+        }
+        return true;
+    }
+
+    // Buttons player holds during at_tick: known ones, or the remote
+    // player's last known buttons held on as a prediction
+    InputState getInput(unsigned int player, std::uint64_t at_tick) {
+        if (player == localPlayer)
+            return at_tick <= localLatest ? inputs[player][at_tick % Ring] : InputState();
+        if (at_tick <= remoteConfirmed)
+            return inputs[player][at_tick % Ring];
+        InputState guess = inputs[player][remoteConfirmed % Ring];
+        predicted[at_tick % Ring] = guess;
+        return guess;
+    }
+
+    // Marks at_tick simulated; rolling back and resimulating goes through here too
+    void setTick(std::uint64_t at_tick) {
+        tick = at_tick;
+    }
+
+    // Where the game saves (and reloads) the state after at_tick
+    std::vector<std::uint8_t>& getState(std::uint64_t at_tick) {
+        return states[at_tick % StateRing];
+    }
+
+    // Tick to resimulate from, or 0 when every simulated prediction held.
+    // Counts the rollback; the caller resimulates up to getTick().
+    std::uint64_t takeRollback() {
+        std::uint64_t from = rollbackTick;
+        rollbackTick = 0;
+        if (from == 0 || from > tick)
+            return 0;
+        std::uint64_t depth = tick - from + 1;
+        stats.rollbacks++;
+        stats.resimulatedTicks += depth;
+        stats.maxRollbackDepth = std::max(stats.maxRollbackDepth, depth);
+        return from;
+    }
+
+    bool hasRollback() const {
+        return rollbackTick != 0;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+};
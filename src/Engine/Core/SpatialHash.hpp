@@ -0,0 +1,145 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// SpatialHash Class
+// Uniform world grid hashed into a fixed bucket table. Each object is filed
+// under the cell of its top-left corner, so it sits in exactly one bucket
+// and moving it is a swap-remove plus a push. A rectangle query visits only
+// the cells the rectangle covers (widened by the largest registered object),
+// so its cost follows the area asked about, not the number of objects.
+// ─────────────────────────────────────────────
+class SpatialHash {
+public:
+    using Id = std::uint32_t;
+
+private:
+    struct Cell {
+        std::int32_t x = Unregistered, y = 0;
+
+        bool operator==(const Cell& other) const {
+            return x == other.x && y == other.y;
+        }
+    };
+
+    static constexpr std::int32_t Unregistered = std::numeric_limits<std::int32_t>::min();
+
+    float cellSize;
+    std::size_t mask;
+    std::vector<std::vector<Id>> buckets;
+    std::vector<Cell> cells;                // Anchor cell per id
+    std::vector<std::uint32_t> slots;       // Index of each id inside its bucket
+    std::vector<sf::FloatRect> bounds;
+    sf::Vector2f maxExtent;                 // Largest registered size; queries widen by this
+    std::size_t count = 0;
+
+    Cell cellAt(float x, float y) const {
+        return Cell{ static_cast<std::int32_t>(std::floor(x / cellSize)), static_cast<std::int32_t>(std::floor(y / cellSize)) };
+    }
+
+    std::vector<Id>& bucketOf(Cell cell) {
+        return buckets[hash(cell)];
+    }
+
+    std::size_t hash(Cell cell) const {
+        std::uint32_t h = static_cast<std::uint32_t>(cell.x) * 73856093u ^ static_cast<std::uint32_t>(cell.y) * 19349663u;
+        return h & mask;
+    }
+
+    void link(Id id, Cell cell) {
+        std::vector<Id>& bucket = bucketOf(cell);
+        cells[id] = cell;
+        slots[id] = static_cast<std::uint32_t>(bucket.size());
+        bucket.push_back(id);
+    }
+
+    void unlink(Id id) {
+        std::vector<Id>& bucket = bucketOf(cells[id]);
+        Id last = bucket.back();
+        bucket[slots[id]] = last;
+        slots[last] = slots[id];
+        bucket.pop_back();
+        cells[id] = Cell();
+    }
+
+public:
+    // bucket_count is rounded up to a power of two
+    explicit SpatialHash(float cell_size = 512.f, std::size_t bucket_count = 1024) : cellSize(cell_size) {
+        std::size_t size = 1;
+        while (size < bucket_count) size <<= 1;
+        buckets.resize(size);
+        mask = size - 1;
+    }
+
+    void insert(Id id, const sf::FloatRect& box) {
+        if (id >= cells.size()) {
+            cells.resize(id + 1);
+            slots.resize(id + 1);
+            bounds.resize(id + 1);
+        }
+        if (cells[id].x != Unregistered)
+            unlink(id);
+        else
+            count++;
+        bounds[id] = box;
+        maxExtent.x = std::max(maxExtent.x, box.width);
+        maxExtent.y = std::max(maxExtent.y, box.height);
+        link(id, cellAt(box.left, box.top));
+    }
+
+    // Refreshes an object's bounds, re-filing it only when it crossed into another cell
+    void update(Id id, const sf::FloatRect& box) {
+        bounds[id] = box;
+        Cell cell = cellAt(box.left, box.top);
+        if (cell == cells[id])
+            return;
+        unlink(id);
+        link(id, cell);
+    }
+
+    void remove(Id id) {
+        if (id >= cells.size() || cells[id].x == Unregistered)
+            return;
+        unlink(id);
+        count--;
+    }
+
+    bool contains(Id id) const {
+        return id < cells.size() && cells[id].x != Unregistered;
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        cells.clear();
+        slots.clear();
+        bounds.clear();
+        maxExtent = sf::Vector2f();
+        count = 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    // Appends every object whose bounds overlap the area
+    void query(const sf::FloatRect& area, std::vector<Id>& out) const {
+        Cell first = cellAt(area.left - maxExtent.x, area.top - maxExtent.y);
+        Cell last = cellAt(area.left + area.width, area.top + area.height);
+        for (std::int32_t y = first.y; y <= last.y; y++) {
+            for (std::int32_t x = first.x; x <= last.x; x++) {
+                Cell cell{ x, y };
+                // Different cells can share a bucket; the anchor check keeps each id to its own cell
+                for (Id id : buckets[hash(cell)]) {
+                    if (cells[id] == cell && bounds[id].intersects(area))
+                        out.push_back(id);
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Hash.hpp"
+#include "Log.hpp"
+
+// ─────────────────────────────────────────────
+// StateWriter / StateReader
+// Flat byte image of simulation state. Components write plain values and
+// whole arrays in a fixed order and read them back in the same order, so a
+// save is a handful of memcpys into a buffer that keeps its capacity, and a
+// restore is the same copies the other way. Only trivially copyable types
+// go in; pointers, textures and shapes stay with their owners.
+// ─────────────────────────────────────────────
+class StateWriter {
+private:
+    std::vector<std::uint8_t>& out;
+
+    void append(const void* data, std::size_t size) {
+        std::size_t at = out.size();
+        out.resize(at + size);
+        if (size > 0)
+            std::memcpy(out.data() + at, data, size);
+    }
+
+public:
+    // Appends to buffer; clear it first to start a new image
+    explicit StateWriter(std::vector<std::uint8_t>& buffer) : out(buffer) {}
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be saved");
+        append(&value, sizeof(T));
+    }
+
+    // Element count, then the elements
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be saved");
+        std::uint32_t count = static_cast<std::uint32_t>(values.size());
+        append(&count, sizeof(count));
+        append(values.data(), values.size() * sizeof(T));
+    }
+};
+
+class StateReader {
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset = 0;
+    bool ok = true;
+
+    bool take(void* target, std::size_t bytes) {
+        if (!ok || bytes > size - offset) {
+            ok = false;
+            return false;
+        }
+        if (bytes > 0)
+            std::memcpy(target, data + offset, bytes);
+        offset += bytes;
+        return true;
+    }
+
+public:
+    StateReader(const std::uint8_t* init_data, std::size_t init_size) : data(init_data), size(init_size) {}
+    explicit StateReader(const std::vector<std::uint8_t>& buffer) : StateReader(buffer.data(), buffer.size()) {}
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be restored");
+        return take(&value, sizeof(T));
+    }
+
+    // Resizes values to the saved count; keeps its capacity when that is enough
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be restored");
+        std::uint32_t count = 0;
+        if (!take(&count, sizeof(count)) || count * sizeof(T) > size - offset) {
+            ok = false;
+            return false;
+        }
+        values.resize(count);
+        return take(values.data(), count * sizeof(T));
+    }
+
+    // False once any read ran past the end of the image
+    bool good() const {
+        return ok;
+    }
+
+    bool atEnd() const {
+        return offset == size;
+    }
+};
+
+// ─────────────────────────────────────────────
+// State files
+// A state image on disk, for quick-saves: a fixed header with the tick,
+// the image size and its FNV-1a hash, then the image itself. Only loads
+// into the same game it was saved from (same level and options).
+// ─────────────────────────────────────────────
+namespace StateFile {
+    struct Header {
+        std::uint32_t magic = 0x56415351;   // "QSAV"
+        std::uint32_t version = 1;
+        std::uint64_t tick = 0;
+        std::uint64_t size = 0;
+        std::uint64_t hash = 0;
+    };
+
+    inline bool write(const std::string& path, std::uint64_t tick, const std::vector<std::uint8_t>& image) {
+        std::ofstream file(path, std::ios::binary);
+        Header header;
+        header.tick = tick;
+        header.size = image.size();
+        header.hash = Fnv1a::hash(image.data(), image.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            LOG_ERROR << "Could not write state file " << path;
+            return false;
+        }
+        return true;
+    }
+
+    // Reads the image into image and returns its tick through tick
+    inline bool read(const std::string& path, std::vector<std::uint8_t>& image, std::uint64_t& tick) {
+        std::ifstream file(path, std::ios::binary);
+        Header header, expected;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != expected.magic || header.version != expected.version) {
+            LOG_ERROR << "Not a state file: " << path;
+            return false;
+        }
+        // The size on disk is checked against what the file holds before anything is allocated for it
+        std::streamoff start = file.tellg();
+        file.seekg(0, std::ios::end);
+        std::streamoff remaining = file.tellg() - start;
+        file.seekg(start);
+        if (!file || remaining < 0 || header.size > static_cast<std::uint64_t>(remaining)) {
+            LOG_ERROR << "State file " << path << " is truncated or damaged";
+            return false;
+        }
+        image.resize(static_cast<std::size_t>(header.size));
+        if (!file.read(reinterpret_cast<char*>(image.data()), static_cast<std::streamsize>(image.size())) || Fnv1a::hash(image.data(), image.size()) != header.hash) {
+            LOG_ERROR << "State file " << path << " is truncated or damaged";
+            return false;
+        }
+        tick = header.tick;
+        return true;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include "Log.hpp"
+#include "RenderCommands.hpp"
+
+// ─────────────────────────────────────────────
+// StatsOverlay Class
+// Small text panel in the top-left corner with the average frame time, draw
+// calls and entity counts. The game ships no font, so the overlay stays
+// hidden until one is loaded. The text is rebuilt a few times per second
+// rather than every frame, which keeps the frames in between allocation free.
+// update() only formats the line; it reaches the sf::Text through the
+// command list, on the thread that draws.
+// ─────────────────────────────────────────────
+class StatsOverlay : public TextDrawable {
+public:
+    struct Sample {
+        std::size_t drawCalls = 0;
+        std::size_t entitiesVisible = 0, entitiesActive = 0, entitiesTotal = 0;
+        unsigned int chunksDrawn = 0, chunksResident = 0;
+        unsigned int renderQueueDepth = 0;  // Frames handed to the render thread and not presented yet
+        float renderLatency = 0.f;          // Milliseconds from handing a frame over to presenting it
+    };
+
+private:
+    sf::Font font;
+    sf::Text text;
+    sf::RectangleShape panel;
+    bool loaded = false;
+    sf::Time refreshInterval;
+    sf::Time accumulated;
+    unsigned int frames = 0;
+    char line[320] = {};                    // Formatted by update()
+    std::size_t lineLength = 0;
+    std::string shown;                      // What the text holds, on the drawing thread
+
+public:
+    explicit StatsOverlay(sf::Time refresh_interval = sf::seconds(0.25f)) : refreshInterval(refresh_interval) {
+        panel.setFillColor(sf::Color(0, 0, 0, 160));
+        panel.setPosition(8.f, 8.f);
+        text.setPosition(16.f, 12.f);
+        text.setCharacterSize(18);
+        text.setFillColor(sf::Color::White);
+    }
+
+    bool loadFont(const std::string& path) {
+        loaded = font.loadFromFile(path);
+        if (!loaded) {
+            LOG_ERROR << "Failed to load overlay font " << path;
+            return false;
+        }
+        text.setFont(font);
+        return true;
+    }
+
+    bool isVisible() const {
+        return loaded;
+    }
+
+    // Adds one frame; the text refreshes once refresh_interval has passed
+    void update(sf::Time frame_time, const Sample& sample) {
+        if (!loaded)
+            return;
+        accumulated += frame_time;
+        frames++;
+        if (accumulated < refreshInterval)
+            return;
+
+        int length = std::snprintf(line, sizeof(line),
+            "frame %.2f ms\ndraw calls %zu\nentities %zu drawn / %zu active / %zu\nchunks %u drawn / %u resident\n"
+            "render queue %u, +%.2f ms latency",
+            accumulated.asSeconds() * 1000.f / frames, sample.drawCalls,
+            sample.entitiesVisible, sample.entitiesActive, sample.entitiesTotal,
+            sample.chunksDrawn, sample.chunksResident, sample.renderQueueDepth, sample.renderLatency);
+        lineLength = std::min(static_cast<std::size_t>(std::max(length, 0)), sizeof(line) - 1);
+        accumulated = sf::Time::Zero;
+        frames = 0;
+    }
+
+    void record(RenderCommandList& list) {
+        if (loaded)
+            list.drawText(*this, line, lineLength);
+    }
+
+    // Lays the text out again only when the line changed
+    void setText(const char* chars, std::size_t length) override {
+        if (shown.size() == length && shown.compare(0, length, chars, length) == 0)
+            return;
+        shown.assign(chars, length);
+        text.setString(shown);
+        sf::FloatRect bounds = text.getLocalBounds();
+        panel.setSize(sf::Vector2f(bounds.left + bounds.width + 16.f, bounds.top + bounds.height + 12.f));
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        if (!loaded)
+            return;
+        target.draw(panel, states);
+        target.draw(text, states);
+    }
+};
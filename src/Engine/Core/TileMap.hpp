@@ -0,0 +1,180 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "RenderCommands.hpp"
+
+// ─────────────────────────────────────────────
+// TileMap Class
+// Batches every tile of a layer into one quad list per texture, so a whole
+// ground layer is submitted with a single draw call. Geometry is rebuilt only
+// when a tile changes; the batch lives in a static vertex buffer when the GPU
+// supports it and falls back to a plain vertex array otherwise. Recorded
+// into a render command list, the batches carry a version that changes
+// with every rebuild, so the player keeps its own static buffers the same way.
+// ─────────────────────────────────────────────
+class TileMap : public sf::Drawable, public sf::Transformable {
+public:
+    static constexpr std::uint8_t EmptyTile = 0;
+
+    struct Stats {
+        unsigned int drawCalls = 0;     // Draw calls issued by the last draw()
+        std::size_t vertexCount = 0;    // Vertices across every batch
+        unsigned int rebuilds = 0;      // Number of geometry rebuilds so far
+    };
+
+private:
+    struct Batch {
+        const sf::Texture* texture = nullptr;
+        sf::FloatRect texRect;          // Tile image inside the texture (atlas rect or whole texture)
+        sf::VertexArray vertices{ sf::Quads };
+        mutable sf::VertexBuffer buffer{ sf::Quads, sf::VertexBuffer::Static };
+        mutable bool uploaded = false;
+    };
+
+    unsigned int columns = 0;
+    unsigned int rows = 0;
+    sf::Vector2f tileSize{ 50.f, 50.f };
+    std::vector<std::uint8_t> tiles;        // Row-major texture ids, 0 = empty
+    std::vector<Batch> batches;             // One batch per registered texture
+    bool dirty = false;
+    std::uint64_t version = 0;              // Unique to every rebuild of any map
+    mutable Stats stats;
+
+public:
+    TileMap() = default;
+
+    TileMap(unsigned int init_columns, unsigned int init_rows, sf::Vector2f init_tile_size) {
+        resize(init_columns, init_rows, init_tile_size);
+    }
+
+    // Resets the grid to the given dimensions; every tile becomes empty
+    void resize(unsigned int new_columns, unsigned int new_rows, sf::Vector2f new_tile_size) {
+        columns = new_columns;
+        rows = new_rows;
+        tileSize = new_tile_size;
+        tiles.assign(static_cast<std::size_t>(columns) * rows, EmptyTile);
+        dirty = true;
+    }
+
+    // Registers a texture (or a sub-rectangle of an atlas) and returns the tile id that refers to it
+    std::uint8_t addTexture(const sf::Texture& texture, sf::IntRect rect = sf::IntRect()) {
+        if (rect == sf::IntRect())
+            rect = sf::IntRect(0, 0, texture.getSize().x, texture.getSize().y);
+        batches.emplace_back();
+        batches.back().texture = &texture;
+        batches.back().texRect = sf::FloatRect(rect);
+        return static_cast<std::uint8_t>(batches.size());
+    }
+
+    // Sizes every batch for a completely filled grid, so later rebuilds of
+    // the same dimensions never reallocate
+    void reserveBatches() {
+        for (auto& batch : batches) {
+            batch.vertices.resize(tiles.size() * 4);
+            batch.vertices.clear();
+        }
+    }
+
+    void setTile(unsigned int column, unsigned int row, std::uint8_t id) {
+        if (column >= columns || row >= rows)
+            return;
+        std::uint8_t& tile = tiles[static_cast<std::size_t>(row) * columns + column];
+        if (tile != id) {
+            tile = id;
+            dirty = true;
+        }
+    }
+
+    std::uint8_t getTile(unsigned int column, unsigned int row) const {
+        if (column >= columns || row >= rows)
+            return EmptyTile;
+        return tiles[static_cast<std::size_t>(row) * columns + column];
+    }
+
+    unsigned int getColumns() const { return columns; }
+    unsigned int getRows() const { return rows; }
+    sf::Vector2f getTileSize() const { return tileSize; }
+
+    // Rebuilds the quad batches if any tile changed since the last call
+    void rebuild() {
+        if (!dirty)
+            return;
+
+        for (auto& batch : batches) {
+            batch.vertices.clear();
+            batch.uploaded = false;
+        }
+
+        for (unsigned int row = 0; row < rows; row++) {
+            for (unsigned int column = 0; column < columns; column++) {
+                std::uint8_t id = tiles[static_cast<std::size_t>(row) * columns + column];
+                if (id == EmptyTile || id > batches.size())
+                    continue;
+
+                Batch& batch = batches[id - 1];
+                const sf::FloatRect& uv = batch.texRect;
+                float left = column * tileSize.x;
+                float top = row * tileSize.y;
+
+                batch.vertices.append(sf::Vertex({ left, top }, { uv.left, uv.top }));
+                batch.vertices.append(sf::Vertex({ left + tileSize.x, top }, { uv.left + uv.width, uv.top }));
+                batch.vertices.append(sf::Vertex({ left + tileSize.x, top + tileSize.y }, { uv.left + uv.width, uv.top + uv.height }));
+                batch.vertices.append(sf::Vertex({ left, top + tileSize.y }, { uv.left, uv.top + uv.height }));
+            }
+        }
+
+        stats.vertexCount = 0;
+        for (const auto& batch : batches)
+            stats.vertexCount += batch.vertices.getVertexCount();
+        stats.rebuilds++;
+        static std::uint64_t rebuildCount = 0;
+        version = ++rebuildCount;
+        dirty = false;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+    // Records every non-empty batch, one draw each; the vertices are copied
+    // into the list only while the player may not hold this version yet
+    void record(RenderCommandList& list, sf::RenderStates states) const {
+        states.transform *= getTransform();
+        for (const auto& batch : batches) {
+            if (batch.vertices.getVertexCount() == 0)
+                continue;
+            states.texture = batch.texture;
+            list.drawVertices(&batch.vertices[0], batch.vertices.getVertexCount(), sf::Quads, states, &batch, version);
+        }
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.transform *= getTransform();
+        stats.drawCalls = 0;
+
+        for (const auto& batch : batches) {
+            if (batch.vertices.getVertexCount() == 0)
+                continue;
+
+            states.texture = batch.texture;
+            if (sf::VertexBuffer::isAvailable()) {
+                // Upload once per rebuild; afterwards the geometry stays on the GPU
+                if (!batch.uploaded) {
+                    std::size_t count = batch.vertices.getVertexCount();
+                    if (batch.buffer.getVertexCount() != count)
+                        batch.buffer.create(count);
+                    batch.buffer.update(&batch.vertices[0]);
+                    batch.uploaded = true;
+                }
+                target.draw(batch.buffer, states);
+            }
+            else {
+                target.draw(batch.vertices, states);
+            }
+            stats.drawCalls++;
+        }
+    }
+};
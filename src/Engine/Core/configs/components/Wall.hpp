@@ -0,0 +1,42 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Wall Struct
+// A rectangular block of solid cells in the raycast level, given by its
+// four corners in cell coordinates: A top-left, B top-right, C bottom-right
+// and D bottom-left, as RectangleObj::getRectObjVector() builds them. The
+// corners are inclusive, so a wall from (2, 3) to (4, 3) is three cells long.
+// ─────────────────────────────────────────────
+struct Wall {
+    std::vector<sf::Vector2i> corners;      // A, B, C, D
+    std::uint8_t texture = 1;               // Raycaster texture id its cells are drawn with
+
+    // Top-left cell
+    sf::Vector2i getMin() const {
+        sf::Vector2i min = corners.empty() ? sf::Vector2i() : corners[0];
+        for (const auto& corner : corners) {
+            min.x = std::min(min.x, corner.x);
+            min.y = std::min(min.y, corner.y);
+        }
+        return min;
+    }
+
+    // Bottom-right cell
+    sf::Vector2i getMax() const {
+        sf::Vector2i max = corners.empty() ? sf::Vector2i() : corners[0];
+        for (const auto& corner : corners) {
+            max.x = std::max(max.x, corner.x);
+            max.y = std::max(max.y, corner.y);
+        }
+        return max;
+    }
+
+    bool contains(sf::Vector2i cell) const {
+        sf::Vector2i min = getMin(), max = getMax();
+        return !corners.empty() && cell.x >= min.x && cell.y >= min.y && cell.x <= max.x && cell.y <= max.y;
+    }
+};
@@ -1,7 +1,14 @@
 #include "Engine/Core/Engine.cpp"
+#include "Engine/Core/Engine.hpp"
 
-int main() {
-    SuperMarioGamePlay game;
+int main(int argc, char** argv) {
+    GameOptions options = GameOptions::parse(argc, argv);
+    if (options.walls) {
+        Game game(options.threads);
+        game.run();
+        return 0;
+    }
+    SuperMarioGamePlay game(options);
     game.run();
     return 0;
 }
@@ -0,0 +1,211 @@
+// Bakes the game's images and sounds into one asset pack (.pak) that the
+// engine memory-maps at startup instead of decoding PNG, WAV and OGG files.
+//
+//   bake_assets <manifest> <out.pak>
+//
+// Manifest lines, paths relative to the working directory and stored as
+// written (they are the names the game asks the resource cache for):
+//
+//   atlas  <name> <image.png | clips.dat>...   packed into one RGBA page; a clip
+//                                              file adds every frame image it names
+//   image  <file.png>                          RGBA pixels
+//   sound  <file.wav | file.ogg>               decoded to 16-bit PCM
+//   stream <file.ogg>                          kept encoded, for music
+//
+// Images with identical pixels share one atlas rect, and identical blobs
+// are written once.
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Animation.hpp"
+#include "AssetPack.hpp"
+#include "ResourceCache.hpp"
+
+namespace {
+    std::uintmax_t sourceBytes = 0;         // Every file baked, as it was on disk
+
+    void countSource(const std::string& path) {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        sourceBytes += error ? 0 : size;
+    }
+
+    AssetPack::Entry makeEntry(const std::string& name, AssetPack::Kind kind) {
+        AssetPack::Entry entry;
+        std::strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+        entry.kind = kind;
+        return entry;
+    }
+
+    std::vector<std::uint8_t> pixelsOf(const sf::Image& image) {
+        const sf::Uint8* pixels = image.getPixelsPtr();
+        return std::vector<std::uint8_t>(pixels, pixels + static_cast<std::size_t>(image.getSize().x) * image.getSize().y * 4);
+    }
+
+    bool addAtlas(AssetPack::PackData& pack, const std::string& name, const std::vector<std::string>& sources) {
+        std::vector<std::string> paths;
+        for (const auto& source : sources) {
+            if (source.size() > 4 && source.compare(source.size() - 4, 4, ".dat") == 0) {
+                AnimationLibrary clips;
+                if (!clips.load(source))
+                    return false;
+                for (const auto& image : clips.getImages()) paths.push_back(image);
+            }
+            else
+                paths.push_back(source);
+        }
+
+        // Decode everything, then pack only the first of each set of identical images
+        std::vector<sf::Image> images(paths.size());
+        std::vector<std::size_t> original(paths.size());
+        std::vector<TextureAtlas::NamedImage> unique;
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (!images[i].loadFromFile(paths[i])) {
+                std::fprintf(stderr, "Could not decode %s\n", paths[i].c_str());
+                return false;
+            }
+            countSource(paths[i]);
+            original[i] = i;
+            for (std::size_t j = 0; j < i; j++) {
+                if (paths[j] == paths[i] || (images[j].getSize() == images[i].getSize() && pixelsOf(images[j]) == pixelsOf(images[i]))) {
+                    original[i] = original[j];
+                    break;
+                }
+            }
+            if (original[i] == i)
+                unique.emplace_back(paths[i], &images[i]);
+        }
+
+        TextureAtlas atlas;
+        sf::Image page;
+        if (!atlas.pack(unique, 2048, false, &page)) {
+            std::fprintf(stderr, "Could not pack atlas %s\n", name.c_str());
+            return false;
+        }
+        std::uint32_t pageIndex = static_cast<std::uint32_t>(pack.entries.size());
+        AssetPack::Entry pageEntry = makeEntry(name, AssetPack::AtlasPage);
+        pageEntry.width = page.getSize().x;
+        pageEntry.height = page.getSize().y;
+        pack.entries.push_back(pageEntry);
+        pack.blobs.push_back(pixelsOf(page));
+
+        std::size_t aliases = 0;
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (original[i] != i && paths[original[i]] == paths[i])
+                continue;                   // Listed twice
+            aliases += original[i] != i;
+            sf::IntRect rect = atlas.getRect(paths[original[i]]);
+            AssetPack::Entry frame = makeEntry(paths[i], AssetPack::AtlasFrame);
+            frame.page = pageIndex;
+            frame.left = rect.left;
+            frame.top = rect.top;
+            frame.width = static_cast<std::uint32_t>(rect.width);
+            frame.height = static_cast<std::uint32_t>(rect.height);
+            pack.entries.push_back(frame);
+            pack.blobs.emplace_back();
+        }
+        std::printf("  atlas %s: %zu images, %zu identical to another, %ux%u page\n", name.c_str(), unique.size() + aliases, aliases,
+            page.getSize().x, page.getSize().y);
+        return true;
+    }
+
+    bool addImage(AssetPack::PackData& pack, const std::string& path) {
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            std::fprintf(stderr, "Could not decode %s\n", path.c_str());
+            return false;
+        }
+        countSource(path);
+        AssetPack::Entry entry = makeEntry(path, AssetPack::Image);
+        entry.width = image.getSize().x;
+        entry.height = image.getSize().y;
+        pack.entries.push_back(entry);
+        pack.blobs.push_back(pixelsOf(image));
+        return true;
+    }
+
+    bool addSound(AssetPack::PackData& pack, const std::string& path) {
+        sf::InputSoundFile file;
+        if (!file.openFromFile(path)) {
+            std::fprintf(stderr, "Could not decode %s\n", path.c_str());
+            return false;
+        }
+        std::vector<sf::Int16> samples(static_cast<std::size_t>(file.getSampleCount()));
+        samples.resize(static_cast<std::size_t>(file.read(samples.data(), samples.size())));
+
+        countSource(path);
+        AssetPack::Entry entry = makeEntry(path, AssetPack::Sound);
+        entry.channelCount = file.getChannelCount();
+        entry.sampleRate = file.getSampleRate();
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(samples.data());
+        pack.entries.push_back(entry);
+        pack.blobs.emplace_back(bytes, bytes + samples.size() * sizeof(sf::Int16));
+        return true;
+    }
+
+    bool addStream(AssetPack::PackData& pack, const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Could not open %s\n", path.c_str());
+            return false;
+        }
+        countSource(path);
+        pack.entries.push_back(makeEntry(path, AssetPack::Stream));
+        pack.blobs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <manifest> <out.pak>\n", argv[0]);
+        return 1;
+    }
+    std::ifstream manifest(argv[1]);
+    if (!manifest) {
+        std::fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    AssetPack::PackData pack;
+    std::string line, kind;
+    int lineNumber = 0;
+    while (std::getline(manifest, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        if (!(fields >> kind) || kind[0] == '#')
+            continue;
+
+        std::vector<std::string> paths;
+        for (std::string path; fields >> path;) paths.push_back(path);
+        bool ok = false;
+        if (kind == "atlas" && paths.size() >= 2)
+            ok = addAtlas(pack, paths[0], std::vector<std::string>(paths.begin() + 1, paths.end()));
+        else if (paths.size() == 1 && kind == "image")
+            ok = addImage(pack, paths[0]);
+        else if (paths.size() == 1 && kind == "sound")
+            ok = addSound(pack, paths[0]);
+        else if (paths.size() == 1 && kind == "stream")
+            ok = addStream(pack, paths[0]);
+        else
+            std::fprintf(stderr, "%s:%d: expected 'atlas <name> <file>...' or 'image|sound|stream <file>'\n", argv[1], lineNumber);
+        if (!ok)
+            return 1;
+    }
+
+    AssetPack::WriteStats stats;
+    if (!AssetPack::writePack(argv[2], pack, &stats))
+        return 1;
+    std::printf("%s: %zu entries, %zu blobs, %llu KiB (%llu KiB shared between entries); sources were %llu KiB encoded\n", argv[2],
+        pack.entries.size(), stats.blobs, static_cast<unsigned long long>(stats.bytes / 1024),
+        static_cast<unsigned long long>(stats.sharedBytes / 1024), static_cast<unsigned long long>(sourceBytes / 1024));
+    return 0;
+}
@@ -0,0 +1,32 @@
+// Converts the text level files into the binary chunked .lvl format the
+// engine memory-maps at startup. The text formats are described in
+// LevelSource.hpp.
+//
+//   level_convert <brick.dat> <entities.dat> <out.lvl> [chunk_columns] [parallax.dat]
+
+#include <cstdio>
+#include <cstdlib>
+#include "LevelFormat.hpp"
+#include "LevelSource.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: %s <brick.dat> <entities.dat> <out.lvl> [chunk_columns] [parallax.dat]\n", argv[0]);
+        return 1;
+    }
+    unsigned long chunkColumns = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 16;
+    if (chunkColumns == 0 || chunkColumns > 0xFFFF) {
+        std::fprintf(stderr, "chunk_columns must be between 1 and 65535\n");
+        return 1;
+    }
+
+    LevelFormat::LevelData level;
+    if (!LevelSource::read(argv[1], argv[2], argc > 5 ? argv[5] : "", static_cast<unsigned int>(chunkColumns), level))
+        return 1;
+
+    if (!LevelFormat::writeLevel(argv[3], level))
+        return 1;
+    std::printf("%s: %u columns in %lu chunks of %lu, %zu spawns, %zu kinds, %zu parallax layers\n", argv[3], level.header.columns,
+        (level.header.columns + chunkColumns - 1) / chunkColumns, chunkColumns, level.spawns.size(), level.kinds.size(), level.parallax.size());
+    return 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Netplay loopback test: runs both players as headless processes on
+# 127.0.0.1, first over a clean link and then through the artificial
+# delay/loss shim, and checks that all four runs end in the same state.
+# Each run prints its rollbacks per second and resimulation cost.
+#
+#   tools/netplay_loopback.sh [build_dir] [lag_ms, e.g. 50-150] [loss_percent] [ticks]
+#
+# Run after building Engine3D; the build directory holds the game and its assets.
+
+BUILD=${1:-build}
+LAG=${2:-50-150}
+LOSS=${3:-5}
+TICKS=${4:-2000}
+PORT1=47001
+PORT2=47002
+
+cd "$BUILD" || exit 1
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# run_pair <name> <lag> <loss>: both players at once, one log each
+run_pair() {
+    ./Engine3D --headless --ticks "$TICKS" --script assets/input/demo-run.txt \
+        --net 1 $PORT1 127.0.0.1:$PORT2 --lag "$2" --loss "$3" > "$OUT/$1-1.txt" 2>&1 &
+    P1=$!
+    ./Engine3D --headless --ticks "$TICKS" --script assets/input/demo-run-p2.txt \
+        --net 2 $PORT2 127.0.0.1:$PORT1 --lag "$2" --loss "$3" > "$OUT/$1-2.txt" 2>&1 &
+    P2=$!
+    wait $P1 $P2
+    for player in 1 2; do
+        echo "== $1, player $player"
+        grep -E "^Headless|netplay|rollbacks|state:|inputs:|packets:|checksum" "$OUT/$1-$player.txt"
+    done
+}
+
+run_pair clean 0 0
+run_pair shimmed "$LAG" "$LOSS"
+
+SUMS=$(grep -h checksum "$OUT"/*.txt | sort -u | wc -l)
+RUNS=$(grep -l checksum "$OUT"/*.txt | wc -l)
+if [ "$RUNS" -eq 4 ] && [ "$SUMS" -eq 1 ]; then
+    echo "PASS: all four runs end in the same state"
+else
+    echo "FAIL: $RUNS of 4 runs finished with $SUMS different checksums"
+    exit 1
+fi